@@ -0,0 +1,76 @@
+#include "benchmark.h"
+#include <prgrmr/generic/accounting_factory.h>
+#include <prgrmr/generic/factory.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures what accounting costs a construction, against the plain factory, with every thread constructing with the
+///  same key, which is when the counters of a key are contended.
+/// </summary>
+///
+
+using probe_constructor   = std::function<std::unique_ptr<int> ()>;
+using indexed_constructor = std::function<std::unique_ptr<int> (int)>;
+
+using accounting_factory = prgrmr::generic::accounting_key_class_factory<std::string, probe_constructor, indexed_constructor>;
+using plain_factory      = prgrmr::generic::key_class_factory<std::string, probe_constructor, indexed_constructor>;
+
+constexpr std::size_t key_count  = 64;
+constexpr std::size_t operations = 200000;
+
+int main()
+{
+    std::vector<std::string> keys;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        keys.push_back("shoes/model/" + std::to_string(i));
+    }
+
+    accounting_factory accounting;
+    plain_factory      plain;
+
+    for (const auto& key : keys)
+    {
+        accounting.register_functions(key, { []() { return std::make_unique<int>(0); }, [](int i) { return std::make_unique<int>(i); } });
+        accounting.register_instance_type<int>(key);
+
+        plain.register_functions(key, { []() { return std::make_unique<int>(0); }, [](int i) { return std::make_unique<int>(i); } });
+    }
+
+    benchmarks::report("plain construct and destroy",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(plain.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    benchmarks::report("accounting construct and destroy",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(accounting.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    for (std::size_t threads = 2; threads <= 16; threads *= 2)
+    {
+        const auto suffix = ", same key, " + std::to_string(threads) + " threads";
+
+        benchmarks::report("plain construct and destroy" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t, std::size_t)
+                           {
+                               benchmarks::keep(plain.construct<probe_constructor>(keys.front()));
+                           }));
+
+        benchmarks::report("accounting construct and destroy" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t, std::size_t)
+                           {
+                               benchmarks::keep(accounting.construct<probe_constructor>(keys.front()));
+                           }));
+    }
+
+    return 0;
+}
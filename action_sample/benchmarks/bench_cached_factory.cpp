@@ -0,0 +1,161 @@
+#include "benchmark.h"
+#include <prgrmr/generic/cached_factory.h>
+#include <prgrmr/generic/factory.h>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures the constructions that the per-thread cache of a cached factory resolves, against those that miss it and
+///  against the plain factory, with short and long keys, given as they are or hashed beforehand. Then the keys are
+///  drawn from a Zipf distribution, as the requests of a service usually are. The constructors return a static
+///  instance, hence only the lookups are measured.
+/// </summary>
+///
+
+using probe_constructor   = std::function<int* ()>;
+using indexed_constructor = std::function<int* (int)>;
+
+using cached_factory = prgrmr::generic::cached_key_class_factory<std::string, probe_constructor, indexed_constructor>;
+using plain_factory  = prgrmr::generic::key_class_factory<std::string, probe_constructor, indexed_constructor>;
+
+constexpr std::size_t operations = 1000000;
+constexpr std::size_t key_count  = 4096;
+constexpr std::size_t draw_count = 65536;
+
+int* probe()
+{
+    static int instance = 0;
+
+    return &instance;
+}
+
+void measure(const std::string& prefix,
+             std::size_t hot_count)
+{
+    // Many more keys than the cache has slots, of which only the first few are constructed with.
+    std::vector<std::string> keys;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        keys.push_back(prefix + std::to_string(i));
+    }
+
+    std::vector<prgrmr::generic::hashed_key<std::string>> hashed_keys;
+
+    for (const auto& key : keys)
+    {
+        hashed_keys.push_back(prgrmr::generic::make_hashed_key(key));
+    }
+
+    // The ranks of the keys drawn with a probability of 1 / rank^exponent, with a fixed seed.
+    const auto draw_zipf = [](double exponent)
+    {
+        std::vector<double> weights;
+
+        for (std::size_t rank = 1; rank <= key_count; ++rank)
+        {
+            weights.push_back(1.0 / std::pow(static_cast<double>(rank), exponent));
+        }
+
+        std::mt19937                            engine(42);
+        std::discrete_distribution<std::size_t> distribution(std::begin(weights), std::end(weights));
+        std::vector<std::size_t>                draws;
+
+        for (std::size_t i = 0; i < draw_count; ++i)
+        {
+            draws.push_back(distribution(engine));
+        }
+
+        return draws;
+    };
+
+    cached_factory cached;
+    plain_factory  plain;
+
+    for (const auto& key : keys)
+    {
+        cached.register_functions(key, { probe_constructor(&probe), indexed_constructor([](int) { return probe(); }) });
+        plain.register_functions(key, { probe_constructor(&probe), indexed_constructor([](int) { return probe(); }) });
+    }
+
+    const auto length = std::to_string(keys.front().size()) + " character keys";
+
+    benchmarks::report("plain construct, " + length,
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(plain.construct<probe_constructor>(keys[i % hot_count]));
+                       }));
+
+    benchmarks::report("cached construct, hit, " + length,
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(cached.construct<probe_constructor>(keys[i % hot_count]));
+                       }));
+
+    benchmarks::report("cached construct, hit, hashed, " + length,
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(cached.construct<probe_constructor>(hashed_keys[i % hot_count]));
+                       }));
+
+    // Striding over all the keys evicts the slots before they are found again.
+    benchmarks::report("plain construct, all keys, " + length,
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(plain.construct<probe_constructor>(keys[(i * 97) % keys.size()]));
+                       }));
+
+    benchmarks::report("cached construct, miss, all keys, " + length,
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(cached.construct<probe_constructor>(keys[(i * 97) % keys.size()]));
+                       }));
+
+    for (const auto exponent : { 0.8, 1.2 })
+    {
+        const auto draws  = draw_zipf(exponent);
+        const auto suffix = ", zipf " + std::to_string(exponent).substr(0, 3) + ", " + length;
+
+        benchmarks::report("plain construct" + suffix,
+                           benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                           {
+                               benchmarks::keep(plain.construct<probe_constructor>(keys[draws[i % draw_count]]));
+                           }));
+
+        const auto before = cached_factory::thread_statistics();
+
+        benchmarks::report("cached construct" + suffix,
+                           benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                           {
+                               benchmarks::keep(cached.construct<probe_constructor>(keys[draws[i % draw_count]]));
+                           }));
+
+        const auto after = cached_factory::thread_statistics();
+
+        benchmarks::report("cached construct, hashed" + suffix,
+                           benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                           {
+                               benchmarks::keep(cached.construct<probe_constructor>(hashed_keys[draws[i % draw_count]]));
+                           }));
+
+        const auto hits   = after.hits - before.hits;
+        const auto misses = after.misses - before.misses;
+
+        std::cout << "The cache resolved " << 100.0 * static_cast<double>(hits) / static_cast<double>(hits + misses)
+                  << "% of the constructions with zipf " << std::to_string(exponent).substr(0, 3) << " keys.\n";
+    }
+}
+
+int main()
+{
+    measure("s", 8);
+    measure("shoes/running/trail/waterproof/model/", 8);
+
+    return 0;
+}
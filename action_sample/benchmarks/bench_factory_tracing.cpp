@@ -0,0 +1,126 @@
+#include "benchmark.h"
+#include <prgrmr/generic/factory.h>
+#include <prgrmr/generic/trace.h>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures what tracing adds to each operation of a factory: the construction as it is built without
+///  PRGRMR_FACTORY_TRACING, against the same construction inside the trace_scope that PRGRMR_FACTORY_TRACING puts
+///  around it, and the parts of that scope on their own. The program itself is built without the tracing, hence both
+///  constructions run the same code but for the scope. The events are drained every few thousand operations, as a
+///  thread that dumps the trace would, hence the rings never fill up and drop them.
+/// </summary>
+///
+
+using probe_constructor   = std::function<int* ()>;
+using indexed_constructor = std::function<int* (int)>;
+
+using factory = prgrmr::generic::key_class_factory<std::string, probe_constructor, indexed_constructor>;
+
+constexpr std::size_t key_count      = 256;
+constexpr std::size_t operations     = 1000000;
+constexpr std::size_t drain_interval = 4096;
+constexpr std::size_t threads        = 4;
+
+int* probe()
+{
+    static int instance = 0;
+
+    return &instance;
+}
+
+int main()
+{
+    std::vector<std::string> keys;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        keys.push_back("shoes/model/" + std::to_string(i));
+    }
+
+    factory shoes;
+
+    for (const auto& key : keys)
+    {
+        shoes.register_function(key, probe_constructor(&probe));
+    }
+
+    auto& log = prgrmr::generic::trace_log::instance();
+
+    // The log drains the rings of all the threads under its lock, into a vector of the calling thread.
+    const auto drain = [&log](std::size_t i)
+    {
+        thread_local std::vector<prgrmr::generic::trace_event> events;
+
+        if (i % drain_interval == 0)
+        {
+            events.clear();
+            log.drain(events);
+        }
+    };
+
+    // What PRGRMR_TRACE_FACTORY(construct, key, signature) expands to.
+    const auto traced_construct = [&shoes](const std::string& key)
+    {
+        const prgrmr::generic::trace_scope scope(prgrmr::generic::trace_operation::construct,
+                                                 prgrmr::generic::hash_key(key),
+                                                 prgrmr::generic::signature_index_of<probe_constructor, probe_constructor, indexed_constructor>());
+
+        return shoes.construct<probe_constructor>(key);
+    };
+
+    benchmarks::report("construct",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(shoes.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    benchmarks::report("construct, traced",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           drain(i);
+                           benchmarks::keep(traced_construct(keys[i % key_count]));
+                       }));
+
+    benchmarks::report("trace_clock::now",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t)
+                       {
+                           benchmarks::keep(prgrmr::generic::trace_clock::now());
+                       }));
+
+    benchmarks::report("hash_key",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(prgrmr::generic::hash_key(keys[i % key_count]));
+                       }));
+
+    benchmarks::report("trace_log::record",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           drain(i);
+                           log.record(prgrmr::generic::trace_operation::construct, i, 0, i, i + 1);
+                       }));
+
+    // Each thread appends to a ring of its own, hence the tracing shouldn't add any contention.
+    benchmarks::report("construct, " + std::to_string(threads) + " threads",
+                       benchmarks::concurrent_nanoseconds_per_operation(threads, operations, [&](std::size_t, std::size_t i)
+                       {
+                           benchmarks::keep(shoes.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    benchmarks::report("construct, traced, " + std::to_string(threads) + " threads",
+                       benchmarks::concurrent_nanoseconds_per_operation(threads, operations, [&](std::size_t, std::size_t i)
+                       {
+                           drain(i);
+                           benchmarks::keep(traced_construct(keys[i % key_count]));
+                       }));
+
+    std::cout << log.dropped() << " events were dropped because a ring was full.\n";
+
+    return 0;
+}
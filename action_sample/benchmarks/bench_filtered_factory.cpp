@@ -0,0 +1,100 @@
+#include "benchmark.h"
+#include <prgrmr/generic/factory.h>
+#include <prgrmr/generic/filtered_factory.h>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures constructions with the filtered factory against the plain factory, for registered keys, for distinct
+///  unregistered keys that the membership filter rejects, and for a few unregistered keys that are requested again and
+///  again. The constructors return a static instance, hence only the registry is measured.
+/// </summary>
+///
+
+using probe_constructor = std::function<int* ()>;
+
+using filtered_factory = prgrmr::generic::filtered_key_class_factory<std::string, probe_constructor>;
+using plain_factory    = prgrmr::generic::key_class_factory<std::string, probe_constructor>;
+
+constexpr std::size_t key_count  = 256;
+constexpr std::size_t miss_count = 65536;
+constexpr std::size_t operations = 200000;
+
+int* probe()
+{
+    static int instance = 0;
+
+    return &instance;
+}
+
+int main()
+{
+    std::vector<std::string> keys;
+    std::vector<std::string> misses;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        keys.push_back("shoes/model/" + std::to_string(i));
+    }
+
+    for (std::size_t i = 0; i < miss_count; ++i)
+    {
+        misses.push_back("shoes/retired/" + std::to_string(i));
+    }
+
+    filtered_factory filtered;
+    plain_factory    plain;
+
+    for (const auto& key : keys)
+    {
+        filtered.register_function(key, probe_constructor(&probe));
+        plain.register_function(key, probe_constructor(&probe));
+    }
+
+    benchmarks::report("plain hit",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(plain.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    benchmarks::report("filtered hit",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(filtered.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    benchmarks::report("plain miss, distinct keys",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(plain.construct<probe_constructor>(misses[i % miss_count]));
+                       }));
+
+    benchmarks::report("filtered miss, distinct keys",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(filtered.construct<probe_constructor>(misses[i % miss_count]));
+                       }));
+
+    benchmarks::report("plain miss, 16 keys",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(plain.construct<probe_constructor>(misses[i % 16]));
+                       }));
+
+    benchmarks::report("filtered miss, 16 keys",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(filtered.construct<probe_constructor>(misses[i % 16]));
+                       }));
+
+    const auto statistics = filtered.statistics();
+
+    std::cout << "Of the misses, the filter rejected " << statistics.filter_rejections << ", the cache of misses "
+              << statistics.negative_cache_hits << ", and " << statistics.false_positives << " reached the registry.\n";
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "benchmark.h"
+#include <prgrmr/generic/memoizing_factory.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+///
+/// <summary>
+///  Measures the constructions that a memoizing factory serves from its caches, against those that it constructs,
+///  then with several threads finding cached instances at once.
+/// </summary>
+///
+
+struct product
+{
+    int    size;
+    double width;
+};
+
+using default_constructor = std::function<std::unique_ptr<product> ()>;
+using sized_constructor   = std::function<std::unique_ptr<product> (int, double)>;
+
+using memoizing_factory = prgrmr::generic::memoizing_key_class_factory<std::string, default_constructor, sized_constructor>;
+
+constexpr int         size_count = 256;
+constexpr std::size_t operations = 200000;
+
+int main()
+{
+    memoizing_factory factory(4 * size_count);
+
+    factory.register_functions("product",
+                               { []() { return std::make_unique<product>(); },
+                                 [](int size, double width) { return std::make_unique<product>(product{size, width}); } });
+
+    const std::string key = "product";
+
+    benchmarks::report("construct, cached",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(factory.construct<sized_constructor>(key, static_cast<int>(i % size_count), 1.0));
+                       }));
+
+    // Every width is new, hence every construction misses and evicts.
+    double width = 0.0;
+
+    benchmarks::report("construct, not cached",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           width += 1.0;
+                           benchmarks::keep(factory.construct<sized_constructor>(key, static_cast<int>(i % size_count), width));
+                       }));
+
+    for (std::size_t threads = 2; threads <= 16; threads *= 2)
+    {
+        benchmarks::report("construct, cached, " + std::to_string(threads) + " threads",
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t thread, std::size_t i)
+                           {
+                               benchmarks::keep(factory.construct<sized_constructor>(key, static_cast<int>((thread * 17 + i) % size_count), 1.0));
+                           }));
+    }
+
+    const auto statistics = factory.statistics();
+
+    std::cout << "hit rate " << statistics.hit_rate() << ", " << statistics.evictions << " evictions\n";
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "benchmark.h"
+#include <prgrmr/generic/factory.h>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+///
+/// <summary>
+///  Measures taking the registrations of a module into the factory of an application, by merging the module, against
+///  registering copies of its functions. The constructors capture a name, as a constructor bound to its product
+///  would, hence copying them allocates.
+/// </summary>
+///
+
+using probe_constructor   = std::function<std::size_t ()>;
+using indexed_constructor = std::function<std::size_t (int)>;
+
+using factory = prgrmr::generic::key_class_factory<std::string, probe_constructor, indexed_constructor>;
+
+constexpr std::size_t key_count  = 1024;
+constexpr std::size_t operations = 20;
+
+factory::function_types make_functions(const std::string& key)
+{
+    const auto name = "the product registered under " + key;
+
+    return { probe_constructor([name]() { return name.size(); }),
+             indexed_constructor([name](int i) { return name.size() + i; }) };
+}
+
+int main()
+{
+    std::vector<std::string>             keys;
+    std::vector<factory::function_types> functions;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        keys.push_back("shoes/model/" + std::to_string(i));
+        functions.push_back(make_functions(keys.back()));
+    }
+
+    // The cost that the three measurements share: registering the module.
+    benchmarks::report("register the module",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t)
+                       {
+                           factory module;
+
+                           for (std::size_t i = 0; i < key_count; ++i)
+                           {
+                               module.register_functions(keys[i], functions[i]);
+                           }
+
+                           benchmarks::keep(module.size());
+                       }) / key_count);
+
+    benchmarks::report("register the module, then merge it",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t)
+                       {
+                           factory module;
+                           factory application;
+
+                           for (std::size_t i = 0; i < key_count; ++i)
+                           {
+                               module.register_functions(keys[i], functions[i]);
+                           }
+
+                           application.merge(module);
+
+                           benchmarks::keep(application.size());
+                       }) / key_count);
+
+    benchmarks::report("register the module, then copy it",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t)
+                       {
+                           factory module;
+                           factory application;
+
+                           for (std::size_t i = 0; i < key_count; ++i)
+                           {
+                               module.register_functions(keys[i], functions[i]);
+                           }
+
+                           for (std::size_t i = 0; i < key_count; ++i)
+                           {
+                               application.register_functions(keys[i], functions[i]);
+                           }
+
+                           benchmarks::keep(application.size());
+                       }) / key_count);
+
+    return 0;
+}
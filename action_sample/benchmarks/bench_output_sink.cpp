@@ -0,0 +1,90 @@
+#include "benchmark.h"
+#include <prgrmr/generic/output_sink.h>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+///
+/// <summary>
+///  Measures writing the line of a shoe into the null device, through the buffered sink, against a stream that is
+///  flushed with std::endl after each line, as the shoes did with std::cout.
+/// </summary>
+///
+
+#if defined(_WIN32)
+constexpr const char* null_device = "NUL";
+#else
+constexpr const char* null_device = "/dev/null";
+#endif
+
+constexpr std::size_t operations = 200000;
+
+int open_null_device()
+{
+#if defined(_WIN32)
+    return ::_open(null_device, _O_WRONLY);
+#else
+    return ::open(null_device, O_WRONLY);
+#endif
+}
+
+int main()
+{
+    const auto descriptor = open_null_device();
+
+    prgrmr::generic::buffered_output_sink buffered(descriptor);
+
+    std::ofstream stream(null_device);
+    std::mutex    stream_mutex;
+
+    benchmarks::report("stream with std::endl",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           stream << "Inside nike::bird. a: " << i << ", b: " << static_cast<float>(i) * 1.5f << std::endl;
+                       }));
+
+    benchmarks::report("buffered sink",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           prgrmr::generic::output_line(buffered) << "Inside nike::bird. a: " << i << ", b: " << static_cast<float>(i) * 1.5f;
+                       }));
+
+    for (std::size_t threads = 2; threads <= 8; threads *= 2)
+    {
+        const auto suffix = ", " + std::to_string(threads) + " threads";
+
+        // The lines of the threads must not interleave, hence the stream is locked for each of them.
+        benchmarks::report("locked stream with std::endl" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t, std::size_t i)
+                           {
+                               std::lock_guard<std::mutex> lock(stream_mutex);
+
+                               stream << "Inside nike::bird. a: " << i << ", b: " << static_cast<float>(i) * 1.5f << std::endl;
+                           }));
+
+        benchmarks::report("buffered sink" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t, std::size_t i)
+                           {
+                               prgrmr::generic::output_line(buffered) << "Inside nike::bird. a: " << i << ", b: " << static_cast<float>(i) * 1.5f;
+                           }));
+    }
+
+    buffered.flush();
+
+#if defined(_WIN32)
+    ::_close(descriptor);
+#else
+    ::close(descriptor);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "benchmark.h"
+#include <prgrmr/generic/factory.h>
+#include <prgrmr/generic/pipeline.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures constructing and running products in the pipeline, with 1 to 4 threads per stage, against a loop that
+///  constructs and runs each product in turn on the calling thread. The products do a little arithmetic when run, so
+///  that both stages have some work.
+/// </summary>
+///
+
+class product
+{
+public:
+    product(int a, float b) : _a(a), _b(b)
+    {
+    }
+
+    void do_it()
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            _a = _a * 31 + i;
+            _b = _b * 0.5f + static_cast<float>(i);
+        }
+
+        benchmarks::keep(_a);
+        benchmarks::keep(_b);
+    }
+
+    void reset(int a, float b)
+    {
+        _a = a;
+        _b = b;
+    }
+
+private:
+    unsigned _a;
+    float    _b;
+};
+
+using product_constructor = std::function<std::unique_ptr<product> (int, float)>;
+
+using factory  = prgrmr::generic::key_class_factory<std::string, product_constructor>;
+using pipeline = prgrmr::generic::construct_execute_pipeline<factory, product_constructor>;
+
+constexpr std::size_t key_count  = 16;
+constexpr std::size_t item_count = 200000;
+
+int main()
+{
+    std::vector<std::string> keys;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        keys.push_back("shoes/model/" + std::to_string(i));
+    }
+
+    factory products;
+
+    for (const auto& key : keys)
+    {
+        products.register_function(key, product_constructor([](int a, float b) { return std::make_unique<product>(a, b); }));
+    }
+
+    benchmarks::report("construct and run in a loop",
+                       benchmarks::nanoseconds_per_operation(item_count, [&](std::size_t i)
+                       {
+                           products.construct<product_constructor>(keys[i % key_count], static_cast<int>(i), 1.0f)->do_it();
+                       }));
+
+    const auto recycle = [](std::unique_ptr<product>& executed, const std::string&, const int& a, const float& b)
+    {
+        executed->reset(a, b);
+        return true;
+    };
+
+    for (std::size_t threads = 1; threads <= 4; threads *= 2)
+    {
+        const auto suffix = ", " + std::to_string(threads) + " + " + std::to_string(threads) + " threads";
+
+        for (const bool recycled : { false, true })
+        {
+            benchmarks::report(std::string(recycled ? "pipeline, recycled" : "pipeline") + suffix,
+                               benchmarks::nanoseconds_per_operation(1, [&](std::size_t)
+                               {
+                                   pipeline run(products,
+                                                prgrmr::generic::pipeline_options{ threads, threads, 1024 },
+                                                recycled ? pipeline::recycle_type(recycle) : nullptr);
+
+                                   for (std::size_t i = 0; i < item_count; ++i)
+                                   {
+                                       run.push(keys[i % key_count], static_cast<int>(i), 1.0f);
+                                   }
+
+                                   run.wait();
+                               }) / item_count);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "benchmark.h"
+#include <prgrmr/generic/factory.h>
+#include <prgrmr/generic/replicated_factory.h>
+#include <prgrmr/generic/sharded_factory.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures constructions with the replicated factory from 1 to 32 threads at once, against the plain factory, which
+///  is only safe because no registration happens meanwhile, and against the sharded factory. The constructors return a
+///  static instance, hence only the registry is measured.
+/// </summary>
+///
+
+using probe_constructor   = std::function<int* ()>;
+using indexed_constructor = std::function<int* (int)>;
+
+using replicated_factory = prgrmr::generic::replicated_key_class_factory<std::string, probe_constructor, indexed_constructor>;
+using sharded_factory    = prgrmr::generic::sharded_key_class_factory<std::string, probe_constructor, indexed_constructor>;
+using plain_factory      = prgrmr::generic::key_class_factory<std::string, probe_constructor, indexed_constructor>;
+
+constexpr std::size_t key_count  = 256;
+constexpr std::size_t operations = 200000;
+
+int* probe()
+{
+    static int instance = 0;
+
+    return &instance;
+}
+
+int main()
+{
+    std::vector<std::string> keys;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        keys.push_back("shoes/model/" + std::to_string(i));
+    }
+
+    replicated_factory replicated;
+    sharded_factory    sharded;
+    plain_factory      plain;
+
+    for (const auto& key : keys)
+    {
+        replicated.register_functions(key, { probe_constructor(&probe), indexed_constructor([](int) { return probe(); }) });
+        sharded.register_functions(key, { probe_constructor(&probe), indexed_constructor([](int) { return probe(); }) });
+        plain.register_functions(key, { probe_constructor(&probe), indexed_constructor([](int) { return probe(); }) });
+    }
+
+    benchmarks::report("plain construct",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(plain.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    benchmarks::report("replicated construct",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(replicated.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    // The thread holds a replica of every factory, and the replica of the last one is looked up by its slot.
+    std::vector<std::unique_ptr<replicated_factory>> others;
+
+    for (std::size_t i = 0; i < 16; ++i)
+    {
+        others.push_back(std::make_unique<replicated_factory>());
+        others.back()->register_functions(keys[i], { probe_constructor(&probe), indexed_constructor([](int) { return probe(); }) });
+        others.back()->refresh();
+    }
+
+    benchmarks::report("replicated construct, 16 factories in the thread",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t)
+                       {
+                           benchmarks::keep(others.back()->construct<probe_constructor>(keys[15]));
+                       }));
+
+    // Each registration makes the next construction of every thread copy the registry.
+    benchmarks::report("replicated construct after a registration",
+                       benchmarks::nanoseconds_per_operation(operations / 100, [&](std::size_t i)
+                       {
+                           replicated.register_function(keys[i % key_count], probe_constructor(&probe));
+                           benchmarks::keep(replicated.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    for (std::size_t threads = 1; threads <= 32; threads *= 2)
+    {
+        const auto suffix = ", " + std::to_string(threads) + ((threads > 1) ? " threads" : " thread");
+
+        benchmarks::report("plain construct" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t thread, std::size_t i)
+                           {
+                               benchmarks::keep(plain.construct<probe_constructor>(keys[(thread * 31 + i) % key_count]));
+                           }));
+
+        benchmarks::report("replicated construct" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t thread, std::size_t i)
+                           {
+                               benchmarks::keep(replicated.construct<probe_constructor>(keys[(thread * 31 + i) % key_count]));
+                           }));
+
+        benchmarks::report("sharded construct" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t thread, std::size_t i)
+                           {
+                               benchmarks::keep(sharded.construct<probe_constructor>(keys[(thread * 31 + i) % key_count]));
+                           }));
+    }
+
+    return 0;
+}
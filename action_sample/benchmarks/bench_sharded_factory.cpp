@@ -0,0 +1,200 @@
+#include "benchmark.h"
+#include <prgrmr/generic/factory.h>
+#include <prgrmr/generic/sharded_factory.h>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures constructions with the sharded factory from 1 to 32 threads at once, against a factory behind a single
+///  reader-writer lock, then a mix where one operation in 8 registers or unregisters a key of the thread. The
+///  constructors return a static instance, hence only the registry is measured.
+/// </summary>
+///
+
+using probe_constructor   = std::function<int* ()>;
+using indexed_constructor = std::function<int* (int)>;
+
+using sharded_factory = prgrmr::generic::sharded_key_class_factory<std::string, probe_constructor, indexed_constructor>;
+using plain_factory   = prgrmr::generic::key_class_factory<std::string, probe_constructor, indexed_constructor>;
+
+constexpr std::size_t key_count     = 256;
+constexpr std::size_t operations    = 200000;
+constexpr std::size_t max_threads   = 32;
+constexpr std::size_t own_key_count = 8;   // The keys that each thread registers and unregisters in the mix.
+
+int* probe()
+{
+    static int instance = 0;
+
+    return &instance;
+}
+
+///
+/// <summary>
+///  The baseline, a factory whose every construction takes the same reader-writer lock.
+/// </summary>
+///
+struct locked_factory
+{
+    mutable std::shared_mutex mutex;
+    plain_factory             factory;
+
+    int* construct(const std::string& key) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+
+        return factory.construct<probe_constructor>(key);
+    }
+
+    void register_function(const std::string& key)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        factory.register_function(key, probe_constructor(&probe));
+    }
+
+    void unregister_delegate(const std::string& key)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        factory.unregister_delegate(key);
+    }
+};
+
+///
+/// <summary>
+///  Runs an operation of the mix: of 16 operations, the first registers a key of the thread, the ninth unregisters
+///  it, and the others construct.
+/// </summary>
+///
+template<class factory_t>
+void run_mixed(factory_t&                      factory,
+               const std::vector<std::string>& keys,
+               const std::vector<std::string>& own_keys,
+               std::size_t                     thread,
+               std::size_t                     i)
+{
+    const auto& own_key = own_keys[thread * own_key_count + (i / 16) % own_key_count];
+
+    switch (i % 16)
+    {
+    case 0:
+        factory.register_function(own_key);
+        break;
+
+    case 8:
+        factory.unregister_delegate(own_key);
+        break;
+
+    default:
+        benchmarks::keep(factory.construct(keys[(thread * 31 + i) % key_count]));
+        break;
+    }
+}
+
+///
+/// <summary>
+///  Adapts the sharded factory to the operations of the mix.
+/// </summary>
+///
+struct sharded_mix
+{
+    sharded_factory& factory;
+
+    int* construct(const std::string& key) const
+    {
+        return factory.construct<probe_constructor>(key);
+    }
+
+    void register_function(const std::string& key)
+    {
+        factory.register_function(key, probe_constructor(&probe));
+    }
+
+    void unregister_delegate(const std::string& key)
+    {
+        factory.unregister_delegate(key);
+    }
+};
+
+int main()
+{
+    std::vector<std::string> keys;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        keys.push_back("shoes/model/" + std::to_string(i));
+    }
+
+    std::vector<std::string> own_keys;
+
+    for (std::size_t i = 0; i < max_threads * own_key_count; ++i)
+    {
+        own_keys.push_back("shoes/custom/" + std::to_string(i));
+    }
+
+    sharded_factory sharded;
+    locked_factory  locked;
+
+    for (const auto& key : keys)
+    {
+        sharded.register_functions(key, { probe_constructor(&probe), indexed_constructor([](int) { return probe(); }) });
+        locked.factory.register_functions(key, { probe_constructor(&probe), indexed_constructor([](int) { return probe(); }) });
+    }
+
+    benchmarks::report("sharded construct",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(sharded.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    // The copy of the function that construct no longer makes.
+    benchmarks::report("sharded get_function and invoke",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(sharded.get_function<probe_constructor>(keys[i % key_count])());
+                       }));
+
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const auto suffix = ", " + std::to_string(threads) + ((threads > 1) ? " threads" : " thread");
+
+        benchmarks::report("sharded construct" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t thread, std::size_t i)
+                           {
+                               benchmarks::keep(sharded.construct<probe_constructor>(keys[(thread * 31 + i) % key_count]));
+                           }));
+
+        benchmarks::report("single lock construct" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t thread, std::size_t i)
+                           {
+                               benchmarks::keep(locked.construct(keys[(thread * 31 + i) % key_count]));
+                           }));
+    }
+
+    sharded_mix mix{sharded};
+
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const auto suffix = ", " + std::to_string(threads) + ((threads > 1) ? " threads" : " thread");
+
+        benchmarks::report("sharded mix" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t thread, std::size_t i)
+                           {
+                               run_mixed(mix, keys, own_keys, thread, i);
+                           }));
+
+        benchmarks::report("single lock mix" + suffix,
+                           benchmarks::concurrent_nanoseconds_per_operation(threads, operations / threads, [&](std::size_t thread, std::size_t i)
+                           {
+                               run_mixed(locked, keys, own_keys, thread, i);
+                           }));
+    }
+
+    return 0;
+}
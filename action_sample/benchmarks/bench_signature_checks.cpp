@@ -0,0 +1,68 @@
+#include <prgrmr/concepts/concepts.h>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+//
+// Compile-time benchmark of the signature checks of the delegates.
+//
+// Checks SIGNATURE_COUNT distinct signatures, e.g. 8, 32 or 128, with the checks of the delegates, or with the pairwise
+// checks that they replaced when PAIRWISE_SIGNATURE_CHECKS is defined. The bench_signature_checks target times the
+// compilation of each combination:
+//
+//    cmake --build <build directory> --target bench_signature_checks
+//
+#if !defined(SIGNATURE_COUNT)
+#define SIGNATURE_COUNT 8
+#endif
+
+using namespace prgrmr::concepts;
+
+template<std::size_t index_t>
+struct signature_argument
+{
+};
+
+#if defined(PAIRWISE_SIGNATURE_CHECKS)
+
+template<typename... Functions>
+inline constexpr bool pairwise_all_different = true;
+
+template<typename Head, typename... Tail>
+inline constexpr bool pairwise_all_different<Head, Tail...> = (!std::is_same_v<Head, Tail> && ...)
+                                                           && pairwise_all_different<Tail...>;
+
+template<typename... Functions>
+inline constexpr bool pairwise_all_same_return_type = true;
+
+template<typename Head, typename... Tail>
+inline constexpr bool pairwise_all_same_return_type<Head, Tail...> = (invocable::are_same_return_type<Head, Tail> && ...)
+                                                                  && pairwise_all_same_return_type<Tail...>;
+
+template<typename... Functions>
+inline constexpr bool signatures_check = pairwise_all_different<Functions...>
+                                      && pairwise_all_same_return_type<Functions...>
+                                      && invocable::are_all_invocable<Functions...>;
+
+#else
+
+template<typename... Functions>
+inline constexpr bool signatures_check = invocable::are_all_different<Functions...>
+                                      && invocable::are_all_same_return_type<Functions...>
+                                      && invocable::are_all_invocable<Functions...>;
+
+#endif
+
+template<std::size_t... index_t>
+constexpr bool check_signatures(std::index_sequence<index_t...>)
+{
+    return signatures_check<std::function<int (signature_argument<index_t>)>...>;
+}
+
+static_assert(check_signatures(std::make_index_sequence<SIGNATURE_COUNT>{}), "The signatures are valid.");
+
+int main()
+{
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "benchmark.h"
+#include <prgrmr/generic/factory.h>
+#include <prgrmr/generic/snapshot.h>
+#include <prgrmr/generic/thread_pool.h>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures rebuilding a million products of 16 keys from a snapshot, against constructing them again one key lookup
+///  at a time, as a restart would without a snapshot. The products are small, hence their allocation is measured along
+///  with the rest.
+/// </summary>
+///
+
+struct product
+{
+    int   a;
+    float b;
+};
+
+using product_constructor = std::function<std::unique_ptr<product> (int, float)>;
+
+using factory         = prgrmr::generic::key_class_factory<std::string, product_constructor>;
+using snapshot_writer = prgrmr::generic::snapshot_writer<std::string, product_constructor>;
+using snapshot_view   = prgrmr::generic::snapshot_view<std::string, product_constructor>;
+
+constexpr std::size_t key_count = 16;
+constexpr std::size_t row_count = 1 << 20;
+
+int main()
+{
+    std::vector<std::string> keys;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        keys.push_back("shoes/model/" + std::to_string(i));
+    }
+
+    factory products;
+
+    for (const auto& key : keys)
+    {
+        products.register_function(key, product_constructor([](int a, float b) { return std::make_unique<product>(product{ a, b }); }));
+    }
+
+    const auto path = (std::filesystem::temp_directory_path() / "bench_snapshot.snap").string();
+
+    benchmarks::report("construct each row",
+                       benchmarks::nanoseconds_per_operation(1, [&](std::size_t)
+                       {
+                           std::vector<std::unique_ptr<product>> restored(row_count);
+
+                           for (std::size_t row = 0; row < row_count; ++row)
+                           {
+                               restored[row] = products.construct<product_constructor>(keys[row % key_count], static_cast<int>(row), 1.0f);
+                           }
+
+                           benchmarks::keep(restored.back());
+                       }) / row_count);
+
+    benchmarks::report("record each row, then write the snapshot",
+                       benchmarks::nanoseconds_per_operation(1, [&](std::size_t)
+                       {
+                           snapshot_writer writer;
+
+                           for (std::size_t row = 0; row < row_count; ++row)
+                           {
+                               writer.record(keys[row % key_count], static_cast<int>(row), 1.0f);
+                           }
+
+                           benchmarks::keep(writer.write(path));
+                       }) / row_count);
+
+    benchmarks::report("open and restore the snapshot",
+                       benchmarks::nanoseconds_per_operation(1, [&](std::size_t)
+                       {
+                           snapshot_view snapshot;
+
+                           snapshot.open(path);
+                           benchmarks::keep(snapshot.restore(products).back());
+                       }) / row_count);
+
+    for (std::size_t threads = 2; threads <= 4; threads *= 2)
+    {
+        prgrmr::generic::thread_pool pool(threads);
+
+        benchmarks::report("open and restore the snapshot, pool of " + std::to_string(threads),
+                           benchmarks::nanoseconds_per_operation(1, [&](std::size_t)
+                           {
+                               snapshot_view snapshot;
+
+                               snapshot.open(path);
+                               benchmarks::keep(snapshot.restore(products, pool).back());
+                           }) / row_count);
+    }
+
+    std::remove(path.c_str());
+
+    return 0;
+}
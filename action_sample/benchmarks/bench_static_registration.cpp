@@ -0,0 +1,140 @@
+#include "benchmark.h"
+#include <prgrmr/generic/factory.h>
+#include <prgrmr/generic/static_registration.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures the time from an empty factory to its first construction, which is what the registrations add to the
+///  start of a program: the static registrations that the linker collects, loaded in a single pass, against the
+///  registrations that configure_application made one signature at a time before, and against one registration of both
+///  signatures per key. Each round builds a factory of 256 keys, then constructs with the key in the middle; the factory
+///  is destroyed once the clock is stopped.
+/// </summary>
+///
+
+struct product
+{
+    int   a;
+    float b;
+};
+
+using base_constructor     = std::function<std::unique_ptr<product> ()>;
+using numerics_constructor = std::function<std::unique_ptr<product> (int, float)>;
+
+using product_factory = prgrmr::generic::key_class_factory<std::string, base_constructor, numerics_constructor>;
+
+constexpr std::size_t key_count = 256;
+constexpr std::size_t rounds    = 200;
+
+std::unique_ptr<product> make_product()
+{
+    return std::make_unique<product>(product{ 0, 0.0f });
+}
+
+std::unique_ptr<product> make_product_with_numerics(int a, float b)
+{
+    return std::make_unique<product>(product{ a, b });
+}
+
+// The keys "shoes/model/00" to "shoes/model/ff", each in a record of its own, as the source files of 256 products would.
+#define BENCH_REGISTER_PRODUCT(high, low) \
+    PRGRMR_STATIC_REGISTRATION(product_factory, product_##high##low, "shoes/model/" #high #low, &make_product, &make_product_with_numerics);
+
+#define BENCH_REGISTER_PRODUCTS(high) \
+    BENCH_REGISTER_PRODUCT(high, 0) BENCH_REGISTER_PRODUCT(high, 1) BENCH_REGISTER_PRODUCT(high, 2) BENCH_REGISTER_PRODUCT(high, 3) \
+    BENCH_REGISTER_PRODUCT(high, 4) BENCH_REGISTER_PRODUCT(high, 5) BENCH_REGISTER_PRODUCT(high, 6) BENCH_REGISTER_PRODUCT(high, 7) \
+    BENCH_REGISTER_PRODUCT(high, 8) BENCH_REGISTER_PRODUCT(high, 9) BENCH_REGISTER_PRODUCT(high, a) BENCH_REGISTER_PRODUCT(high, b) \
+    BENCH_REGISTER_PRODUCT(high, c) BENCH_REGISTER_PRODUCT(high, d) BENCH_REGISTER_PRODUCT(high, e) BENCH_REGISTER_PRODUCT(high, f)
+
+BENCH_REGISTER_PRODUCTS(0) BENCH_REGISTER_PRODUCTS(1) BENCH_REGISTER_PRODUCTS(2) BENCH_REGISTER_PRODUCTS(3)
+BENCH_REGISTER_PRODUCTS(4) BENCH_REGISTER_PRODUCTS(5) BENCH_REGISTER_PRODUCTS(6) BENCH_REGISTER_PRODUCTS(7)
+BENCH_REGISTER_PRODUCTS(8) BENCH_REGISTER_PRODUCTS(9) BENCH_REGISTER_PRODUCTS(a) BENCH_REGISTER_PRODUCTS(b)
+BENCH_REGISTER_PRODUCTS(c) BENCH_REGISTER_PRODUCTS(d) BENCH_REGISTER_PRODUCTS(e) BENCH_REGISTER_PRODUCTS(f)
+
+///
+/// <summary>
+///  Measures the best time, over the rounds, to configure a new factory and construct with the given key.
+/// </summary>
+///
+template<class configure_t>
+double nanoseconds_to_first_construct(const std::string& key,
+                                      configure_t&& configure)
+{
+    auto best = std::numeric_limits<double>::max();
+
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        auto factory = std::make_unique<product_factory>();
+
+        const auto start = std::chrono::steady_clock::now();
+
+        configure(*factory);
+        benchmarks::keep(factory->construct<base_constructor>(key));
+
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        best = std::min(best, elapsed.count());
+    }
+
+    return best;
+}
+
+int main()
+{
+    std::vector<std::string> keys;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        char key[16];
+
+        std::snprintf(key, sizeof(key), "shoes/model/%02zx", i);
+        keys.emplace_back(key);
+    }
+
+    const auto& first = keys[key_count / 2];
+
+    {
+        product_factory loaded;
+
+        std::cout << "The linker collected " << prgrmr::generic::load_static_registrations(loaded)
+                  << " static registrations.\n";
+    }
+
+    benchmarks::report("load_static_registrations, " + std::to_string(key_count) + " keys",
+                       nanoseconds_to_first_construct(first, [](product_factory& factory)
+                       {
+                           prgrmr::generic::load_static_registrations(factory);
+                       }));
+
+    // As configure_application registered the shoes before the static registrations.
+    benchmarks::report("register_function per signature, " + std::to_string(key_count) + " keys",
+                       nanoseconds_to_first_construct(first, [&keys](product_factory& factory)
+                       {
+                           for (const auto& key : keys)
+                           {
+                               factory.register_function<base_constructor>(key, [] { return make_product(); });
+                               factory.register_function<numerics_constructor>(key, [](int a, float b) { return make_product_with_numerics(a, b); });
+                           }
+                       }));
+
+    benchmarks::report("register_functions per key, " + std::to_string(key_count) + " keys",
+                       nanoseconds_to_first_construct(first, [&keys](product_factory& factory)
+                       {
+                           for (const auto& key : keys)
+                           {
+                               factory.register_functions(key, { base_constructor(&make_product), numerics_constructor(&make_product_with_numerics) });
+                           }
+                       }));
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "benchmark.h"
+#include <prgrmr/generic/factory.h>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures the construction that returns its errors, against the construction that returns nullptr, which doesn't
+///  tell why, and against invoking the function of the signature, which throws std::bad_function_call when it is
+///  missing. The constructors return a static instance, hence only the registry and the error handling are measured.
+/// </summary>
+///
+
+using probe_constructor   = std::function<int* ()>;
+using indexed_constructor = std::function<int* (int)>;
+
+using factory = prgrmr::generic::key_class_factory<std::string, probe_constructor, indexed_constructor>;
+
+constexpr std::size_t key_count  = 256;
+constexpr std::size_t operations = 200000;
+
+int* probe()
+{
+    static int instance = 0;
+
+    return &instance;
+}
+
+int main()
+{
+    std::vector<std::string> keys;
+    std::vector<std::string> misses;
+
+    for (std::size_t i = 0; i < key_count; ++i)
+    {
+        keys.push_back("shoes/model/" + std::to_string(i));
+        misses.push_back("shoes/retired/" + std::to_string(i));
+    }
+
+    // Only the probe signature is registered, hence constructing with the indexed one fails.
+    factory shoes;
+
+    for (const auto& key : keys)
+    {
+        shoes.register_function(key, probe_constructor(&probe));
+    }
+
+    benchmarks::report("construct, hit",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(shoes.construct<probe_constructor>(keys[i % key_count]));
+                       }));
+
+    benchmarks::report("try_construct, hit",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(shoes.try_construct<probe_constructor>(keys[i % key_count]).has_value());
+                       }));
+
+    benchmarks::report("construct, missing key",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(shoes.construct<probe_constructor>(misses[i % key_count]));
+                       }));
+
+    benchmarks::report("try_construct, missing key",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(shoes.try_construct<probe_constructor>(misses[i % key_count]).has_value());
+                       }));
+
+    benchmarks::report("construct, missing signature",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(shoes.construct<indexed_constructor>(keys[i % key_count], 1));
+                       }));
+
+    benchmarks::report("get_function, invoke and catch, missing signature",
+                       benchmarks::nanoseconds_per_operation(operations / 10, [&](std::size_t i)
+                       {
+                           try
+                           {
+                               benchmarks::keep(shoes.get_function<indexed_constructor>(keys[i % key_count])(1));
+                           }
+                           catch (const std::bad_function_call&)
+                           {
+                               benchmarks::keep(i);
+                           }
+                       }));
+
+    benchmarks::report("try_construct, missing signature",
+                       benchmarks::nanoseconds_per_operation(operations, [&](std::size_t i)
+                       {
+                           benchmarks::keep(shoes.try_construct<indexed_constructor>(keys[i % key_count], 1).has_value());
+                       }));
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include "benchmark.h"
+#include "nike/bird.h"
+#include "nike/jordan.h"
+#include "nike/lebron.h"
+#include "nike/madison.h"
+#include "nike/runner.h"
+#include "nike/shoe.h"
+#include "nike/shoe_output.h"
+#include "nike/shoe_registration.h"
+#include <prgrmr/generic/output_sink.h>
+#include <prgrmr/generic/thread_pool.h>
+#include <prgrmr/generic/type_sorted_executor.h>
+#include <prgrmr/generic/type_tag.h>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+///
+/// <summary>
+///  Measures running a virtual method over a collection of objects of 8 types in random order, in that order, against
+///  the type-sorted executor, which pays for a counting sort and then calls the same target many times in a row. Then
+///  the same over the 5 nike shoes, whose output is discarded. The mispredicted branches are counted along with the
+///  times, where the hardware counter is available.
+/// </summary>
+///
+
+constexpr std::size_t object_count = 100000;
+constexpr std::size_t passes       = 20;
+
+class item
+{
+public:
+    explicit item(prgrmr::generic::type_tag tag) : _type_tag(tag)
+    {
+    }
+
+    virtual ~item() = default;
+
+    virtual void run() = 0;
+
+    prgrmr::generic::type_tag type_tag() const noexcept
+    {
+        return _type_tag;
+    }
+
+private:
+    prgrmr::generic::type_tag _type_tag;
+};
+
+template<unsigned kind_t>
+class kind final : public item
+{
+public:
+    kind() : item(prgrmr::generic::type_tag_of<kind>())
+    {
+    }
+
+    void run() override
+    {
+        _value = _value * (kind_t + 3) + kind_t;
+    }
+
+private:
+    unsigned _value = kind_t;
+};
+
+std::unique_ptr<item> make_item(unsigned kind_index)
+{
+    switch (kind_index)
+    {
+    case 0:  return std::make_unique<kind<0>>();
+    case 1:  return std::make_unique<kind<1>>();
+    case 2:  return std::make_unique<kind<2>>();
+    case 3:  return std::make_unique<kind<3>>();
+    case 4:  return std::make_unique<kind<4>>();
+    case 5:  return std::make_unique<kind<5>>();
+    case 6:  return std::make_unique<kind<6>>();
+    default: return std::make_unique<kind<7>>();
+    }
+}
+
+///
+/// <summary>
+///  Measures the loop and the executor over a collection, with the names of the measures starting with the given prefix.
+/// </summary>
+///
+template<class object_t, class action_t>
+void measure(const std::string& prefix,
+             const std::vector<std::unique_ptr<object_t>>& objects,
+             action_t action)
+{
+    prgrmr::generic::type_sorted_executor<object_t> executor;
+
+    const auto per_object = [&objects](std::optional<double> misses)
+    {
+        return misses.has_value()
+               ? std::optional<double>(*misses / static_cast<double>(objects.size()))
+               : std::nullopt;
+    };
+
+    const auto loop = [&](std::size_t)
+    {
+        for (const auto& object : objects)
+        {
+            action(*object);
+        }
+    };
+
+    const auto sorted = [&](std::size_t)
+    {
+        executor.execute(objects, action);
+    };
+
+    benchmarks::report(prefix + "unsorted loop",
+                       benchmarks::nanoseconds_per_operation(passes, loop) / static_cast<double>(objects.size()));
+
+    benchmarks::report_branch_misses(prefix + "unsorted loop",
+                                     per_object(benchmarks::branch_misses_per_operation(passes, loop)));
+
+    benchmarks::report(prefix + "type-sorted execute",
+                       benchmarks::nanoseconds_per_operation(passes, sorted) / static_cast<double>(objects.size()));
+
+    benchmarks::report_branch_misses(prefix + "type-sorted execute",
+                                     per_object(benchmarks::branch_misses_per_operation(passes, sorted)));
+
+    for (std::size_t threads = 1; threads <= 4; threads *= 2)
+    {
+        prgrmr::generic::thread_pool pool(threads);
+
+        benchmarks::report(prefix + "type-sorted execute, pool of " + std::to_string(threads),
+                           benchmarks::nanoseconds_per_operation(passes, [&](std::size_t)
+                           {
+                               executor.execute(objects, action, pool);
+                           }) / static_cast<double>(objects.size()));
+    }
+}
+
+std::unique_ptr<nike::shoe> make_shoe(unsigned shoe_index)
+{
+    // With zeros, which the shoes keep on multiplying, hence running them over and over doesn't overflow.
+    switch (shoe_index)
+    {
+    case 0:  return nike::make_shoe<nike::bird>(0, 0.0f);
+    case 1:  return nike::make_shoe<nike::jordan>(0, 0.0f);
+    case 2:  return nike::make_shoe<nike::lebron>(0, 0.0f);
+    case 3:  return nike::make_shoe<nike::madison>(0, 0.0f);
+    default: return nike::make_shoe<nike::runner>(0, 0.0f);
+    }
+}
+
+int main()
+{
+    std::mt19937                       random(42);
+    std::vector<std::unique_ptr<item>> items;
+
+    for (std::size_t i = 0; i < object_count; ++i)
+    {
+        items.push_back(make_item(random() % 8));
+    }
+
+    measure("", items, [](item& object) { object.run(); });
+
+    std::vector<std::unique_ptr<nike::shoe>> shoes;
+
+    for (std::size_t i = 0; i < object_count; ++i)
+    {
+        shoes.push_back(make_shoe(random() % 5));
+    }
+
+    prgrmr::generic::null_output_sink discard;
+
+    nike::set_output(discard);
+
+    measure("shoes, ", shoes, [](nike::shoe& shoe) { shoe.do_it(); });
+
+    nike::reset_output();
+
+    if (!benchmarks::branch_misses_per_operation(1, [](std::size_t) {}).has_value())
+    {
+        std::cout << "The branch misses are n/a, since perf_event_open has no hardware counter here.\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace benchmarks
+{
+///
+/// <summary>
+///   Keeps the compiler from optimizing away the computation of a value that is otherwise unused.
+/// </summary>
+///
+template<class value_t>
+void keep(const value_t& value)
+{
+#if defined(_MSC_VER)
+   static const void* volatile sink;
+
+   sink = std::addressof(value);
+   _ReadWriteBarrier();
+#else
+   asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+///
+/// <summary>
+///   Measures the time that an operation takes, as the best of a few rounds, which discards the rounds that the
+///   scheduler or a cold cache slowed down.
+/// </summary>
+///
+/// <param name="operations">The number of times the operation runs in a round.</param>
+/// <param name="operation">The operation, which is invoked with the index of the run within the round.</param>
+/// <param name="rounds">The number of rounds.</param>
+///
+/// <returns>The number of nanoseconds per operation.</returns>
+///
+template<class operation_t>
+double nanoseconds_per_operation(std::size_t operations,
+                                 operation_t&& operation,
+                                 std::size_t rounds = 5)
+{
+   auto best = std::numeric_limits<double>::max();
+
+   for (std::size_t round = 0; round < rounds; ++round)
+   {
+      const auto start = std::chrono::steady_clock::now();
+
+      for (std::size_t i = 0; i < operations; ++i)
+      {
+         operation(i);
+      }
+
+      const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+      best = std::min(best, elapsed.count() / static_cast<double>(operations));
+   }
+
+   return best;
+}
+
+///
+/// <summary>
+///   Measures the time that an operation takes while several threads run it at once, as the best of a few rounds.
+/// </summary>
+///
+/// <param name="threads">The number of threads.</param>
+/// <param name="operations">The number of times each thread runs the operation in a round.</param>
+/// <param name="operation">The operation, which is invoked with the index of the thread and of the run.</param>
+/// <param name="rounds">The number of rounds.</param>
+///
+/// <returns>The elapsed nanoseconds divided by the number of operations of all the threads, which decreases as long
+/// as the threads scale.</returns>
+///
+template<class operation_t>
+double concurrent_nanoseconds_per_operation(std::size_t threads,
+                                            std::size_t operations,
+                                            operation_t&& operation,
+                                            std::size_t rounds = 5)
+{
+   auto best = std::numeric_limits<double>::max();
+
+   for (std::size_t round = 0; round < rounds; ++round)
+   {
+      std::vector<std::thread> workers;
+
+      const auto start = std::chrono::steady_clock::now();
+
+      for (std::size_t thread = 0; thread < threads; ++thread)
+      {
+         workers.emplace_back([&operation, thread, operations]()
+                              {
+                                 for (std::size_t i = 0; i < operations; ++i)
+                                 {
+                                    operation(thread, i);
+                                 }
+                              });
+      }
+
+      for (auto& worker : workers)
+      {
+         worker.join();
+      }
+
+      const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+      best = std::min(best, elapsed.count() / static_cast<double>(threads * operations));
+   }
+
+   return best;
+}
+
+///
+/// <summary>
+///   Counts the branches that the calling thread mispredicts while it runs an operation, with the hardware counter
+///   that perf_event_open exposes on Linux.
+/// </summary>
+///
+/// <param name="operations">The number of times the operation runs.</param>
+/// <param name="operation">The operation, which is invoked with the index of the run.</param>
+///
+/// <returns>The number of mispredicted branches per operation, or nothing when there is no counter: on other systems,
+/// in most virtual machines, or when perf_event_paranoid forbids it.</returns>
+///
+template<class operation_t>
+std::optional<double> branch_misses_per_operation(std::size_t operations,
+                                                  operation_t&& operation)
+{
+#if defined(__linux__)
+   perf_event_attr attributes{};
+
+   attributes.size           = sizeof(attributes);
+   attributes.type           = PERF_TYPE_HARDWARE;
+   attributes.config         = PERF_COUNT_HW_BRANCH_MISSES;
+   attributes.disabled       = 1;
+   attributes.exclude_kernel = 1;
+   attributes.exclude_hv     = 1;
+
+   const auto descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+
+   if (descriptor < 0)
+   {
+      return std::nullopt;
+   }
+
+   ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+   ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+
+   for (std::size_t i = 0; i < operations; ++i)
+   {
+      operation(i);
+   }
+
+   ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+
+   std::uint64_t misses = 0;
+
+   const auto counted = read(descriptor, &misses, sizeof(misses)) == static_cast<ssize_t>(sizeof(misses));
+
+   close(descriptor);
+
+   return counted
+          ? std::optional<double>(static_cast<double>(misses) / static_cast<double>(operations))
+          : std::nullopt;
+#else
+   static_cast<void>(operations);
+   static_cast<void>(operation);
+
+   return std::nullopt;
+#endif
+}
+
+///
+/// <summary>
+///   Writes the result of a measurement as a line of the report.
+/// </summary>
+///
+inline void report(std::string_view name,
+                   double nanoseconds)
+{
+   std::cout << std::left << std::setw(56) << name
+             << std::right << std::fixed << std::setprecision(1) << std::setw(10) << nanoseconds << " ns/op\n";
+}
+
+///
+/// <summary>
+///   Writes a count of mispredicted branches as a line of the report, or n/a when there was no counter.
+/// </summary>
+///
+inline void report_branch_misses(std::string_view name,
+                                 std::optional<double> misses)
+{
+   std::cout << std::left << std::setw(56) << name << std::right << std::setw(10);
+
+   if (misses.has_value())
+   {
+      std::cout << std::fixed << std::setprecision(3) << *misses;
+   }
+   else
+   {
+      std::cout << "n/a";
+   }
+
+   std::cout << " branch misses/op\n";
+}
+}
@@ -0,0 +1,48 @@
+# Times the compilation of bench_signature_checks.cpp with 8, 32 and 128 signatures, with the checks of the delegates
+# and with the pairwise checks that they replaced. Each combination is compiled a few times, the best time is reported.
+#
+# Expects COMPILER, COMPILER_ID, SOURCE and INCLUDE_DIR, as the bench_signature_checks target passes them.
+
+if(COMPILER_ID STREQUAL "MSVC")
+  set(flags /nologo /std:c++20 /Zs /I${INCLUDE_DIR})
+  set(define_flag /D)
+else()
+  set(flags -std=c++20 -fsyntax-only -I${INCLUDE_DIR})
+  set(define_flag -D)
+endif()
+
+set(rounds 5)
+
+foreach(count 8 32 128)
+  foreach(variant delegate pairwise)
+    set(defines ${define_flag}SIGNATURE_COUNT=${count})
+
+    if(variant STREQUAL "pairwise")
+      list(APPEND defines ${define_flag}PAIRWISE_SIGNATURE_CHECKS)
+    endif()
+
+    set(best "")
+
+    foreach(round RANGE 1 ${rounds})
+      string(TIMESTAMP start "%s%f" UTC)
+
+      execute_process(COMMAND ${COMPILER} ${flags} ${defines} ${SOURCE}
+                      RESULT_VARIABLE result
+                      OUTPUT_QUIET)
+
+      string(TIMESTAMP stop "%s%f" UTC)
+
+      if(NOT result EQUAL 0)
+        message(FATAL_ERROR "The ${variant} checks of ${count} signatures don't compile.")
+      endif()
+
+      math(EXPR elapsed "(${stop} - ${start}) / 1000")
+
+      if(best STREQUAL "" OR elapsed LESS best)
+        set(best ${elapsed})
+      endif()
+    endforeach()
+
+    message("${variant} checks, ${count} signatures: ${best} ms")
+  endforeach()
+endforeach()
@@ -1,5 +1,8 @@
 #include <prgrmr/concepts/concepts.h>
 #include <prgrmr/generic/factory.h>
+#include <cstddef>
+#include <functional>
+#include <utility>
 
 using namespace prgrmr;
 using namespace prgrmr::generic;
@@ -19,19 +22,48 @@ using Z = std::function<float (float)>;
 template<typename ... functions_t>
 int do_it()
 {
-    //static_assert(concepts::arguments::IsNotEmpty<functions_t...>,           "The list of functions cannot be empty.");
-    //static_assert(concepts::invocable::AreAllInvocable<functions_t...>, "At least one of the functions is not invocable.");
-    //static_assert(concepts::invocable::AreAllDifferent<functions_t...>,      "At least two invocable functions have the same signature.");
-    //static_assert(concepts::invocable::AreAllSameReturnType<functions_t...>, "At least one of the invocable functions doesn't produce the same return type.");
-
-    static_assert(concepts::arguments::is_not_empty<functions_t...>,             "The list of functions cannot be empty.");
-    static_assert(concepts::invocable::are_all_invocable<functions_t>,        "At least one of the functions is not invocable.");
-    //static_assert(concepts::invocable::are_all_different<functions_t...>,        "At least two invocable functions have the same signature.");
-    static_assert(concepts::invocable::are_all_same_return_type<functions_t...>, "At least one of the invocable functions doesn't produce the same return type.");
+    static_assert(concepts::arguments::IsNotEmpty<functions_t...>,           "The list of functions cannot be empty.");
+    static_assert(concepts::invocable::AreAllInvocable<functions_t...>,      "At least one of the functions is not invocable.");
+    static_assert(concepts::invocable::AreAllDifferent<functions_t...>,      "At least two invocable functions have the same signature.");
+    static_assert(concepts::invocable::AreAllSameReturnType<functions_t...>, "At least one of the invocable functions doesn't produce the same return type.");
 
     return 0;
 }
 
+static_assert( concepts::invocable::are_all_different<A, B, C, X, Y, Z>);
+static_assert(!concepts::invocable::are_all_different<A, B, C, B>);
+static_assert( concepts::invocable::are_all_same_return_type<A, B, C>);
+static_assert(!concepts::invocable::are_all_same_return_type<A, B, Z>);
+
+//
+// Compile-time benchmark of the delegate checks.
+//
+// Instantiates a delegate with DELEGATE_SIGNATURE_COUNT distinct signatures, e.g. 8, 32 or 128, and reports the time
+// that the compiler spends on it:
+//
+//    cl /std:c++20 /I. /c /Bt+ /DDELEGATE_SIGNATURE_COUNT=128 delegate_static_assertions.cpp
+//    g++ -std=c++20 -I. -c -ftime-report -DDELEGATE_SIGNATURE_COUNT=128 delegate_static_assertions.cpp
+//
+#if !defined(DELEGATE_SIGNATURE_COUNT)
+#define DELEGATE_SIGNATURE_COUNT 8
+#endif
+
+template<std::size_t index_t>
+struct signature_argument
+{
+};
+
+template<class indices_t>
+struct many_signatures_delegate;
+
+template<std::size_t... index_t>
+struct many_signatures_delegate<std::index_sequence<index_t...>>
+{
+    using type = delegate_functions<std::function<int (signature_argument<index_t>)>...>;
+};
+
+using benchmark_delegate_t = many_signatures_delegate<std::make_index_sequence<DELEGATE_SIGNATURE_COUNT>>::type;
+
 int main()
 {
     //delegate_t delegate;
@@ -40,6 +72,9 @@ int main()
     //do_it<>();
     do_it<A,B>();
     //do_it<A, B, A>();
+    //do_it<A, B, Z>();
+
+    benchmark_delegate_t benchmark_delegate;
 
     return 0;
 }
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "shoe.h"
+#include <prgrmr/generic/arena.h>
+#include <prgrmr/generic/factory.h>
+#include <functional>
+#include <memory_resource>
+#include <string>
+
+namespace nike
+{
+using arena_shoe = prgrmr::generic::arena_ptr<shoe>;
+
+using arena_base_constructor     = std::function<arena_shoe (std::pmr::memory_resource*)>;
+using arena_numerics_constructor = std::function<arena_shoe (std::pmr::memory_resource*, int, float)>;
+
+///
+/// <summary>
+///   The factory of shoes constructed in a request-scoped arena, which is passed to each constructor.
+/// </summary>
+///
+/// <remarks>The shoes must be destroyed before the arena is released, which then frees all of their memory at once.</remarks>
+///
+using arena_shoe_factory =
+      prgrmr::generic::key_class_factory<std::string,
+                                         arena_base_constructor,
+                                         arena_numerics_constructor>;
+}
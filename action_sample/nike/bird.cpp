@@ -0,0 +1,4 @@
+#include "bird.h"
+#include "shoe_registration.h"
+
+NIKE_REGISTER_SHOE(nike::bird, bird_registration, "bird");
@@ -1,25 +1,28 @@
 #pragma once
 
 #include "shoe.h"
+#include "shoe_output.h"
 #include <prgrmr/generic/class_name.h>
-#include <iostream>
 
 namespace nike
 {
 class bird : virtual public shoe
 {
 public:
-    bird(int a, float b) : _a(a), _b(b)
+    bird(int a, float b) : shoe(prgrmr::generic::type_tag_of<bird>()), _a(a), _b(b)
     {
     }
 
+    static constexpr int   a_factor = 10;
+    static constexpr float b_factor = 10.0f;
+
     ~bird() override = default;
 
     void do_it() override
     {
-        _a *= 10;
-        _b *= 10.0;
-        std::cout << "Inside " << prgrmr::generic::class_name(*this) << ". a: " << _a << ", b: " << _b << std::endl;
+        _a *= a_factor;
+        _b *= b_factor;
+        print_line() << "Inside " << prgrmr::generic::class_name(*this) << ". a: " << _a << ", b: " << _b;
     }
 
 private:
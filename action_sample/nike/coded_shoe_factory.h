@@ -0,0 +1,49 @@
+#pragma once
+
+#include "shoe_factory.h"
+#include <prgrmr/generic/direct_index_map.h>
+#include <prgrmr/generic/factory.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace nike
+{
+///
+/// <summary>
+///   The product codes of the shoes, as some deployments key the factory by them instead of by name.
+/// </summary>
+///
+enum class shoe_code : std::uint16_t
+{
+   bird,
+   jordan,
+   lebron,
+   madison,
+   runner,
+   count
+};
+}
+
+///
+/// <summary>
+///   Every product code lies below shoe_code::count, hence the factory indexes its delegates by the code.
+/// </summary>
+///
+template<>
+struct prgrmr::generic::key_bound<nike::shoe_code>
+{
+   static constexpr std::size_t value = static_cast<std::size_t>(nike::shoe_code::count);
+};
+
+namespace nike
+{
+///
+/// <summary>
+///   The factory of shoes keyed by their product code, whose lookups are a single indexed load.
+/// </summary>
+///
+using coded_shoe_factory =
+      prgrmr::generic::key_class_factory<shoe_code,
+                                         base_constructor,
+                                         numerics_constructor>;
+}
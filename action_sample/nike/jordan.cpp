@@ -0,0 +1,4 @@
+#include "jordan.h"
+#include "shoe_registration.h"
+
+NIKE_REGISTER_SHOE(nike::jordan, jordan_registration, "jordan");
@@ -0,0 +1,4 @@
+#include "lebron.h"
+#include "shoe_registration.h"
+
+NIKE_REGISTER_SHOE(nike::lebron, lebron_registration, "lebron");
@@ -1,26 +1,32 @@
 #pragma once
 
 #include "shoe.h"
+#include "shoe_output.h"
 #include <prgrmr/generic/class_name.h>
-#include <iostream>
 
 namespace nike
 {
 class lebron : virtual public shoe
 {
 public:
-    lebron() = default;
-    lebron(int a, float b) : _a(a), _b(b)
+    lebron() : shoe(prgrmr::generic::type_tag_of<lebron>())
     {
     }
 
+    lebron(int a, float b) : shoe(prgrmr::generic::type_tag_of<lebron>()), _a(a), _b(b)
+    {
+    }
+
+    static constexpr int   a_factor = 2;
+    static constexpr float b_factor = 2.2f;
+
     ~lebron() override = default;
 
     void do_it() override
     {
-        _a *= 2;
-        _b *= 2.2f;
-        std::cout << "Inside " << prgrmr::generic::class_name(*this) << ". a: " << _a << ", b : " << _b << std::endl;
+        _a *= a_factor;
+        _b *= b_factor;
+        print_line() << "Inside " << prgrmr::generic::class_name(*this) << ". a: " << _a << ", b : " << _b;
     }
 
 private:
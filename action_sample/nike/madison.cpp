@@ -0,0 +1,4 @@
+#include "madison.h"
+#include "shoe_registration.h"
+
+NIKE_REGISTER_SHOE(nike::madison, madison_registration, "madison");
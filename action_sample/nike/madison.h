@@ -1,15 +1,18 @@
 #pragma once
 
 #include "shoe.h"
-#include <iostream>
+#include "shoe_output.h"
 
 namespace nike
 {
 class madison : virtual public shoe
 {
 public:
-   madison() = default;
-   madison(int a, float b) : _a(a), _b(b)
+   madison() : shoe(prgrmr::generic::type_tag_of<madison>())
+   {
+   }
+
+   madison(int a, float b) : shoe(prgrmr::generic::type_tag_of<madison>()), _a(a), _b(b)
    {
    }
 
@@ -19,7 +22,7 @@ public:
    {
       for (decltype(_a) i = 0; i < _a; i++)
       {
-         std::cout << "Madison, I love you " << _b * 1000.0f << "!!!" << std::endl;
+         print_line() << "Madison, I love you " << _b * 1000.0f << "!!!";
       }
    }
 
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "shoe_factory.h"
+#include <prgrmr/generic/plugin_factory.h>
+
+namespace nike
+{
+///
+/// <summary>
+///   The factory of shoes whose keys can be provided by plugins, loaded on their first construction.
+/// </summary>
+///
+using plugin_shoe_factory =
+      prgrmr::generic::plugin_key_class_factory<std::string,
+                                                base_constructor,
+                                                numerics_constructor>;
+
+///
+/// <summary>
+///   The path of the sample plugin, built from plugins/nike_plugin.cpp.
+/// </summary>
+///
+/// <remarks>
+///   The build may define NIKE_SAMPLE_PLUGIN_PATH as the path of the library it built, otherwise the library is
+///   looked up next to the application.
+/// </remarks>
+///
+#if defined(NIKE_SAMPLE_PLUGIN_PATH)
+inline constexpr const char* sample_plugin_path = NIKE_SAMPLE_PLUGIN_PATH;
+#elif defined(_WIN32)
+inline constexpr const char* sample_plugin_path = "nike_plugin.dll";
+#else
+inline constexpr const char* sample_plugin_path = "./libnike_plugin.so";
+#endif
+
+///
+/// <summary>
+///   The name of the function that the sample plugin exports to register its shoes.
+/// </summary>
+///
+inline constexpr const char* sample_plugin_entry = "nike_register_plugin";
+}
@@ -0,0 +1,4 @@
+#include "runner.h"
+#include "shoe_registration.h"
+
+NIKE_REGISTER_SHOE(nike::runner, runner_registration, "runner");
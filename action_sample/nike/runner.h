@@ -1,20 +1,23 @@
 #pragma once
 
 #include "shoe.h"
+#include "shoe_output.h"
 #include <prgrmr/generic/class_name.h>
-#include <iostream>
 
 namespace nike
 {
 class runner : virtual public shoe
 {
 public:
-    runner() = default;
+    runner() : shoe(prgrmr::generic::type_tag_of<runner>())
+    {
+    }
+
     ~runner() override = default;
 
     void do_it() override
     {
-        std::cout << "Inside " << prgrmr::generic::class_name(*this) << "." << std::endl;
+        print_line() << "Inside " << prgrmr::generic::class_name(*this) << ".";
     }
 };
 }
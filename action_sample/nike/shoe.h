@@ -1,16 +1,37 @@
 #pragma once
 
+#include <prgrmr/generic/type_tag.h>
+
 namespace nike
 {
 class shoe
 {
 public:
    shoe() = default;
-   virtual ~shoe() = 0 {};
+   virtual ~shoe() = 0;
    virtual void do_it() = 0;
 
+   ///
+   /// <summary>
+   ///   Get the tag of the dynamic type, as recorded at construction.
+   /// </summary>
+   ///
+   prgrmr::generic::type_tag type_tag() const noexcept
+   {
+      return _type_tag;
+   }
+
+protected:
+   explicit shoe(prgrmr::generic::type_tag tag) : _type_tag(tag)
+   {
+   }
+
 private:
    shoe(const shoe&) = delete;
    shoe& operator=(const shoe&) = delete;
+
+   prgrmr::generic::type_tag _type_tag = prgrmr::generic::untagged;
 };
+
+inline shoe::~shoe() = default;
 }
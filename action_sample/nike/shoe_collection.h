@@ -0,0 +1,324 @@
+#pragma once
+
+#include "bird.h"
+#include "jordan.h"
+#include "lebron.h"
+#include "madison.h"
+#include "runner.h"
+#include "shoe_factory.h"
+#include <prgrmr/generic/scale_kernels.h>
+#include <prgrmr/generic/type_tag.h>
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nike
+{
+///
+/// <summary>
+///   The shoe_collection class stores shoes by columns, i.e. one contiguous array per field of each concrete shoe type.
+///   <para>Running all the shoes streams through those arrays, rather than chasing a heap node and a virtual call per shoe.</para>
+/// </summary>
+///
+/// <remarks>
+///   Shoes are added with the same arguments as the factory's numerics constructor, namely a key, an int and a float.
+///   The concrete shoe type of each key is found out from the factory, by the type tag of a shoe it constructs.
+/// </remarks>
+///
+class shoe_collection final
+{
+public:
+   typedef shoe_factory::key_type key_type;
+
+   ///
+   /// <summary>
+   ///   The fields of all the shoes of one concrete type, one array per field.
+   /// </summary>
+   ///
+   struct field_columns
+   {
+      std::vector<int>   a;
+      std::vector<float> b;
+   };
+
+   shoe_collection() = default;
+
+   ///
+   /// <summary>
+   ///   Constructs an empty collection of the shoes of the keys registered in the factory.
+   /// </summary>
+   ///
+   /// <seealso cref="register_keys"/>
+   ///
+   explicit shoe_collection(const shoe_factory& factory)
+   {
+      register_keys(factory);
+   }
+
+   shoe_collection(const shoe_collection&) = default;
+   shoe_collection(shoe_collection&&) = default;
+
+   ~shoe_collection() = default;
+
+   shoe_collection& operator=(const shoe_collection&) = default;
+   shoe_collection& operator=(shoe_collection&&) = default;
+
+   ///
+   /// <summary>
+   ///   Associates each key registered in the factory with the concrete type of the shoes it constructs.
+   /// </summary>
+   ///
+   /// <param name="factory">The factory whose keys are to be associated.</param>
+   ///
+   /// <remarks>
+   ///   A shoe of each key is constructed with the base signature, and its type tag gives its concrete type. The keys
+   ///   that don't construct one of the shoe types of the collection are left out.
+   /// </remarks>
+   ///
+   void register_keys(const shoe_factory& factory)
+   {
+      factory.for_each_key([this, &factory](const key_type& key)
+                           {
+                              const auto shoe = factory.construct<base_constructor>(key);
+
+                              if (shoe == nullptr)
+                              {
+                                 return;
+                              }
+
+                              if (const auto type = type_of(shoe->type_tag()))
+                              {
+                                 _types[key] = *type;
+                              }
+                           });
+   }
+
+   ///
+   /// <summary>
+   ///   Removes the association of a key with its concrete shoe type.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key, as registered in the factory.</param>
+   ///
+   void unregister_key(const key_type& key)
+   {
+      _types.erase(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Adds a shoe of the given concrete type.
+   /// </summary>
+   ///
+   /// <param name="a">The first argument of the numerics constructor.</param>
+   /// <param name="b">The second argument of the numerics constructor.</param>
+   ///
+   /// <remarks>The arguments are ignored for the shoes that don't have any fields, such as the runner.</remarks>
+   ///
+   template<class shoe_t>
+   void emplace(int a, float b)
+   {
+      emplace(type_of<shoe_t>(), a, b);
+   }
+
+   ///
+   /// <summary>
+   ///   Adds a shoe of the concrete type associated with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key of the shoe.</param>
+   /// <param name="a">The first argument of the numerics constructor.</param>
+   /// <param name="b">The second argument of the numerics constructor.</param>
+   ///
+   /// <returns>false when the given key cannot be found.</returns>
+   ///
+   bool emplace(const key_type& key, int a, float b)
+   {
+      const auto& iter = _types.find(key);
+
+      if (iter == std::end(_types))
+      {
+         return false;
+      }
+
+      emplace(iter->second, a, b);
+
+      return true;
+   }
+
+   ///
+   /// <summary>
+   ///   Runs all the shoes, applying to each field what the do_it method of its shoe type does.
+   /// </summary>
+   ///
+   /// <remarks>
+   ///   Nothing is written to the output sink, the collection behaves as if the shoes were running with a null sink.
+   ///   Hence, the madison and runner shoes, whose do_it only writes, are left unchanged.
+   /// </remarks>
+   ///
+   void execute_all() noexcept
+   {
+      execute<bird>(_birds);
+      execute<jordan>(_jordans);
+      execute<lebron>(_lebrons);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the fields of all the shoes of the given concrete type.
+   /// </summary>
+   ///
+   template<class shoe_t>
+   const field_columns& columns() const
+   {
+      static_assert(!std::is_same_v<shoe_t, runner>, "The runner shoes don't have any fields.");
+
+      return columns_of(type_of<shoe_t>());
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of shoes of the given concrete type.
+   /// </summary>
+   ///
+   template<class shoe_t>
+   std::size_t count() const
+   {
+      if constexpr (std::is_same_v<shoe_t, runner>)
+         return _runners;
+      else
+         return columns_of(type_of<shoe_t>()).a.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of shoes of all types.
+   /// </summary>
+   ///
+   std::size_t size() const
+   {
+      return _birds.a.size() + _jordans.a.size() + _lebrons.a.size() + _madisons.a.size() + _runners;
+   }
+
+   ///
+   /// <summary>
+   ///   Removes all the shoes, the keys remain associated with their shoe type.
+   /// </summary>
+   ///
+   void clear()
+   {
+      for (auto* fields : { &_birds, &_jordans, &_lebrons, &_madisons })
+      {
+         fields->a.clear();
+         fields->b.clear();
+      }
+
+      _runners = 0;
+   }
+
+   ///
+   /// <summary>
+   ///   Swaps the contents with another reference.
+   /// </summary>
+   ///
+   /// <param name="other">The reference to swap contents with.</param>
+   ///
+   void swap(shoe_collection& other)
+   {
+      std::swap(*this, other);
+   }
+
+private:
+   enum class shoe_type : unsigned char
+   {
+      bird,
+      jordan,
+      lebron,
+      madison,
+      runner
+   };
+
+   template<class shoe_t>
+   static constexpr shoe_type type_of()
+   {
+      if constexpr (std::is_same_v<shoe_t, bird>)
+         return shoe_type::bird;
+      else if constexpr (std::is_same_v<shoe_t, jordan>)
+         return shoe_type::jordan;
+      else if constexpr (std::is_same_v<shoe_t, lebron>)
+         return shoe_type::lebron;
+      else if constexpr (std::is_same_v<shoe_t, madison>)
+         return shoe_type::madison;
+      else if constexpr (std::is_same_v<shoe_t, runner>)
+         return shoe_type::runner;
+      else
+         static_assert(sizeof(shoe_t) == 0, "The shoe type isn't supported by the collection.");
+   }
+
+   static std::optional<shoe_type> type_of(prgrmr::generic::type_tag tag)
+   {
+      using prgrmr::generic::type_tag_of;
+
+      if (tag == type_tag_of<bird>())
+         return shoe_type::bird;
+      if (tag == type_tag_of<jordan>())
+         return shoe_type::jordan;
+      if (tag == type_tag_of<lebron>())
+         return shoe_type::lebron;
+      if (tag == type_tag_of<madison>())
+         return shoe_type::madison;
+      if (tag == type_tag_of<runner>())
+         return shoe_type::runner;
+
+      return std::nullopt;
+   }
+
+   template<class shoe_t>
+   static void execute(field_columns& fields) noexcept
+   {
+      prgrmr::generic::scale(fields.a.data(), fields.a.size(), shoe_t::a_factor);
+      prgrmr::generic::scale(fields.b.data(), fields.b.size(), shoe_t::b_factor);
+   }
+
+   void emplace(shoe_type type, int a, float b)
+   {
+      if (type == shoe_type::runner)
+      {
+         ++_runners;
+         return;
+      }
+
+      auto& fields = columns_of(type);
+
+      fields.a.push_back(a);
+      fields.b.push_back(b);
+   }
+
+   const field_columns& columns_of(shoe_type type) const
+   {
+      switch (type)
+      {
+      case shoe_type::bird:    return _birds;
+      case shoe_type::jordan:  return _jordans;
+      case shoe_type::lebron:  return _lebrons;
+      default:                 return _madisons;
+      }
+   }
+
+   field_columns& columns_of(shoe_type type)
+   {
+      return const_cast<field_columns&>(std::as_const(*this).columns_of(type));
+   }
+
+   std::unordered_map<key_type, shoe_type> _types;
+   field_columns                           _birds;
+   field_columns                           _jordans;
+   field_columns                           _lebrons;
+   field_columns                           _madisons;
+   std::size_t                             _runners = 0;
+};
+}
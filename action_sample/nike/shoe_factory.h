@@ -10,11 +10,9 @@ namespace nike
 {
 using base_constructor     = std::function<std::unique_ptr<shoe> ()>;
 using numerics_constructor = std::function<std::unique_ptr<shoe> (int, float)>;
-using invalid_result       = std::function<int (int, float)>;
 
 using shoe_factory =
       prgrmr::generic::key_class_factory<std::string,
                                          base_constructor,
-                                         numerics_constructor,
-                                         invalid_result>;
+                                         numerics_constructor>;
 }
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <prgrmr/generic/output_sink.h>
+#include <atomic>
+
+namespace nike
+{
+///
+/// <summary>
+///   Get the sink that writes to the standard output, which is used until another sink is assigned.
+/// </summary>
+///
+inline prgrmr::generic::output_sink& standard_output()
+{
+   static prgrmr::generic::buffered_output_sink sink(prgrmr::generic::buffered_output_sink::standard_output_descriptor);
+
+   return sink;
+}
+
+namespace detail
+{
+inline std::atomic<prgrmr::generic::output_sink*> current_output{nullptr};
+}
+
+///
+/// <summary>
+///   Get the sink in which all shoes write their output.
+/// </summary>
+///
+inline prgrmr::generic::output_sink& output()
+{
+   auto* sink = detail::current_output.load(std::memory_order_acquire);
+
+   return (sink != nullptr)
+          ? *sink
+          : standard_output();
+}
+
+///
+/// <summary>
+///   Assigns the sink in which all shoes write their output.
+/// </summary>
+///
+/// <param name="sink">The sink to write to. It must outlive its assignment.</param>
+///
+inline void set_output(prgrmr::generic::output_sink& sink)
+{
+   detail::current_output.store(std::addressof(sink), std::memory_order_release);
+}
+
+///
+/// <summary>
+///   Reverts to writing the output of all shoes to the standard output.
+/// </summary>
+///
+inline void reset_output()
+{
+   detail::current_output.store(nullptr, std::memory_order_release);
+}
+
+///
+/// <summary>
+///   Starts a line of text in the sink of the shoes.
+/// </summary>
+///
+inline prgrmr::generic::output_line print_line()
+{
+   return prgrmr::generic::output_line(output());
+}
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "shoe_factory.h"
+#include <prgrmr/generic/pipeline.h>
+
+namespace nike
+{
+///
+/// <summary>
+///   Constructs shoes with the numerics signature on some threads, and runs them on other threads.
+/// </summary>
+///
+using shoe_pipeline = prgrmr::generic::construct_execute_pipeline<shoe_factory, numerics_constructor>;
+}
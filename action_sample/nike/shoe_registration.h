@@ -0,0 +1,57 @@
+#pragma once
+
+#include "shoe.h"
+#include "shoe_factory.h"
+#include <prgrmr/generic/static_registration.h>
+#include <concepts>
+#include <memory>
+
+namespace nike
+{
+///
+/// <summary>
+///   Constructs a shoe with the base signature, which falls back on the numerics constructor when the shoe doesn't
+///   have a default constructor.
+/// </summary>
+///
+/// <remarks>A plain function, hence its address can be registered into a constant initialized table.</remarks>
+///
+template<class shoe_t>
+std::unique_ptr<shoe> make_shoe()
+{
+   if constexpr (std::default_initializable<shoe_t>)
+   {
+      return std::make_unique<shoe_t>();
+   }
+   else
+   {
+      return std::make_unique<shoe_t>(0, 0.0f);
+   }
+}
+
+///
+/// <summary>
+///   Constructs a shoe with the numerics signature, which falls back on the default constructor when the shoe doesn't
+///   have a numerics constructor.
+/// </summary>
+///
+template<class shoe_t>
+std::unique_ptr<shoe> make_shoe(int a, float b)
+{
+   if constexpr (std::constructible_from<shoe_t, int, float>)
+   {
+      return std::make_unique<shoe_t>(a, b);
+   }
+   else
+   {
+      return std::make_unique<shoe_t>();
+   }
+}
+}
+
+///
+/// Registers a shoe type under a key of the nike::shoe_factory, with both of its signatures.
+/// It belongs in the source file of the shoe, once, as it defines the record that the linker collects.
+///
+#define NIKE_REGISTER_SHOE(shoe_t, name, key) \
+   PRGRMR_STATIC_REGISTRATION(nike::shoe_factory, name, key, &nike::make_shoe<shoe_t>, &nike::make_shoe<shoe_t>)
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "shoe_factory.h"
+#include <prgrmr/generic/snapshot.h>
+#include <string>
+
+namespace nike
+{
+///
+/// <summary>
+///   Records the shoes constructed with the numerics signature, to write them into a snapshot file.
+/// </summary>
+///
+using shoe_snapshot_writer = prgrmr::generic::snapshot_writer<std::string, numerics_constructor>;
+
+///
+/// <summary>
+///   Maps a snapshot file of shoes, to construct them again in bulk on a warm restart.
+/// </summary>
+///
+using shoe_snapshot = prgrmr::generic::snapshot_view<std::string, numerics_constructor>;
+}
@@ -0,0 +1,33 @@
+#include <nike/lebron.h>
+#include <nike/madison.h>
+#include <nike/plugin_shoe_factory.h>
+#include <nike/shoe_output.h>
+#include <nike/shoe_registration.h>
+
+///
+/// <summary>
+///  The sample plugin, built as a shared library, that registers its shoes into the factory that loads it.
+/// </summary>
+///
+/// <remarks>
+///  It is built by the nike_plugin target, of both the CMake build and the Visual Studio solution.
+/// </remarks>
+///
+PRGRMR_PLUGIN_EXPORT void nike_register_plugin(nike::plugin_shoe_factory::factory_type& factory)
+{
+   using nike::make_shoe;
+
+   // The plugin has its own copy of the output of the shoes, which the application doesn't flush, hence its lines
+   // are written out as soon as they are complete.
+   static prgrmr::generic::buffered_output_sink output(prgrmr::generic::buffered_output_sink::standard_output_descriptor, 0);
+
+   nike::set_output(output);
+
+   factory.register_functions("plugin/lebron",
+                              { static_cast<std::unique_ptr<nike::shoe> (*)()>(&make_shoe<nike::lebron>),
+                                static_cast<std::unique_ptr<nike::shoe> (*)(int, float)>(&make_shoe<nike::lebron>) });
+
+   factory.register_functions("plugin/madison",
+                              { static_cast<std::unique_ptr<nike::shoe> (*)()>(&make_shoe<nike::madison>),
+                                static_cast<std::unique_ptr<nike::shoe> (*)(int, float)>(&make_shoe<nike::madison>) });
+}
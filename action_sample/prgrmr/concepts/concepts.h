@@ -1,4 +1,5 @@
 #pragma once
 
 #include "arguments.h"
+#include "function_traits.h"
 #include "invocable.h"
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+
+namespace prgrmr::concepts
+{
+///
+/// <summary>
+///   The function_traits class describes the signature of a function type: its result and its arguments.
+/// </summary>
+///
+/// <remarks>
+///   Defined for function types, pointers to functions and std::function. The concepts check the signatures with it,
+///   and the generic library reaches it through prgrmr/generic/function_traits.h.
+/// </remarks>
+///
+template<class function_t>
+struct function_traits;
+
+template<class result_t, class... args_t>
+struct function_traits<result_t (args_t...)>
+{
+   using result_type    = result_t;
+   using argument_types = std::tuple<args_t...>;
+
+   ///
+   /// <summary>
+   ///   The arguments without their references and cv-qualifiers, i.e. as they are held by value.
+   /// </summary>
+   ///
+   using decayed_argument_types = std::tuple<std::decay_t<args_t>...>;
+
+   ///
+   /// <summary>
+   ///   The type of a pointer to a function of the same signature.
+   /// </summary>
+   ///
+   using pointer_type = result_t (*)(args_t...);
+
+   static constexpr std::size_t arity = sizeof...(args_t);
+};
+
+template<class result_t, class... args_t>
+struct function_traits<result_t (*)(args_t...)> : function_traits<result_t (args_t...)>
+{
+};
+
+template<class result_t, class... args_t>
+struct function_traits<std::function<result_t (args_t...)>> : function_traits<result_t (args_t...)>
+{
+};
+
+///
+/// <summary>
+///   The result type of the given function type.
+/// </summary>
+///
+template<class function_t>
+using function_result_t = typename function_traits<function_t>::result_type;
+}
@@ -1,52 +1,98 @@
 #pragma once
 
 #include "arguments.h"
+#include "function_traits.h"
 
 #include <concepts>
+#include <cstddef>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace prgrmr::concepts::invocable
 {
 
+namespace detail
+{
+template<typename Function, typename Arguments>
+inline constexpr bool is_invocable_with = false;
+
+template<typename Function, typename... Arguments>
+inline constexpr bool is_invocable_with<Function, std::tuple<Arguments...>> = std::is_invocable_v<Function, Arguments...>;
+
+template<typename Function>
+struct tag
+{
+};
+
+template<std::size_t Index, typename Function>
+struct indexed_tag : tag<Function>
+{
+};
+
+template<typename Indices, typename... Functions>
+struct indexed_tags;
+
+///
+/// Derives once from tag<Function> per occurrence of each function. A function that occurs twice makes its tag an
+/// ambiguous base, which is the only case where converting to a pointer to that tag fails.
+///
+template<std::size_t... Indices, typename... Functions>
+struct indexed_tags<std::index_sequence<Indices...>, Functions...> : indexed_tag<Indices, Functions>...
+{
+};
+}
+
+///
+/// Expression to indicate if the given invocable function can be invoked with the arguments of its own signature.
+///
+template<typename Function>
+inline constexpr bool is_invocable = detail::is_invocable_with<Function, typename function_traits<Function>::argument_types>;
+
 ///
 /// Concept verifying that two invocable functions return the same return type.
 ///
 template<typename LHS, typename RHS>
-concept IsSameReturnType = std::invocable<LHS>
-                        && std::invocable<RHS>
-                        && std::is_same_v<typename std::invoke_result<LHS>::type,
-                                          typename std::invoke_result<RHS>::type>;
+concept IsSameReturnType = std::is_same_v<function_result_t<LHS>,
+                                          function_result_t<RHS>>;
+
+///
+/// Expression to indicate if the given pair of invocable functions return the same type.
+///
+template<typename LHS, typename RHS>
+inline constexpr bool are_same_return_type = IsSameReturnType<LHS, RHS>;
 
 ///
 /// Expression to indicate if the given sequence of arguments represents a
 /// sequence invocable functions ALL of which return the same type.
 ///
-template<typename LHS, typename RHS>
-requires (std::invocable<LHS> && std::invocable<RHS>)
-inline constexpr bool are_same_return_type = std::is_same_v<typename std::invoke_result<LHS>::type,
-                                                            typename std::invoke_result<RHS>::type>;
+/// This is the default implementation for when there aren't any arguments.
+///
+template<typename...Functions>
+inline constexpr bool are_all_same_return_type = true;
 
 ///
 /// Expression to indicate if the given sequence of arguments represents a
 /// sequence invocable functions ALL of which return the same type.
 ///
+/// Each function is compared with the first one, hence it is linear in the number of functions.
+///
 template<typename Head, typename...Tail>
-inline constexpr bool are_all_same_return_type = (are_same_return_type<Head, Tail> && ...);
+inline constexpr bool are_all_same_return_type<Head, Tail...> = (std::is_same_v<function_result_t<Head>,
+                                                                                function_result_t<Tail>> && ...);
 
 ///
 /// Concept to verify if the given sequence of arguments represents a
 /// sequence invocable functions ALL of which return the same type.
 ///
-template<typename Head, typename ...Tail>
-concept AreAllSameReturnType = are_all_same_return_type<Head, Tail...>;
+template<typename...Functions>
+concept AreAllSameReturnType = are_all_same_return_type<Functions...>;
 
 ///
 /// Concept verifying that a pair of invocable functions are considered as being the same.
 ///
 template<typename LHS, typename RHS>
-concept IsSame = std::invocable<LHS>
-              && std::invocable<RHS>
-              && std::is_same_v<LHS, RHS>;
+concept IsSame = std::is_same_v<LHS, RHS>;
 
 ///
 /// Concept verifying that a pair of invocable functions are considered as being the different.
@@ -58,32 +104,29 @@ concept IsDifferent = !IsSame<LHS, RHS>;
 /// Expression that indicates that the given arguments represents a sequence of invocable functions that are all
 /// different from each other.
 ///
-/// This is the default implementation for when there one argument or none.
+/// Rather than comparing each pair of functions, which instantiates quadratically many templates, a single class
+/// derives from one tag per function, then each tag is checked to be an unambiguous base of that class. Hence the
+/// number of instantiated templates is linear in the number of functions.
 ///
 template <typename...Functions>
-inline constexpr bool are_all_different = arguments::IsEmpty<Functions>
-                                       || (arguments::IsSingle<Functions> && std::invocable<Functions>);
+inline constexpr bool are_all_different =
+   (std::is_convertible_v<detail::indexed_tags<std::index_sequence_for<Functions...>, Functions...>*,
+                          detail::tag<Functions>*> && ...);
 
 ///
-/// Expression that indicates that the given arguments represents a sequence of invocable functions that are all
-/// different from each other.
+/// Concept verifying that the given arguments represents a sequence of invocable functions that are all different from each other.
 ///
-template <typename Head, typename ... Tail>
-inline constexpr bool are_all_different<Head, Tail...> = IsDifferent<Head, Tail...>
-                                                      && are_all_different<Tail...>;
+template<typename... Functions>
+concept AreAllDifferent = are_all_different<Functions...>;
 
 ///
-/// Concept verifying that the given arguments represents a sequence of invocable functions that are all different from each other.
+/// Expression to indicate if ALL the given invocable functions can be invoked with the arguments of their signature.
 ///
-template<typename Functions>
-concept AreAllDifferent = are_all_different<Functions>;
-
 template<typename ... Functions>
-    requires (std::invocable<Functions> && ...)
-inline constexpr bool are_all_invocable = true;
+inline constexpr bool are_all_invocable = (is_invocable<Functions> && ...);
 
-template<typename Functions>
-concept AreAllInvocable = are_all_invocable<Functions>;
+template<typename... Functions>
+concept AreAllInvocable = are_all_invocable<Functions...>;
 
 /////
 ///// Expression to check if the given pair of invocable functions are the same.
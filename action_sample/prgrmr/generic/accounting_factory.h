@@ -0,0 +1,581 @@
+#pragma once
+
+#include "factory.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The counters of the instances constructed with a key, which remain valid for as long as the factory.
+/// </summary>
+///
+/// <remarks>
+///   The counters are split into stripes, each on its own cache line, and each thread counts into its own stripe.
+///   Hence threads constructing at once with the same key don't bounce a cache line between their cores, and reading
+///   the counters sums the stripes. Up to stripe_count threads each have a stripe of their own, more threads share them.
+///   The observed peak is sampled: it is the highest number of live instances that a read of the counters saw, so a
+///   higher peak between two reads is missed. An exact peak would take a shared counter on every construction.
+/// </remarks>
+///
+class instance_counters final
+{
+public:
+   static constexpr std::size_t stripe_count = 16;
+
+   instance_counters() = default;
+   instance_counters(const instance_counters&) = delete;
+   instance_counters(instance_counters&&) = delete;
+
+   ~instance_counters() = default;
+
+   instance_counters& operator=(const instance_counters&) = delete;
+   instance_counters& operator=(instance_counters&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Counts an instance that was constructed.
+   /// </summary>
+   ///
+   void acquired(std::size_t bytes) noexcept
+   {
+      auto& stripe = _stripes[stripe_index()];
+
+      stripe.live.fetch_add(1, std::memory_order_relaxed);
+      stripe.bytes.fetch_add(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+      stripe.constructed.fetch_add(1, std::memory_order_relaxed);
+   }
+
+   ///
+   /// <summary>
+   ///   Counts an instance that was destroyed, which may be by another thread than the one that constructed it.
+   /// </summary>
+   ///
+   void released(std::size_t bytes) noexcept
+   {
+      auto& stripe = _stripes[stripe_index()];
+
+      stripe.live.fetch_sub(1, std::memory_order_relaxed);
+      stripe.bytes.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+   }
+
+   std::int64_t live() const noexcept
+   {
+      std::int64_t live = 0;
+
+      for (const auto& stripe : _stripes)
+      {
+         live += stripe.live.load(std::memory_order_relaxed);
+      }
+
+      return live;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the highest number of live instances that a read of the counters saw so far, including this one.
+   /// </summary>
+   ///
+   /// <remarks>This is a sample, not a high-water mark: the number of live instances may have been higher between reads.</remarks>
+   ///
+   std::int64_t observed_peak() const noexcept
+   {
+      const auto live = this->live();
+      auto peak = _observed_peak.load(std::memory_order_relaxed);
+
+      while (live > peak && !_observed_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+      {
+      }
+
+      return std::max(peak, live);
+   }
+
+   std::int64_t bytes() const noexcept
+   {
+      std::int64_t bytes = 0;
+
+      for (const auto& stripe : _stripes)
+      {
+         bytes += stripe.bytes.load(std::memory_order_relaxed);
+      }
+
+      return bytes;
+   }
+
+   std::uint64_t constructed() const noexcept
+   {
+      std::uint64_t constructed = 0;
+
+      for (const auto& stripe : _stripes)
+      {
+         constructed += stripe.constructed.load(std::memory_order_relaxed);
+      }
+
+      return constructed;
+   }
+
+private:
+   struct alignas(64) stripe
+   {
+      std::atomic<std::int64_t>  live{0};
+      std::atomic<std::int64_t>  bytes{0};
+      std::atomic<std::uint64_t> constructed{0};
+   };
+
+   ///
+   /// <summary>
+   ///   Get the stripe of the calling thread, which threads are handed in turn on their first count.
+   /// </summary>
+   ///
+   static std::size_t stripe_index() noexcept
+   {
+      static std::atomic<std::size_t> next{0};
+
+      thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % stripe_count;
+
+      return index;
+   }
+
+   std::array<stripe, stripe_count>  _stripes;
+   mutable std::atomic<std::int64_t> _observed_peak{0};
+};
+
+///
+/// <summary>
+///   The tracking_deleter class deletes an instance and counts it as released by the key that constructed it.
+/// </summary>
+///
+/// <remarks>A default constructed deleter only deletes, it doesn't count.</remarks>
+///
+template<class product_t>
+class tracking_deleter final
+{
+public:
+   tracking_deleter() noexcept = default;
+
+   tracking_deleter(instance_counters* counters,
+                    std::size_t bytes) noexcept
+   : _counters(counters),
+     _bytes(bytes)
+   {
+   }
+
+   ///
+   /// <summary>
+   ///   Converts from the deleter of a derived class, as std::default_delete does.
+   /// </summary>
+   ///
+   template<class other_t>
+      requires std::is_convertible_v<other_t*, product_t*>
+   tracking_deleter(const tracking_deleter<other_t>& other) noexcept
+   : _counters(other.counters()),
+     _bytes(other.bytes())
+   {
+   }
+
+   void operator()(product_t* product) const noexcept
+   {
+      if (_counters != nullptr)
+      {
+         _counters->released(_bytes);
+      }
+
+      delete product;
+   }
+
+   instance_counters* counters() const noexcept
+   {
+      return _counters;
+   }
+
+   std::size_t bytes() const noexcept
+   {
+      return _bytes;
+   }
+
+private:
+   instance_counters* _counters = nullptr;
+   std::size_t        _bytes    = 0;
+};
+
+///
+/// <summary>
+///   A snapshot of the counters of the instances constructed with a key.
+/// </summary>
+///
+template<class key_t>
+struct instance_statistics
+{
+   key_t         key{};
+   std::int64_t  live          = 0;   // Number of instances that are still alive.
+   std::int64_t  observed_peak = 0;   // Highest number of instances alive at once that a snapshot observed.
+   std::int64_t  bytes         = 0;   // Memory held by the instances that are still alive.
+   std::uint64_t constructed   = 0;   // Number of instances constructed so far.
+};
+
+///
+/// <summary>
+///   The accounting_key_class_factory class is a key_class_factory that keeps count of the instances that each key constructed.
+///   <para>The instances are owned by a std::unique_ptr whose deleter counts them as released when they are destroyed.</para>
+///   <para>Hence, the number of instances that are still alive, their observed peak and the memory they hold are known for each key.</para>
+/// </summary>
+///
+/// <remarks>
+///   Each key has an account that holds both its delegate and its counters, hence a construction looks up the key once.
+///   The memory of an instance is the size of the type registered with register_instance_type, which is 0 until then.
+///   The counters of a key are kept once it is unregistered, hence the instances it constructed remain accounted for.
+///   The factory must outlive the instances that it constructed, since their deleters refer to its counters.
+///   The registered functions must return a std::unique_ptr with the default deleter.
+/// </remarks>
+///
+/// <seealso cref="key_class_factory"/>
+/// <seealso cref="instance_counters"/>
+///
+template<class key_t, class... functions_t>
+class accounting_key_class_factory final
+{
+public:
+   typedef key_t key_type;
+   using function_types = std::tuple<functions_t...>;
+   typedef delegate_functions<functions_t...> delegate_type;
+   typedef typename delegate_type::result_type::element_type product_type;
+   typedef std::unique_ptr<product_type, tracking_deleter<product_type>> pointer_type;
+   typedef instance_statistics<key_type> statistics_type;
+
+   static_assert(std::is_same_v<typename delegate_type::result_type, std::unique_ptr<product_type>>,
+                 "The functions of an accounting factory must return a std::unique_ptr with the default deleter.");
+
+   accounting_key_class_factory() = default;
+   accounting_key_class_factory(const accounting_key_class_factory&) = delete;
+   accounting_key_class_factory(accounting_key_class_factory&&) = delete;
+
+   ~accounting_key_class_factory() = default;
+
+   accounting_key_class_factory& operator=(const accounting_key_class_factory&) = delete;
+   accounting_key_class_factory& operator=(accounting_key_class_factory&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Registers all the delegate under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   /// <remarks>As with key_class_factory, the delegate of a key that is already registered is kept.</remarks>
+   ///
+   void register_delegate(const key_type& key,
+                          const delegate_type& delegate)
+   {
+      auto& account = this->account(key);
+
+      if (!account.registered)
+      {
+         account.delegate   = delegate;
+         account.registered = true;
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the functions under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with these function signatures.</param>
+   /// <param name="functions">The functions that are to be registered.</param>
+   ///
+   void register_functions(const key_type& key,
+                           function_types functions)
+   {
+      register_delegate(key, delegate_type(std::move(functions)));
+   }
+
+   ///
+   /// <summary>
+   ///   Registers a single function under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with this function.</param>
+   /// <param name="function">The function that is to be registered.</param>
+   ///
+   template<class function_t>
+   void register_function(const key_type& key,
+                          function_t function)
+   {
+      auto& account = this->account(key);
+
+      account.delegate.register_function(std::move(function));
+      account.registered = true;
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the type of the instances constructed with the given key, whose size is then accounted for each instance.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key whose functions construct instances of this type.</param>
+   ///
+   template<class instance_t>
+   void register_instance_type(const key_type& key)
+   {
+      static_assert(std::is_convertible_v<instance_t*, product_type*>, "The instances must be products of the factory.");
+
+      account(key).size = sizeof(instance_t);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters all the functions that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   /// <remarks>The counters of the key are kept, hence they still account for the instances that remain alive.</remarks>
+   ///
+   void unregister_delegate(const key_type& key)
+   {
+      if (auto* account = find(key))
+      {
+         delegate_type empty;
+
+         account->delegate.swap(empty);
+         account->registered = false;
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<class function_t>
+   void unregister_function(const key_type& key)
+   {
+      if (auto* account = find(key))
+      {
+         account->delegate.template unregister_function<function_t>();
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<int index_t>
+   void unregister_function(const key_type& key)
+   {
+      if (auto* account = find(key))
+      {
+         account->delegate.template unregister_function<index_t>();
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, which is accounted for until it is destroyed.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class function_t, class... args_t>
+   pointer_type construct(const key_type& key,
+                          args_t&&... args) const
+   {
+      auto* account = find(key);
+
+      if (account == nullptr)
+      {
+         return pointer_type();
+      }
+
+      const auto& function = account->delegate.template get_function<function_t>();
+
+      return (function)
+             ? track(*account, function(std::forward<args_t>(args)...))
+             : pointer_type();
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, which is accounted for until it is destroyed.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<int index_t, class... args_t>
+   pointer_type construct(const key_type& key,
+                          args_t&&... args) const
+   {
+      auto* account = find(key);
+
+      if (account == nullptr)
+      {
+         return pointer_type();
+      }
+
+      const auto& function = account->delegate.template get_function<index_t>();
+
+      return (function)
+             ? track(*account, function(std::forward<args_t>(args)...))
+             : pointer_type();
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class with the signature that is the best match for the given arguments.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class... args_t>
+      requires (!is_signature_named<function_types, args_t...>)
+   pointer_type construct(const key_type& key,
+                          args_t&&... args) const
+   {
+      using selection = best_signature<function_types, args_t...>;
+
+      static_assert(selection::is_found, "None of the constructor signatures can be invoked with the given arguments.");
+      static_assert(!selection::is_found || selection::is_unique,
+                    "The given arguments match more than one constructor signature, name the signature instead.");
+
+      if constexpr (selection::is_found && selection::is_unique)
+      {
+         return construct<static_cast<int>(selection::index)>(key, std::forward<args_t>(args)...);
+      }
+      else
+      {
+         return pointer_type();
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is registered.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for.</param>
+   ///
+   bool contains(const key_type& key) const
+   {
+      const auto* account = find(key);
+
+      return (account != nullptr) && account->registered;
+   }
+
+   ///
+   /// <summary>
+   ///   Get a snapshot of the counters of the given key.
+   /// </summary>
+   ///
+   /// <remarks>The counters are read one after the other, hence concurrent constructions may be partially counted.</remarks>
+   ///
+   statistics_type statistics(const key_type& key) const
+   {
+      const auto iter = _accounts.find(key);
+
+      return (iter != std::end(_accounts))
+             ? snapshot(iter->first, *iter->second)
+             : statistics_type{key};
+   }
+
+   ///
+   /// <summary>
+   ///   Get a snapshot of the counters of every key that was ever registered, in no particular order.
+   /// </summary>
+   ///
+   std::vector<statistics_type> statistics() const
+   {
+      std::vector<statistics_type> statistics;
+
+      statistics.reserve(_accounts.size());
+
+      for (const auto& [key, account] : _accounts)
+      {
+         statistics.push_back(snapshot(key, *account));
+      }
+
+      return statistics;
+   }
+
+private:
+   struct key_account
+   {
+      delegate_type     delegate;
+      bool              registered = false;
+      std::size_t       size       = 0;
+      instance_counters counters;
+   };
+
+   static statistics_type snapshot(const key_type& key,
+                                   const key_account& account)
+   {
+      statistics_type statistics{key};
+
+      statistics.live          = account.counters.live();
+      statistics.observed_peak = account.counters.observed_peak();
+      statistics.bytes         = account.counters.bytes();
+      statistics.constructed   = account.counters.constructed();
+
+      return statistics;
+   }
+
+   key_account& account(const key_type& key)
+   {
+      auto& account = _accounts[key];
+
+      if (account == nullptr)
+      {
+         account = std::make_unique<key_account>();
+      }
+
+      return *account;
+   }
+
+   key_account* find(const key_type& key) const
+   {
+      const auto iter = _accounts.find(key);
+
+      return (iter != std::end(_accounts))
+             ? iter->second.get()
+             : nullptr;
+   }
+
+   static pointer_type track(key_account& account,
+                             std::unique_ptr<product_type> instance)
+   {
+      if (instance == nullptr)
+      {
+         return pointer_type();
+      }
+
+      account.counters.acquired(account.size);
+
+      return pointer_type(instance.release(), tracking_deleter<product_type>(&account.counters, account.size));
+   }
+
+   // The accounts are never erased and never move, hence the deleters may refer to them.
+   std::unordered_map<key_type, std::unique_ptr<key_account>> _accounts;
+};
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The arena_deleter class destroys an instance without deallocating its memory.
+///   <para>The memory belongs to an arena, e.g. a std::pmr::monotonic_buffer_resource, which releases it all at once.</para>
+/// </summary>
+///
+/// <remarks>Hence, the instances must be destroyed before their arena is released or destroyed.</remarks>
+///
+template<class instance_t>
+struct arena_deleter
+{
+   arena_deleter() noexcept = default;
+
+   ///
+   /// <summary>
+   ///   Converts from the deleter of a derived class, as std::default_delete does.
+   /// </summary>
+   ///
+   template<class other_t>
+      requires std::is_convertible_v<other_t*, instance_t*>
+   arena_deleter(const arena_deleter<other_t>&) noexcept
+   {
+   }
+
+   void operator()(instance_t* instance) const noexcept
+   {
+      std::destroy_at(instance);
+   }
+};
+
+///
+/// <summary>
+///   A std::unique_ptr that owns an instance allocated in an arena.
+/// </summary>
+///
+template<class instance_t>
+using arena_ptr = std::unique_ptr<instance_t, arena_deleter<instance_t>>;
+
+///
+/// <summary>
+///   Constructs an instance in the memory of the given arena.
+/// </summary>
+///
+/// <param name="resource">The arena, which must outlive the instance.</param>
+/// <param name="args">The arguments to pass to the constructor of the instance.</param>
+///
+/// <returns>The instance, which is destroyed without deallocating its memory.</returns>
+///
+template<class instance_t, class... args_t>
+arena_ptr<instance_t> make_arena(std::pmr::memory_resource* resource,
+                                 args_t&&... args)
+{
+   std::pmr::polymorphic_allocator<instance_t> allocator(resource);
+
+   return arena_ptr<instance_t>(allocator.template new_object<instance_t>(std::forward<args_t>(args)...));
+}
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The blocked_bloom_filter class is an approximate set of hash values, which may report false positives but never false negatives.
+///   <para>All the bits of a given hash value lie within a single cache line sized block, hence a query touches a single cache line.</para>
+/// </summary>
+///
+/// <remarks>
+///   The hash values must be well spread, see mix_hash. Values cannot be removed, the filter is rebuilt instead.
+///   With the default of 16 bits per value, the false positive rate is about 0.1%.
+/// </remarks>
+///
+class blocked_bloom_filter final
+{
+public:
+   static constexpr std::size_t default_bits_per_value = 16;
+
+   ///
+   /// <summary>
+   ///   Constructs an empty filter.
+   /// </summary>
+   ///
+   /// <param name="expected_values">The number of values the filter is sized for.</param>
+   /// <param name="bits_per_value">The number of bits per expected value, the higher the fewer false positives.</param>
+   ///
+   explicit blocked_bloom_filter(std::size_t expected_values = 0,
+                                 std::size_t bits_per_value = default_bits_per_value)
+   {
+      const std::size_t bits = (expected_values > 0 ? expected_values : 1) * bits_per_value;
+
+      _blocks.resize((bits + block_bits - 1) / block_bits);
+   }
+
+   blocked_bloom_filter(const blocked_bloom_filter&) = default;
+   blocked_bloom_filter(blocked_bloom_filter&&) = default;
+
+   ~blocked_bloom_filter() = default;
+
+   blocked_bloom_filter& operator=(const blocked_bloom_filter&) = default;
+   blocked_bloom_filter& operator=(blocked_bloom_filter&&) = default;
+
+   ///
+   /// <summary>
+   ///   Adds a hash value.
+   /// </summary>
+   ///
+   void insert(std::uint64_t hash) noexcept
+   {
+      auto& words = block_of(hash).words;
+
+      for (std::size_t i = 0; i < words.size(); ++i)
+      {
+         words[i] |= bit_of(hash, i);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if a hash value may have been added.
+   /// </summary>
+   ///
+   /// <returns>false when the hash value was certainly never added.</returns>
+   ///
+   bool may_contain(std::uint64_t hash) const noexcept
+   {
+      const auto& words = block_of(hash).words;
+
+      std::uint64_t missing = 0;
+
+      for (std::size_t i = 0; i < words.size(); ++i)
+      {
+         missing |= bit_of(hash, i) & ~words[i];
+      }
+
+      return missing == 0;
+   }
+
+   ///
+   /// <summary>
+   ///   Removes all the hash values.
+   /// </summary>
+   ///
+   void clear() noexcept
+   {
+      for (auto& block : _blocks)
+      {
+         block.words.fill(0);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Get the size of the filter, in bytes.
+   /// </summary>
+   ///
+   std::size_t memory_size() const noexcept
+   {
+      return _blocks.size() * sizeof(block);
+   }
+
+   ///
+   /// <summary>
+   ///   Swaps the contents with another reference.
+   /// </summary>
+   ///
+   /// <param name="other">The reference to swap contents with.</param>
+   ///
+   void swap(blocked_bloom_filter& other) noexcept
+   {
+      _blocks.swap(other._blocks);
+   }
+
+private:
+   struct alignas(64) block
+   {
+      std::array<std::uint64_t, 8> words{};
+   };
+
+   static constexpr std::size_t block_bits = sizeof(block) * 8;
+
+   ///
+   /// <summary>
+   ///   The high half of the hash value selects the block, without a division.
+   /// </summary>
+   ///
+   const block& block_of(std::uint64_t hash) const noexcept
+   {
+      return _blocks[static_cast<std::size_t>(((hash >> 32) * _blocks.size()) >> 32)];
+   }
+
+   block& block_of(std::uint64_t hash) noexcept
+   {
+      return _blocks[static_cast<std::size_t>(((hash >> 32) * _blocks.size()) >> 32)];
+   }
+
+   ///
+   /// <summary>
+   ///   The low half of the hash value, multiplied by a different odd salt per word, selects one bit in each word.
+   /// </summary>
+   ///
+   static std::uint64_t bit_of(std::uint64_t hash,
+                               std::size_t word) noexcept
+   {
+      static constexpr std::array<std::uint32_t, 8> salts = { 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                              0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+
+      const auto low = static_cast<std::uint32_t>(hash);
+
+      return std::uint64_t{1} << ((low * salts[word]) >> 26);
+   }
+
+   std::vector<block> _blocks;
+};
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include "factory.h"
+#include "hashing.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The counters of the lookups made by the calling thread through the caches of the cached_key_class_factory instances.
+/// </summary>
+///
+struct key_cache_statistics
+{
+   std::uint64_t hits   = 0;   // Lookups resolved by the cache of the thread.
+   std::uint64_t misses = 0;   // Lookups that went to the registry.
+
+   double hit_rate() const noexcept
+   {
+      const auto lookups = hits + misses;
+
+      return (lookups > 0)
+             ? static_cast<double>(hits) / static_cast<double>(lookups)
+             : 0.0;
+   }
+};
+
+///
+/// <summary>
+///   The cached_key_class_factory class is a key_class_factory with a per-thread cache in front of its registry.
+///   <para>Each thread has a small direct-mapped cache of the entries of the registry, indexed by the hash value of the
+///   key. Hence a thread that keeps on constructing with the same few keys mostly skips the shared hash table.</para>
+///   <para>Any change to the registrations bumps a generation counter, which invalidates the cached entries of every
+///   thread at once, without visiting them.</para>
+/// </summary>
+///
+/// <remarks>
+///   A cache slot records the factory, the generation, the hash value and a pointer to the entry of the registry. The
+///   key of the entry is compared on a hit, hence colliding keys cannot be confused. As with key_class_factory, the
+///   registrations must not change while other threads construct.
+///   A key is hashed once, for the cache and, on a miss, for the registry. A caller that constructs with the same keys
+///   again and again hashes them once and for all with make_hashed_key, hence a hit only costs the load of a slot and
+///   the comparison of the key, see bench_cached_factory.
+/// </remarks>
+///
+/// <seealso cref="key_class_factory"/>
+///
+template<class key_t, class... functions_t>
+class cached_key_class_factory final
+{
+public:
+   typedef key_t key_type;
+   using function_types = std::tuple<functions_t...>;
+   typedef key_delegates_functions<key_type, functions_t...> key_delegates_type;
+   typedef typename key_delegates_type::delegate_type delegate_type;
+
+   static constexpr std::size_t cache_size = 64;
+
+   cached_key_class_factory()
+   : _id(next_id().fetch_add(1, std::memory_order_relaxed))
+   {
+   }
+
+   cached_key_class_factory(const cached_key_class_factory&) = delete;
+   cached_key_class_factory(cached_key_class_factory&&) = delete;
+
+   ~cached_key_class_factory() = default;
+
+   cached_key_class_factory& operator=(const cached_key_class_factory&) = delete;
+   cached_key_class_factory& operator=(cached_key_class_factory&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Registers all the delegate under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   void register_delegate(const key_type& key,
+                          const delegate_type& delegate)
+   {
+      _delegates.register_delegate(key, delegate);
+      invalidate();
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the functions under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with these function signatures.</param>
+   /// <param name="functions">The functions that are to be registered.</param>
+   ///
+   void register_functions(const key_type& key,
+                           function_types functions)
+   {
+      _delegates.register_functions(key, std::move(functions));
+      invalidate();
+   }
+
+   ///
+   /// <summary>
+   ///   Registers a single function under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with this function.</param>
+   /// <param name="function">The function that is to be registered.</param>
+   ///
+   template<class function_t>
+   void register_function(const key_type& key,
+                          function_t function)
+   {
+      _delegates.register_function(key, std::move(function));
+      invalidate();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters all the functions that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   void unregister_delegate(const key_type& key)
+   {
+      _delegates.unregister_delegate(key);
+      invalidate();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<class function_t>
+   void unregister_function(const key_type& key)
+   {
+      _delegates.template unregister_function<function_t>(key);
+      invalidate();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<int index_t>
+   void unregister_function(const key_type& key)
+   {
+      _delegates.template unregister_function<index_t>(key);
+      invalidate();
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class function_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const -> typename function_t::result_type
+   {
+      return construct<function_t>(make_hashed_key(key), std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, with a key whose hash value was already computed.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class function_t, class... args_t>
+   auto construct(const hashed_key<key_type>& key,
+                  args_t&&... args) const -> typename function_t::result_type
+   {
+      const auto* entry = lookup(key);
+
+      if (entry == nullptr)
+      {
+         return nullptr;
+      }
+
+      const auto& function = entry->second.template get_function<function_t>();
+
+      return (function)
+             ? function(std::forward<args_t>(args)...)
+             : nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<int index_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const
+   {
+      return construct<index_t>(make_hashed_key(key), std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, with a key whose hash value was already computed.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<int index_t, class... args_t>
+   auto construct(const hashed_key<key_type>& key,
+                  args_t&&... args) const
+   {
+      using result_type = decltype(std::declval<const delegate_type&>().template get_function<index_t>()(std::forward<args_t>(args)...));
+
+      const auto* entry = lookup(key);
+
+      if (entry == nullptr)
+      {
+         return result_type(nullptr);
+      }
+
+      const auto& function = entry->second.template get_function<index_t>();
+
+      return (function)
+             ? function(std::forward<args_t>(args)...)
+             : result_type(nullptr);
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is registered.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for.</param>
+   ///
+   bool contains(const key_type& key) const
+   {
+      return lookup(make_hashed_key(key)) != nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of registered keys.
+   /// </summary>
+   ///
+   std::size_t size() const noexcept
+   {
+      return _delegates.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Get the generation of the registrations, which is bumped by any change to them.
+   /// </summary>
+   ///
+   std::uint64_t generation() const noexcept
+   {
+      return _generation.load(std::memory_order_acquire);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the counters of the lookups made by the calling thread, through all the instances of this factory type.
+   /// </summary>
+   ///
+   static key_cache_statistics thread_statistics() noexcept
+   {
+      return counters();
+   }
+
+private:
+   typedef typename key_delegates_type::delegates_type::value_type entry_type;
+
+   struct slot
+   {
+      std::uint64_t     owner      = 0;   // The identifier of the factory, 0 for an empty slot.
+      std::uint64_t     generation = 0;
+      std::uint64_t     hash       = 0;
+      const entry_type* entry      = nullptr;
+   };
+
+   static std::atomic<std::uint64_t>& next_id() noexcept
+   {
+      // Identifiers aren't reused, unlike addresses, hence the slots of a destroyed factory never match a new one.
+      static std::atomic<std::uint64_t> id{1};
+
+      return id;
+   }
+
+   static std::array<slot, cache_size>& cache() noexcept
+   {
+      thread_local std::array<slot, cache_size> slots{};
+
+      return slots;
+   }
+
+   static key_cache_statistics& counters() noexcept
+   {
+      thread_local key_cache_statistics statistics;
+
+      return statistics;
+   }
+
+   void invalidate() noexcept
+   {
+      _generation.fetch_add(1, std::memory_order_acq_rel);
+   }
+
+   const entry_type* lookup(const hashed_key<key_type>& key) const
+   {
+      const auto generation = _generation.load(std::memory_order_acquire);
+
+      auto& cached = cache()[key.hash % cache_size];
+
+      if (cached.owner == _id && cached.generation == generation && cached.hash == key.hash && cached.entry->first == key.key)
+      {
+         ++counters().hits;
+         return cached.entry;
+      }
+
+      ++counters().misses;
+
+      const auto* entry = _delegates.get_entry(key);
+
+      if (entry != nullptr)
+      {
+         cached = slot{ _id, generation, key.hash, entry };
+      }
+
+      return entry;
+   }
+
+   key_delegates_type         _delegates;
+   std::uint64_t              _id;
+   std::atomic<std::uint64_t> _generation{0};
+};
+}
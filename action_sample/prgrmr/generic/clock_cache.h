@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The clock_cache class is a map of a bounded number of entries, which evicts with the CLOCK policy once it is full.
+///   <para>Each entry has a reference bit that is set when it is found. Once the cache is full, a hand sweeps over the
+///   entries clearing the bits that are set, and evicts the first entry whose bit is clear.</para>
+/// </summary>
+///
+/// <remarks>
+///   CLOCK approximates least-recently-used eviction, without reordering a list on every lookup.
+///   An entry that is inserted but never found again is the first to be evicted.
+/// </remarks>
+///
+template<class key_t, class value_t, class hash_t = std::hash<key_t>, class equal_t = std::equal_to<key_t>>
+class clock_cache final
+{
+public:
+   typedef key_t key_type;
+   typedef value_t value_type;
+
+   explicit clock_cache(std::size_t capacity = 0)
+   : _capacity(capacity)
+   {
+      _index.reserve(capacity);
+      _slots.reserve(capacity);
+   }
+
+   clock_cache(const clock_cache&) = delete;
+   clock_cache(clock_cache&&) = default;
+
+   ~clock_cache() = default;
+
+   clock_cache& operator=(const clock_cache&) = delete;
+   clock_cache& operator=(clock_cache&&) = default;
+
+   ///
+   /// <summary>
+   ///   Finds the value of a key, and marks it as referenced.
+   /// </summary>
+   ///
+   /// <returns>nullptr when the key isn't cached.</returns>
+   ///
+   value_type* find(const key_type& key)
+   {
+      const auto iter = _index.find(key);
+
+      if (iter == std::end(_index))
+      {
+         return nullptr;
+      }
+
+      iter->second.referenced = true;
+      return std::addressof(iter->second.value);
+   }
+
+   ///
+   /// <summary>
+   ///   Inserts the value of a key, or replaces it when the key is already cached.
+   /// </summary>
+   ///
+   /// <returns>true when another entry was evicted to make room.</returns>
+   ///
+   bool insert(key_type key,
+               value_type value)
+   {
+      const auto iter = _index.find(key);
+
+      if (iter != std::end(_index))
+      {
+         iter->second.value = std::move(value);
+         return false;
+      }
+
+      if (_capacity == 0)
+      {
+         return false;
+      }
+
+      if (_slots.size() < _capacity)
+      {
+         _slots.push_back(std::addressof(*_index.emplace(std::move(key), entry{std::move(value)}).first));
+         return false;
+      }
+
+      while (_slots[_hand]->second.referenced)
+      {
+         _slots[_hand]->second.referenced = false;
+         advance();
+      }
+
+      _index.erase(_slots[_hand]->first);
+      _slots[_hand] = std::addressof(*_index.emplace(std::move(key), entry{std::move(value)}).first);
+      advance();
+
+      return true;
+   }
+
+   ///
+   /// <summary>
+   ///   Removes all the entries.
+   /// </summary>
+   ///
+   void clear()
+   {
+      _slots.clear();
+      _index.clear();
+      _hand = 0;
+   }
+
+   std::size_t size() const noexcept
+   {
+      return _slots.size();
+   }
+
+   std::size_t capacity() const noexcept
+   {
+      return _capacity;
+   }
+
+private:
+   struct entry
+   {
+      value_type value;
+      bool       referenced = false;
+   };
+
+   typedef std::unordered_map<key_type, entry, hash_t, equal_t> index_type;
+
+   void advance() noexcept
+   {
+      _hand = (_hand + 1 < _capacity) ? _hand + 1 : 0;
+   }
+
+   std::size_t _capacity;
+   std::size_t _hand = 0;
+   index_type  _index;
+
+   // The nodes of an unordered_map don't move when it rehashes, hence the slots may point to them.
+   std::vector<typename index_type::value_type*> _slots;
+};
+}
@@ -0,0 +1,574 @@
+#pragma once
+
+#include "factory.h"
+#include "function_traits.h"
+#include "hashing.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The compact_key_class_factory class is a key_class_factory that shares identical sets of constructors between keys.
+///   <para>Each key holds only a presence bitmask of its signatures, and the index of its set in a table of constructor sets.</para>
+///   <para>Keys registering the same function pointers for every signature share a single set, hence a single copy of the functions.</para>
+/// </summary>
+///
+/// <remarks>
+///   Only function pointers can be told apart, hence a set holding any other callable, such as a lambda with captures,
+///   is never shared. The sets are reference counted; their slots are reused once released.
+///   Looking up whether a key has a signature reads the bitmask of the key, without touching its set.
+/// </remarks>
+///
+/// <seealso cref="key_class_factory"/>
+///
+template<class key_t, class... functions_t>
+class compact_key_class_factory final
+{
+public:
+   typedef key_t key_type;
+   using function_types = std::tuple<functions_t...>;
+   typedef delegate_functions<functions_t...> delegate_type;
+
+   static_assert(sizeof...(functions_t) <= 64, "A compact factory supports up to 64 signatures.");
+
+   ///
+   /// <summary>
+   ///   The smallest unsigned integer with one bit per signature.
+   /// </summary>
+   ///
+   using mask_type = std::conditional_t<(sizeof...(functions_t) <= 8),  std::uint8_t,
+                     std::conditional_t<(sizeof...(functions_t) <= 16), std::uint16_t,
+                     std::conditional_t<(sizeof...(functions_t) <= 32), std::uint32_t,
+                                                                        std::uint64_t>>>;
+
+   compact_key_class_factory() = default;
+   compact_key_class_factory(const compact_key_class_factory&) = default;
+   compact_key_class_factory(compact_key_class_factory&&) = default;
+
+   ~compact_key_class_factory() = default;
+
+   compact_key_class_factory& operator=(const compact_key_class_factory&) = default;
+   compact_key_class_factory& operator=(compact_key_class_factory&&) = default;
+
+   ///
+   /// <summary>
+   ///   Registers all the delegate under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   /// <remarks>As in the key_class_factory, a key that is already registered keeps its functions.</remarks>
+   ///
+   void register_delegate(const key_type& key,
+                          const delegate_type& delegate)
+   {
+      if (_entries.find(key) != std::end(_entries))
+      {
+         return;
+      }
+
+      const auto set = acquire(delegate);
+
+      _entries.emplace(key, entry{ set, mask_of(delegate) });
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the functions under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with these function signatures.</param>
+   /// <param name="functions">The functions that are to be registered.</param>
+   ///
+   void register_functions(const key_type& key,
+                           function_types functions)
+   {
+      register_delegate(key, delegate_type(std::move(functions)));
+   }
+
+   ///
+   /// <summary>
+   ///   Registers a single function under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with this function.</param>
+   /// <param name="function">The function that is to be registered.</param>
+   ///
+   /// <remarks>The key moves to the set that holds its functions along with the new one, which may be shared.</remarks>
+   ///
+   template<class function_t>
+   void register_function(const key_type& key,
+                          function_t function)
+   {
+      update(key, [&function](delegate_type& delegate) { delegate.register_function(std::move(function)); });
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters all the functions that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   void unregister_delegate(const key_type& key)
+   {
+      const auto iter = _entries.find(key);
+
+      if (iter != std::end(_entries))
+      {
+         release(iter->second.set);
+         _entries.erase(iter);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   /// <remarks>The key remains registered, as it does in the key_class_factory.</remarks>
+   ///
+   template<class function_t>
+   void unregister_function(const key_type& key)
+   {
+      if (contains(key))
+      {
+         update(key, [](delegate_type& delegate) { delegate.template unregister_function<function_t>(); });
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   /// <remarks>The key remains registered, as it does in the key_class_factory.</remarks>
+   ///
+   template<int index_t>
+   void unregister_function(const key_type& key)
+   {
+      if (contains(key))
+      {
+         update(key, [](delegate_type& delegate) { delegate.template unregister_function<index_t>(); });
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if a function with the given signature is registered under the given key.
+   /// </summary>
+   ///
+   /// <remarks>It reads the bitmask of the key only, hence no function is copied nor touched.</remarks>
+   ///
+   template<class function_t>
+   bool has_constructor(const key_type& key) const
+   {
+      return has_constructor<static_cast<int>(index_of<function_t>())>(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if a function with the given index position is registered under the given key.
+   /// </summary>
+   ///
+   template<int index_t>
+   bool has_constructor(const key_type& key) const
+   {
+      static_assert(index_t >= 0 && index_t < static_cast<int>(sizeof...(functions_t)), "The index is out of range.");
+
+      const auto iter = _entries.find(key);
+
+      return (iter != std::end(_entries))
+             && (iter->second.mask & bit_of(static_cast<std::size_t>(index_t))) != 0;
+   }
+
+   ///
+   /// <summary>
+   ///   Get a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <returns>A copy of the function object.<returns>
+   /// <returns>An empty function when the given key cannot be found.<returns>
+   ///
+   template<class function_t>
+   auto get_function(const key_type& key) const
+   {
+      return get_function<static_cast<int>(index_of<function_t>())>(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Get a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <returns>A copy of the function object.<returns>
+   /// <returns>An empty function when the given key cannot be found.<returns>
+   ///
+   template<int index_t>
+   auto get_function(const key_type& key) const
+   {
+      const auto* delegate = find_delegate(key);
+
+      return (delegate != nullptr)
+             ? delegate->template get_function<index_t>()
+             : std::tuple_element_t<index_t, function_types>();
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class function_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const -> typename function_t::result_type
+   {
+      return construct<static_cast<int>(index_of<function_t>())>(key, std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<int index_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const
+   {
+      using result_type = function_result_t<std::tuple_element_t<index_t, function_types>>;
+
+      const auto iter = _entries.find(key);
+
+      if (iter == std::end(_entries) || (iter->second.mask & bit_of(static_cast<std::size_t>(index_t))) == 0)
+      {
+         return result_type(nullptr);
+      }
+
+      return _sets[iter->second.set].delegate.template get_function<index_t>()(std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is registered.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for.</param>
+   ///
+   bool contains(const key_type& key) const
+   {
+      return _entries.find(key) != std::end(_entries);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of registered keys.
+   /// </summary>
+   ///
+   std::size_t size() const noexcept
+   {
+      return _entries.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of distinct sets of constructors that the keys refer to.
+   /// </summary>
+   ///
+   std::size_t set_count() const noexcept
+   {
+      return _sets.size() - _free.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Reserves room for the given number of keys.
+   /// </summary>
+   ///
+   void reserve(std::size_t count)
+   {
+      _entries.reserve(count);
+   }
+
+   ///
+   /// <summary>
+   ///   Invokes a function with each registered key, in no particular order.
+   /// </summary>
+   ///
+   /// <param name="function">The function that is invoked with a const reference to each key. It must not change the factory.</param>
+   ///
+   template<class function_t>
+   void for_each_key(function_t&& function) const
+   {
+      for (const auto& [key, value] : _entries)
+      {
+         function(key);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Swaps the contents with another reference.
+   /// </summary>
+   ///
+   /// <param name="other">The reference to swap contents with.</param>
+   ///
+   void swap(compact_key_class_factory& other) noexcept
+   {
+      _entries.swap(other._entries);
+      _sets.swap(other._sets);
+      _free.swap(other._free);
+      _shared.swap(other._shared);
+   }
+
+private:
+   static constexpr std::size_t function_count = sizeof...(functions_t);
+
+   ///
+   /// <summary>
+   ///   The address of each function pointer of a set, or zero for the empty ones.
+   /// </summary>
+   ///
+   typedef std::array<std::uintptr_t, function_count> identity_type;
+
+   struct entry
+   {
+      std::uint32_t set;
+      mask_type     mask;
+   };
+
+   struct constructor_set
+   {
+      delegate_type delegate;
+      identity_type identity{};
+      std::size_t   references = 0;
+      bool          shared     = false;
+   };
+
+   struct identity_hash
+   {
+      std::size_t operator()(const identity_type& identity) const noexcept
+      {
+         std::uint64_t seed = 0;
+
+         for (const auto address : identity)
+         {
+            seed = combine_hash(seed, mix_hash(static_cast<std::uint64_t>(address)));
+         }
+
+         return static_cast<std::size_t>(seed);
+      }
+   };
+
+   template<class function_t>
+   static constexpr std::size_t index_of()
+   {
+      constexpr std::array<bool, function_count> matches = { std::is_same_v<function_t, functions_t>... };
+
+      for (std::size_t i = 0; i < matches.size(); ++i)
+      {
+         if (matches[i])
+         {
+            return i;
+         }
+      }
+
+      return matches.size();
+   }
+
+   static constexpr mask_type bit_of(std::size_t index) noexcept
+   {
+      return static_cast<mask_type>(mask_type(1) << index);
+   }
+
+   static mask_type mask_of(const delegate_type& delegate)
+   {
+      return mask_of(delegate, std::index_sequence_for<functions_t...>{});
+   }
+
+   template<std::size_t... indexes_t>
+   static mask_type mask_of(const delegate_type& delegate,
+                            std::index_sequence<indexes_t...>)
+   {
+      mask_type mask = 0;
+
+      ((mask |= static_cast<bool>(delegate.template get_function<static_cast<int>(indexes_t)>()) ? bit_of(indexes_t) : 0), ...);
+
+      return mask;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the address of the function pointer held by a function.
+   /// </summary>
+   ///
+   /// <returns>false when the function holds any other callable, which then cannot be compared.</returns>
+   ///
+   template<class function_t>
+   static bool identify(const function_t& function,
+                        std::uintptr_t& address)
+   {
+      if (!function)
+      {
+         address = 0;
+         return true;
+      }
+
+      const auto* pointer = function.template target<typename function_traits<function_t>::pointer_type>();
+
+      if (pointer == nullptr)
+      {
+         return false;
+      }
+
+      address = reinterpret_cast<std::uintptr_t>(*pointer);
+      return true;
+   }
+
+   template<std::size_t... indexes_t>
+   static bool identify(const delegate_type& delegate,
+                        identity_type& identity,
+                        std::index_sequence<indexes_t...>)
+   {
+      return (identify(delegate.template get_function<static_cast<int>(indexes_t)>(), identity[indexes_t]) && ...);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the set that holds the functions of the delegate, adding one unless an identical set is shared.
+   /// </summary>
+   ///
+   std::uint32_t acquire(const delegate_type& delegate)
+   {
+      identity_type identity{};
+
+      const bool shareable = identify(delegate, identity, std::index_sequence_for<functions_t...>{});
+
+      if (shareable)
+      {
+         const auto found = _shared.find(identity);
+
+         if (found != std::end(_shared))
+         {
+            ++_sets[found->second].references;
+            return found->second;
+         }
+      }
+
+      std::uint32_t set;
+
+      if (_free.empty())
+      {
+         set = static_cast<std::uint32_t>(_sets.size());
+         _sets.emplace_back();
+      }
+      else
+      {
+         set = _free.back();
+         _free.pop_back();
+      }
+
+      auto& slot = _sets[set];
+
+      slot.delegate   = delegate;
+      slot.identity   = identity;
+      slot.references = 1;
+      slot.shared     = shareable;
+
+      if (shareable)
+      {
+         _shared.emplace(identity, set);
+      }
+
+      return set;
+   }
+
+   void release(std::uint32_t set)
+   {
+      auto& slot = _sets[set];
+
+      if (--slot.references > 0)
+      {
+         return;
+      }
+
+      if (slot.shared)
+      {
+         _shared.erase(slot.identity);
+      }
+
+      slot = constructor_set{};
+      _free.push_back(set);
+   }
+
+   ///
+   /// <summary>
+   ///   Moves the key to the set of its functions once changed, registering the key when missing.
+   /// </summary>
+   ///
+   template<class change_t>
+   void update(const key_type& key,
+               change_t&& change)
+   {
+      const auto iter = _entries.find(key);
+
+      delegate_type delegate;
+
+      if (iter != std::end(_entries))
+      {
+         delegate = _sets[iter->second.set].delegate;
+      }
+
+      change(delegate);
+
+      const auto set = acquire(delegate);
+
+      if (iter != std::end(_entries))
+      {
+         release(iter->second.set);
+         iter->second = entry{ set, mask_of(delegate) };
+      }
+      else
+      {
+         _entries.emplace(key, entry{ set, mask_of(delegate) });
+      }
+   }
+
+   const delegate_type* find_delegate(const key_type& key) const
+   {
+      const auto iter = _entries.find(key);
+
+      return (iter != std::end(_entries))
+             ? std::addressof(_sets[iter->second.set].delegate)
+             : nullptr;
+   }
+
+   std::unordered_map<key_type, entry>                         _entries;
+   std::vector<constructor_set>                                _sets;
+   std::vector<std::uint32_t>                                  _free;     // Released sets, whose slots can be reused.
+   std::unordered_map<identity_type, std::uint32_t, identity_hash> _shared;   // The sets of function pointers, by their identity.
+};
+}
@@ -0,0 +1,680 @@
+#pragma once
+
+#include "hashing.h"
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   Declares the bound of the keys of an integral or an enum type: every key lies in [0, value).
+/// </summary>
+///
+/// <remarks>
+///   Specialize it with a static constexpr value for a key type, and the registries keyed by that type index their
+///   delegates by the key, instead of hashing it.
+///   <code>
+///   template&lt;&gt;
+///   struct prgrmr::generic::key_bound&lt;product_code&gt; { static constexpr std::size_t value = 512; };
+///   </code>
+/// </remarks>
+///
+template<class key_t>
+struct key_bound
+{
+};
+
+///
+/// Indicates if the keys of the type are integral or enum values with a declared bound.
+///
+template<class key_t>
+concept BoundedKey = (std::is_integral_v<key_t> || std::is_enum_v<key_t>)
+                  && !std::is_same_v<key_t, bool>
+                  && requires { { key_bound<key_t>::value } -> std::convertible_to<std::size_t>; };
+
+///
+/// <summary>
+///   The direct_index_map class is an associative container of bounded keys, which stores each value at the index of
+///   its key.
+///   <para>Up to dense_limit keys, the values lie in a single array, hence a lookup is a single indexed load. Beyond,
+///   the array is split in pages that are allocated when a key of their range is first inserted, hence a sparse use of
+///   a large range only pays for the pages it touches.</para>
+///   <para>It has the subset of the interface of std::unordered_map that the registries use, including its value_type,
+///   hence it can stand in for it.</para>
+/// </summary>
+///
+/// <remarks>
+///   Looking up a key out of the bound finds nothing, whereas inserting one throws std::out_of_range.
+///   The table of the pages grows with the largest key, hence a range that is too large even for pages, such as the
+///   whole range of a 64 bits key, shouldn't be declared with key_bound.
+///   The iteration is in the order of the keys, and references to the values remain valid until they are erased.
+///   The nodes hand the values over by swapping them, hence extract, insert and merge need a default constructible
+///   mapped type, but never copy it. So does emplace, given a value of a type that cannot be moved.
+/// </remarks>
+///
+/// <seealso cref="key_bound"/>
+///
+template<BoundedKey key_t, class mapped_t>
+class direct_index_map final
+{
+public:
+   typedef key_t key_type;
+   typedef mapped_t mapped_type;
+   typedef std::pair<const key_type, mapped_type> value_type;
+   typedef std::size_t size_type;
+
+   static constexpr std::size_t bound       = static_cast<std::size_t>(key_bound<key_type>::value);
+   static constexpr std::size_t dense_limit = 4096;
+   static constexpr std::size_t page_size   = 256;
+   static constexpr bool        is_dense    = (bound <= dense_limit);
+
+private:
+   typedef std::optional<value_type> slot_type;
+
+   template<bool const_t>
+   class basic_iterator final
+   {
+   public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef typename direct_index_map::value_type value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef std::conditional_t<const_t, const value_type*, value_type*> pointer;
+      typedef std::conditional_t<const_t, const value_type&, value_type&> reference;
+
+      typedef std::conditional_t<const_t, const direct_index_map*, direct_index_map*> owner_type;
+
+      basic_iterator() = default;
+
+      basic_iterator(owner_type owner,
+                     std::size_t index) noexcept
+      : _owner(owner),
+        _index(index)
+      {
+      }
+
+      template<bool other_t>
+         requires (const_t && !other_t)
+      basic_iterator(const basic_iterator<other_t>& other) noexcept
+      : _owner(other._owner),
+        _index(other._index)
+      {
+      }
+
+      reference operator*() const
+      {
+         return **_owner->slot_at(_index);
+      }
+
+      pointer operator->() const
+      {
+         return std::addressof(**_owner->slot_at(_index));
+      }
+
+      basic_iterator& operator++()
+      {
+         _index = _owner->next_occupied(_index + 1);
+         return *this;
+      }
+
+      basic_iterator operator++(int)
+      {
+         auto previous = *this;
+
+         ++(*this);
+         return previous;
+      }
+
+      friend bool operator==(const basic_iterator& left,
+                             const basic_iterator& right) noexcept
+      {
+         return left._index == right._index;
+      }
+
+   private:
+      template<bool>
+      friend class basic_iterator;
+
+      owner_type  _owner = nullptr;
+      std::size_t _index = bound;
+   };
+
+public:
+   typedef basic_iterator<false> iterator;
+   typedef basic_iterator<true> const_iterator;
+
+   ///
+   /// <summary>
+   ///   Owns a value that was extracted from a map, until it is inserted into a map.
+   /// </summary>
+   ///
+   class node_type final
+   {
+   public:
+      typedef typename direct_index_map::key_type key_type;
+      typedef typename direct_index_map::mapped_type mapped_type;
+
+      node_type() = default;
+      node_type(const node_type&) = delete;
+      node_type(node_type&&) noexcept = default;
+
+      ~node_type() = default;
+
+      node_type& operator=(const node_type&) = delete;
+      node_type& operator=(node_type&&) noexcept = default;
+
+      bool empty() const noexcept
+      {
+         return _value == nullptr;
+      }
+
+      explicit operator bool() const noexcept
+      {
+         return _value != nullptr;
+      }
+
+      const key_type& key() const noexcept
+      {
+         return _value->first;
+      }
+
+      mapped_type& mapped() const noexcept
+      {
+         return _value->second;
+      }
+
+   private:
+      friend class direct_index_map;
+
+      std::unique_ptr<value_type> _value;
+   };
+
+   struct insert_return_type
+   {
+      iterator  position;
+      bool      inserted = false;
+      node_type node;
+   };
+
+   direct_index_map() = default;
+   direct_index_map(const direct_index_map&) = default;
+   direct_index_map(direct_index_map&&) = default;
+
+   ~direct_index_map() = default;
+
+   direct_index_map& operator=(const direct_index_map& other)
+   {
+      // The keys of the values are const, hence the slots are copied rather than assigned.
+      direct_index_map copy(other);
+
+      swap(copy);
+      return *this;
+   }
+
+   direct_index_map& operator=(direct_index_map&&) = default;
+
+   iterator begin() noexcept
+   {
+      return iterator(this, next_occupied(0));
+   }
+
+   const_iterator begin() const noexcept
+   {
+      return const_iterator(this, next_occupied(0));
+   }
+
+   iterator end() noexcept
+   {
+      return iterator(this, bound);
+   }
+
+   const_iterator end() const noexcept
+   {
+      return const_iterator(this, bound);
+   }
+
+   ///
+   /// <summary>
+   ///   Inserts a value constructed from the given arguments, unless the key is already in the map.
+   /// </summary>
+   ///
+   /// <returns>The iterator to the value of the key, and whether it was inserted.</returns>
+   ///
+   /// <exception cref="std::out_of_range">When the key is out of the bound.</exception>
+   ///
+   template<class... args_t>
+   std::pair<iterator, bool> emplace(const key_type& key,
+                                     args_t&&... args)
+   {
+      const auto index = checked_index_of(key);
+      auto& slot = make_slot(index);
+
+      if (slot.has_value())
+      {
+         return { iterator(this, index), false };
+      }
+
+      if constexpr (is_handed_over<args_t...>)
+      {
+         // A value that cannot be moved, such as a delegate_functions, is swapped into a default constructed one.
+         slot.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+         (swap_mapped(slot->second, args), ...);
+      }
+      else
+      {
+         slot.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<args_t>(args)...));
+      }
+
+      ++_size;
+
+      return { iterator(this, index), true };
+   }
+
+   ///
+   /// <summary>
+   ///   Erases the value of the given key.
+   /// </summary>
+   ///
+   /// <returns>The number of values erased, 0 or 1.</returns>
+   ///
+   size_type erase(const key_type& key)
+   {
+      const auto index = index_of(key);
+      auto* slot = (index < bound) ? slot_at(index) : nullptr;
+
+      if (slot == nullptr || !slot->has_value())
+      {
+         return 0;
+      }
+
+      slot->reset();
+      --_size;
+
+      return 1;
+   }
+
+   ///
+   /// <summary>
+   ///   Removes the value of the given key from the map, and hands it over in a node.
+   /// </summary>
+   ///
+   /// <returns>An empty node when the key isn't in the map.</returns>
+   ///
+   node_type extract(const key_type& key)
+   {
+      node_type node;
+
+      const auto index = find_index(key);
+
+      if (index == bound)
+      {
+         return node;
+      }
+
+      auto& slot = *slot_at(index);
+
+      node._value = std::make_unique<value_type>(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+      swap_mapped(node._value->second, slot->second);
+      slot.reset();
+      --_size;
+
+      return node;
+   }
+
+   ///
+   /// <summary>
+   ///   Inserts the value of a node, unless its key is already in the map.
+   /// </summary>
+   ///
+   /// <returns>The position of the key, whether the value was inserted, and the node when it wasn't.</returns>
+   ///
+   /// <exception cref="std::out_of_range">When the key is out of the bound.</exception>
+   ///
+   insert_return_type insert(node_type&& node)
+   {
+      if (node.empty())
+      {
+         return { end(), false, node_type() };
+      }
+
+      const auto index = checked_index_of(node.key());
+      auto& slot = make_slot(index);
+
+      if (slot.has_value())
+      {
+         return { iterator(this, index), false, std::move(node) };
+      }
+
+      slot.emplace(std::piecewise_construct, std::forward_as_tuple(node.key()), std::forward_as_tuple());
+      swap_mapped(slot->second, node.mapped());
+      node._value.reset();
+      ++_size;
+
+      return { iterator(this, index), true, node_type() };
+   }
+
+   ///
+   /// <summary>
+   ///   Moves the values of the other map whose keys aren't in this map. The others remain in the other map.
+   /// </summary>
+   ///
+   void merge(direct_index_map& other)
+   {
+      for (auto index = other.next_occupied(0); index != bound; index = other.next_occupied(index + 1))
+      {
+         auto& theirs = *other.slot_at(index);
+         auto& mine   = make_slot(index);
+
+         if (mine.has_value())
+         {
+            continue;
+         }
+
+         mine.emplace(std::piecewise_construct, std::forward_as_tuple(theirs->first), std::forward_as_tuple());
+         swap_mapped(mine->second, theirs->second);
+         theirs.reset();
+         --other._size;
+         ++_size;
+      }
+   }
+
+   iterator find(const key_type& key) noexcept
+   {
+      return iterator(this, find_index(key));
+   }
+
+   const_iterator find(const key_type& key) const noexcept
+   {
+      return const_iterator(this, find_index(key));
+   }
+
+   bool contains(const key_type& key) const noexcept
+   {
+      return find_index(key) != bound;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the value of the given key, inserting a default constructed one when the key isn't in the map.
+   /// </summary>
+   ///
+   /// <exception cref="std::out_of_range">When the key is out of the bound.</exception>
+   ///
+   mapped_type& operator[](const key_type& key)
+   {
+      return emplace(key).first->second;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the value of the given key.
+   /// </summary>
+   ///
+   /// <exception cref="std::out_of_range">When the key isn't in the map.</exception>
+   ///
+   mapped_type& at(const key_type& key)
+   {
+      const auto index = find_index(key);
+
+      if (index == bound)
+      {
+         throw std::out_of_range("The key isn't in the direct_index_map.");
+      }
+
+      return (*slot_at(index))->second;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the value of the given key.
+   /// </summary>
+   ///
+   /// <exception cref="std::out_of_range">When the key isn't in the map.</exception>
+   ///
+   const mapped_type& at(const key_type& key) const
+   {
+      const auto index = find_index(key);
+
+      if (index == bound)
+      {
+         throw std::out_of_range("The key isn't in the direct_index_map.");
+      }
+
+      return (*slot_at(index))->second;
+   }
+
+   size_type size() const noexcept
+   {
+      return _size;
+   }
+
+   bool empty() const noexcept
+   {
+      return _size == 0;
+   }
+
+   ///
+   /// <summary>
+   ///   Allocates the array of a dense map up front. The pages of a sparse map are only allocated by the insertions.
+   /// </summary>
+   ///
+   void reserve(size_type)
+   {
+      if constexpr (is_dense)
+      {
+         if (_slots.empty())
+         {
+            _slots.resize(bound);
+         }
+      }
+   }
+
+   void clear() noexcept
+   {
+      _slots.clear();
+      _pages.clear();
+      _size = 0;
+   }
+
+   void swap(direct_index_map& other) noexcept
+   {
+      _slots.swap(other._slots);
+      _pages.swap(other._pages);
+      std::swap(_size, other._size);
+   }
+
+private:
+   ///
+   /// <summary>
+   ///   Indicates if the arguments are a single mapped value to hand over, whose type cannot be moved.
+   /// </summary>
+   ///
+   template<class... args_t>
+   static constexpr bool is_handed_over = sizeof...(args_t) == 1
+                                       && (std::is_same_v<args_t, mapped_type> && ...)
+                                       && !std::is_move_constructible_v<mapped_type>;
+
+   ///
+   /// <summary>
+   ///   Get the index of the key, which is out of the bound for a negative key.
+   /// </summary>
+   ///
+   static constexpr std::size_t index_of(const key_type& key) noexcept
+   {
+      using underlying_type = typename std::conditional_t<std::is_enum_v<key_type>,
+                                                          std::underlying_type<key_type>,
+                                                          std::type_identity<key_type>>::type;
+
+      const auto value = static_cast<underlying_type>(key);
+
+      if constexpr (std::is_signed_v<underlying_type>)
+      {
+         if (value < 0)
+         {
+            return bound;
+         }
+      }
+
+      const auto index = static_cast<std::make_unsigned_t<underlying_type>>(value);
+
+      return (index < bound) ? static_cast<std::size_t>(index) : bound;
+   }
+
+   ///
+   /// <summary>
+   ///   Values are handed over by swapping them with a default constructed one, hence a value that cannot be moved,
+   ///   such as a delegate_functions, needs only a swap member.
+   /// </summary>
+   ///
+   static void swap_mapped(mapped_type& left,
+                           mapped_type& right)
+   {
+      if constexpr (requires { left.swap(right); })
+      {
+         left.swap(right);
+      }
+      else
+      {
+         using std::swap;
+         swap(left, right);
+      }
+   }
+
+   static std::size_t checked_index_of(const key_type& key)
+   {
+      const auto index = index_of(key);
+
+      if (index == bound)
+      {
+         throw std::out_of_range("The key is out of the bound declared by key_bound.");
+      }
+
+      return index;
+   }
+
+   std::size_t find_index(const key_type& key) const noexcept
+   {
+      const auto index = index_of(key);
+
+      if (index == bound)
+      {
+         return bound;
+      }
+
+      const auto* slot = slot_at(index);
+
+      return (slot != nullptr && slot->has_value()) ? index : bound;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the slot at the index, or nullptr when its storage isn't allocated.
+   /// </summary>
+   ///
+   const slot_type* slot_at(std::size_t index) const noexcept
+   {
+      if constexpr (is_dense)
+      {
+         return _slots.empty() ? nullptr : std::addressof(_slots[index]);
+      }
+      else
+      {
+         const auto page = index / page_size;
+
+         return (page < _pages.size() && !_pages[page].empty()) ? std::addressof(_pages[page][index % page_size]) : nullptr;
+      }
+   }
+
+   slot_type* slot_at(std::size_t index) noexcept
+   {
+      return const_cast<slot_type*>(std::as_const(*this).slot_at(index));
+   }
+
+   slot_type& make_slot(std::size_t index)
+   {
+      if constexpr (is_dense)
+      {
+         reserve(bound);
+         return _slots[index];
+      }
+      else
+      {
+         // The table of the pages only grows up to the page of the largest key.
+         if (index / page_size >= _pages.size())
+         {
+            _pages.resize(index / page_size + 1);
+         }
+
+         auto& page = _pages[index / page_size];
+
+         if (page.empty())
+         {
+            page.resize(page_size);
+         }
+
+         return page[index % page_size];
+      }
+   }
+
+   std::size_t next_occupied(std::size_t index) const noexcept
+   {
+      const auto end = is_dense ? _slots.size() : _pages.size() * page_size;
+
+      while (index < end)
+      {
+         const auto* slot = slot_at(index);
+
+         if (slot == nullptr)
+         {
+            // The page is missing, hence so is the rest of its range.
+            index = (index / page_size + 1) * page_size;
+            continue;
+         }
+
+         if (slot->has_value())
+         {
+            return index;
+         }
+
+         ++index;
+      }
+
+      return bound;
+   }
+
+   std::vector<slot_type>              _slots;   // The values of a dense map.
+   std::vector<std::vector<slot_type>> _pages;   // The values of a sparse map, by page.
+   std::size_t                         _size = 0;
+};
+
+///
+/// <summary>
+///   Selects the map of the delegates of a registry: a direct_index_map for bounded keys, otherwise a std::unordered_map.
+/// </summary>
+///
+/// <remarks>The std::unordered_map hashes with key_hash, hence it also looks up a hashed_key without hashing it again.</remarks>
+///
+template<class key_t, class value_t>
+struct registry_map
+{
+   typedef std::unordered_map<key_t, value_t, key_hash<key_t>, key_equal<key_t>> type;
+};
+
+template<BoundedKey key_t, class value_t>
+struct registry_map<key_t, value_t>
+{
+   typedef direct_index_map<key_t, value_t> type;
+};
+
+template<class key_t, class value_t>
+using registry_map_t = typename registry_map<key_t, value_t>::type;
+}
@@ -2,11 +2,30 @@
 
 #include "../concepts/arguments.h"
 #include "../concepts/concepts.h"
+#include "direct_index_map.h"
+#include "function_traits.h"
+#include "hashing.h"
+#include "packed_arguments.h"
+#include "result.h"
+#include "signature_selection.h"
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <span>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+// The tracing header, and its clock and rings, are only compiled into the programs that trace.
+#if defined(PRGRMR_FACTORY_TRACING)
+#include "trace.h"
+#else
+#define PRGRMR_TRACE_FACTORY(operation, key, signature) static_cast<void>(0)
+#endif
 
 namespace prgrmr::generic
 {
@@ -39,8 +58,7 @@ concept do_functions_return_same_type =
 ///   <para>When there are many different functions, then they must return the same type.</para>
 /// </summary>
 ///
-/// <remarks>to do : add a compile-time check to ensure that each function returns the same type.</remarks>
-/// <remarks>to do : add a compile-time check to prevent multiple occurrences of the same function signature.</remarks>
+/// <remarks>It is a compile-time error for two functions to have the same signature, or to return different types.</remarks>
 ///
 /// 
 template<class... functions_t>
@@ -49,14 +67,16 @@ class delegate_functions final
 public:
    using functions_type = std::tuple<functions_t...>;
 
-   static_assert(concepts::arguments::IsNotEmpty<functions_t>, "The list of functions cannot be empty.");
+   static_assert(concepts::arguments::IsNotEmpty<functions_t...>, "The list of functions cannot be empty.");
 
-   static_assert(concepts::invocable::AreAllSameReturnType<functions_t>,
+   static_assert(concepts::invocable::AreAllSameReturnType<functions_t...>,
                  "At least one of the invocable functions doesn't produce the same return type.");
 
-   static_assert(concepts::invocable::AreAllDifferent<functions_t>,
+   static_assert(concepts::invocable::AreAllDifferent<functions_t...>,
                  "At least two invocable functions have the same signature.");
 
+   using result_type = function_result_t<std::tuple_element_t<0, functions_type>>;
+
    delegate_functions() = default;
    delegate_functions(const delegate_functions&) = default;
    delegate_functions(delegate_functions&&) = delete;
@@ -72,11 +92,11 @@ public:
       std::get<function_t>(_functions) = std::move(function);
    }
 
-   template<class function_t, class... functions_t>
-   delegate_functions(function_t&& function, functions_t&&... functions)
+   template<class function_t, class... others_t>
+   delegate_functions(function_t&& function, others_t&&... others)
    {
       std::get<function_t>(_functions) = std::move(function);
-      delegate_functions<function_t>(functions...);
+      delegate_functions<function_t>(others...);
    }
 
    /////
@@ -87,7 +107,7 @@ public:
    ///// <param name="functions">A container of all possible functions.</param>
    /////
    delegate_functions(functions_t&&... functions)
-   : _functions(build_functions_type(functions))
+   : _functions(std::move(functions)...)
    {
    }
 
@@ -110,10 +130,10 @@ public:
    ///
    /// <param name="functions">A container of all possible functions.</param>
    ///
-   //delegate_functions(const functions_type& functions)
-   //: _functions(functions)
-   //{
-   //}
+   delegate_functions(const functions_type& functions)
+   : _functions(functions)
+   {
+   }
 
    ///
    /// <summary>
@@ -122,10 +142,10 @@ public:
    ///
    /// <param name="functions">A container of all possible functions.</param>
    ///
-   //delegate_functions(functions_type&& functions)
-   //: _functions(functions)
-   //{
-   //}
+   delegate_functions(functions_type&& functions)
+   : _functions(std::move(functions))
+   {
+   }
 
    ///
    /// <summary>
@@ -214,7 +234,7 @@ public:
    template<class function_t>
    void register_fn(const std::function<function_t>& function)
    {
-      std::get<function_t>(_functions) = function.target<function_t*>();
+      std::get<function_t>(_functions) = function.template target<function_t*>();
    }
 
    ///
@@ -284,6 +304,63 @@ public:
       return get_function<index_t>()(std::forward<args_t>(args)...);
    }
 
+   ///
+   /// <summary>
+   ///   Invoke the function whose signature is the best match for the given arguments, selected at compile-time.
+   /// </summary>
+   ///
+   /// <param name="args">The arguments to pass to the function.</param>
+   ///
+   /// <remarks>
+   ///   A signature that takes exactly the argument types is preferred, otherwise the one that they convert to.
+   ///   It is a compile-time error when no signature matches, or when more than one matches equally well.
+   /// </remarks>
+   ///
+   /// <exception cref="std::bad_function_call">When the function has not been registered.</exception>
+   ///
+   template<class... args_t>
+      requires (!is_signature_named<functions_type, args_t...>)
+   decltype(auto) invoke(args_t&&... args)
+   {
+      using selection = best_signature<functions_type, args_t...>;
+
+      static_assert(selection::is_found, "None of the function signatures can be invoked with the given arguments.");
+      static_assert(!selection::is_found || selection::is_unique,
+                    "The given arguments match more than one function signature, name the signature instead.");
+
+      if constexpr (selection::is_found && selection::is_unique)
+      {
+         return invoke<static_cast<int>(selection::index)>(std::forward<args_t>(args)...);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Invoke a specific function by a tuple index that is only known at runtime.
+   /// </summary>
+   ///
+   /// <param name="index">The tuple index of the function, e.g. a signature id read from a message.</param>
+   /// <param name="args">The arguments of the function, as packed by pack_arguments.</param>
+   ///
+   /// <returns>The result of the function.</returns>
+   /// <returns>An empty result when the index is out of range, the function has not been registered, the size of the
+   ///          arguments doesn't match the signature, or the signature has arguments that cannot be packed.</returns>
+   ///
+   /// <remarks>
+   ///   The index selects an entry of a jump table generated at compile-time, one entry per signature, hence there isn't
+   ///   any branch per signature. The arguments are unpacked on the stack.
+   /// </remarks>
+   ///
+   result_type invoke_packed(std::size_t index,
+                             std::span<const std::byte> args) const
+   {
+      static constexpr auto invokers = make_packed_invokers(std::index_sequence_for<functions_t...>{});
+
+      return (index < invokers.size())
+             ? invokers[index](_functions, args)
+             : result_type{};
+   }
+
    ///
    /// <summary>
    ///   Swaps the contents with another reference.
@@ -296,7 +373,91 @@ public:
       _functions.swap(other._functions);
    }
 
+   ///
+   /// <summary>
+   ///   Indicates if at least one function is registered.
+   /// </summary>
+   ///
+   bool has_functions() const noexcept
+   {
+      return std::apply([](const auto&... functions) { return (static_cast<bool>(functions) || ...); }, _functions);
+   }
+
+   ///
+   /// <summary>
+   ///   Takes the functions of another delegate whose signatures aren't registered in this one.
+   /// </summary>
+   ///
+   /// <param name="other">The delegate to take the functions from, which keeps the ones that aren't taken.</param>
+   ///
+   /// <remarks>The functions are swapped, hence the callables aren't copied.</remarks>
+   ///
+   void take_missing_functions(delegate_functions& other) noexcept
+   {
+      take_missing_functions(other, std::index_sequence_for<functions_t...>{});
+   }
+
 private:
+   template<std::size_t... index_t>
+   void take_missing_functions(delegate_functions& other,
+                               std::index_sequence<index_t...>) noexcept
+   {
+      (take_missing_function<index_t>(other), ...);
+   }
+
+   template<std::size_t index_t>
+   void take_missing_function(delegate_functions& other) noexcept
+   {
+      auto& mine   = std::get<index_t>(_functions);
+      auto& theirs = std::get<index_t>(other._functions);
+
+      if (!mine && theirs)
+      {
+         mine.swap(theirs);
+      }
+   }
+
+   typedef result_type (*packed_invoker)(const functions_type&, std::span<const std::byte>);
+
+   template<std::size_t index_t>
+   static result_type invoke_packed_at(const functions_type& functions,
+                                       std::span<const std::byte> args)
+   {
+      using function_type = std::tuple_element_t<index_t, functions_type>;
+      using traits        = function_traits<function_type>;
+
+      return invoke_unpacked<traits>(std::get<index_t>(functions), args,
+                                     std::make_index_sequence<traits::arity>{});
+   }
+
+   template<class traits_t, class function_t, std::size_t... index_t>
+   static result_type invoke_unpacked(const function_t& function,
+                                      std::span<const std::byte> args,
+                                      std::index_sequence<index_t...>)
+   {
+      using argument_types = typename traits_t::decayed_argument_types;
+
+      if constexpr (!are_packable<std::tuple_element_t<index_t, argument_types>...>)
+      {
+         return result_type{};
+      }
+      else
+      {
+         if (!function || args.size() != packed_size<std::tuple_element_t<index_t, argument_types>...>)
+         {
+            return result_type{};
+         }
+
+         return std::apply(function, unpack_arguments<std::tuple_element_t<index_t, argument_types>...>(args));
+      }
+   }
+
+   template<std::size_t... index_t>
+   static constexpr std::array<packed_invoker, sizeof...(index_t)> make_packed_invokers(std::index_sequence<index_t...>)
+   {
+      return { &invoke_packed_at<index_t>... };
+   }
+
    functions_type _functions;
 };
 
@@ -304,11 +465,26 @@ private:
 // how to ensure that all variadic functions are unique?
 
 
+///
+/// <summary>
+///   How a registry resolves a key that is registered in it, and in the registry whose entries it takes.
+/// </summary>
+///
+enum class conflict_policy
+{
+   keep_existing,   // The entry of the registry is kept, and the other one is left where it was.
+   replace,         // The other entry replaces the one of the registry, which takes its place.
+   combine,         // The registry takes the functions of the other entry whose signatures it doesn't register.
+   reject           // Throws std::invalid_argument, before any entry is taken.
+};
+
 ///
 /// <summary>
 ///   The key_delegates_functions class allows to register a collection of delegate functions.
 ///   <para>Each delegate is identified by a unique key identifier.</para>
 ///   <para>When a delegate is found, it is then possible to invoke the corresponding function that matches the given function signature.</para>
+///   <para>The delegates of integral or enum keys with a bound declared by key_bound are indexed by the key, in a
+///   direct_index_map; any other key is hashed into a std::unordered_map.</para>
 /// </summary>
 ///
 template<class key_t, class... functions_t>
@@ -318,7 +494,8 @@ public:
    typedef key_t key_type;
    using function_types = std::tuple<functions_t...>;
    typedef delegate_functions<functions_t...> delegate_type;
-   typedef std::unordered_map<key_type, delegate_type> delegates_type;
+   typedef registry_map_t<key_type, delegate_type> delegates_type;
+   typedef typename delegates_type::node_type node_type;
 
    key_delegates_functions() = default;
    key_delegates_functions(const key_delegates_functions&) = default;
@@ -408,7 +585,7 @@ public:
    void register_function(const key_type& key,
                           function_t function)
    {
-      _delegates[key].register_function<index_t>(std::move(function));
+      _delegates[key].template register_function<index_t>(std::move(function));
    }
 
    ///
@@ -425,7 +602,7 @@ public:
 
       if (iter != std::end(_delegates))
       {
-          iter->second.unregister_function<function_t>();
+          iter->second.template unregister_function<function_t>();
       }
    }
 
@@ -443,7 +620,7 @@ public:
 
       if (iter != std::end(_delegates))
       {
-         iter->second.unregister_function<index_t>();
+         iter->second.template unregister_function<index_t>();
       }
    }
 
@@ -480,6 +657,22 @@ public:
            : nullptr;
    }
 
+   ///
+   /// <summary>
+   ///   Get the delegate registered under the given key, whose hash value was already computed.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under, with its hash value.</param>
+   ///
+   const delegate_type* get_delegate(const hashed_key<key_type>& key) const
+   {
+      const auto& iter = find(key);
+
+      return (iter != std::end(_delegates))
+           ? std::addressof(iter->second)
+           : nullptr;
+   }
+
    ///
    /// <summary>
    ///   Get a specific function by its signature that was registered under the given key.
@@ -493,8 +686,8 @@ public:
       const auto& iter = _delegates.find(key);
 
       return (iter != std::end(_delegates))
-             ? iter->second.get_function<function_t>()
-             : decltype(iter->second.get_function<function_t>())(nullptr);
+             ? iter->second.template get_function<function_t>()
+             : decltype(iter->second.template get_function<function_t>())(nullptr);
    }
 
    ///
@@ -510,8 +703,8 @@ public:
       const auto& iter = _delegates.find(key);
 
       return (iter != std::end(_delegates))
-             ? iter->second.get_function<index_t>()
-             : decltype(iter->second.get_function<index_t>())(nullptr);
+             ? iter->second.template get_function<index_t>()
+             : decltype(iter->second.template get_function<index_t>())(nullptr);
    }
 
    ///
@@ -530,7 +723,7 @@ public:
    decltype(auto) invoke(const key_type& key,
                          args_t&&... args) const
    {
-      return at(key).invoke<function_t>(std::move(args));
+      return at(key).template invoke<function_t>(std::forward<args_t>(args)...);
    }
 
    ///
@@ -549,7 +742,212 @@ public:
    decltype(auto) invoke(const key_type& key,
                          args_t&&... args) const
    {
-      return at(key).invoke<index_t>(std::move(args));
+      return at(key).template invoke<index_t>(std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the registered key together with its delegate.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   /// <returns>A pointer to the entry, which remains valid until the key is unregistered.</returns>
+   /// <returns>nullptr when the given key cannot be found.</returns>
+   ///
+   const typename delegates_type::value_type* get_entry(const key_type& key) const
+   {
+      const auto& iter = _delegates.find(key);
+
+      return (iter != std::end(_delegates))
+             ? std::addressof(*iter)
+             : nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the entry of the given key, whose hash value was already computed.
+   /// </summary>
+   ///
+   /// <see cref="get_entry"/>
+   ///
+   const typename delegates_type::value_type* get_entry(const hashed_key<key_type>& key) const
+   {
+      const auto& iter = find(key);
+
+      return (iter != std::end(_delegates))
+             ? std::addressof(*iter)
+             : nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if a delegate is registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for.</param>
+   ///
+   bool contains(const key_type& key) const
+   {
+      return _delegates.find(key) != std::end(_delegates);
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if a delegate is registered under the given key, whose hash value was already computed.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for, with its hash value.</param>
+   ///
+   bool contains(const hashed_key<key_type>& key) const
+   {
+      return find(key) != std::end(_delegates);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of keys that have a registered delegate.
+   /// </summary>
+   ///
+   std::size_t size() const noexcept
+   {
+      return _delegates.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Reserves room for the given number of keys, so that registering that many keys doesn't rehash.
+   /// </summary>
+   ///
+   void reserve(std::size_t count)
+   {
+      _delegates.reserve(count);
+   }
+
+   ///
+   /// <summary>
+   ///   Invokes a function with each key that has a registered delegate, in no particular order.
+   /// </summary>
+   ///
+   /// <param name="function">The function that is invoked with a const reference to each key.</param>
+   ///
+   template<class function_t>
+   void for_each_key(function_t&& function) const
+   {
+      for (const auto& entry : _delegates)
+      {
+         function(entry.first);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Removes the entry of the given key, and hands it over in a node that can be inserted into another registry.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   /// <returns>An empty node when the given key cannot be found.</returns>
+   ///
+   node_type extract(const key_type& key)
+   {
+      return _delegates.extract(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Inserts the entry of a node, relinking it rather than copying its delegate.
+   /// </summary>
+   ///
+   /// <param name="node">The node of the entry, as extracted from a registry of the same type.</param>
+   /// <param name="policy">How to resolve a key that is already registered.</param>
+   ///
+   /// <returns>An empty node when the whole entry was taken, otherwise the node of what was left over: the given entry
+   ///          when it was kept out, the replaced one, or the functions that couldn't be combined.</returns>
+   ///
+   /// <exception cref="std::invalid_argument">When the key is already registered and the policy is reject.</exception>
+   ///
+   node_type insert(node_type&& node,
+                    conflict_policy policy = conflict_policy::keep_existing)
+   {
+      if (node.empty())
+      {
+         return node_type();
+      }
+
+      const auto& iter = _delegates.find(node.key());
+
+      if (iter == std::end(_delegates))
+      {
+         _delegates.insert(std::move(node));
+         return node_type();
+      }
+
+      resolve(iter->second, node.mapped(), policy);
+
+      return node.mapped().has_functions() ? std::move(node) : node_type();
+   }
+
+   ///
+   /// <summary>
+   ///   Takes the entries of another registry, relinking them rather than copying their delegates.
+   /// </summary>
+   ///
+   /// <param name="other">The registry to take the entries from, which keeps the ones that are left over.</param>
+   /// <param name="policy">How to resolve the keys that are registered in both.</param>
+   ///
+   /// <remarks>
+   ///   The keys that are only registered in the other registry are relinked as in std::unordered_map::merge, without
+   ///   copying their delegates. The delegates of the keys that are registered in both are swapped, or have functions
+   ///   swapped, according to the policy. Hence merging never copies a callable.
+   /// </remarks>
+   ///
+   /// <exception cref="std::invalid_argument">When a key is registered in both and the policy is reject.</exception>
+   ///
+   void merge(key_delegates_functions& other,
+              conflict_policy policy = conflict_policy::keep_existing)
+   {
+      if (std::addressof(other) == this)
+      {
+         return;
+      }
+
+      if (policy == conflict_policy::reject)
+      {
+         for (const auto& entry : other._delegates)
+         {
+            if (contains(entry.first))
+            {
+               throw std::invalid_argument("The key is registered in both registries.");
+            }
+         }
+      }
+
+      _delegates.reserve(_delegates.size() + other._delegates.size());
+      _delegates.merge(other._delegates);
+
+      // Only the keys registered in both remain in the other registry.
+      if (policy == conflict_policy::keep_existing || other._delegates.empty())
+      {
+         return;
+      }
+
+      std::vector<key_type> emptied;
+
+      for (auto& entry : other._delegates)
+      {
+         resolve(_delegates.find(entry.first)->second, entry.second, policy);
+
+         if (!entry.second.has_functions())
+         {
+            emptied.push_back(entry.first);
+         }
+      }
+
+      for (const auto& key : emptied)
+      {
+         other._delegates.erase(key);
+      }
    }
 
    ///
@@ -625,6 +1023,45 @@ public:
    }
 
 private:
+   ///
+   /// <summary>
+   ///   Finds the given key with its hash value, which a direct_index_map has no use for.
+   /// </summary>
+   ///
+   auto find(const hashed_key<key_type>& key) const
+   {
+      if constexpr (BoundedKey<key_type>)
+      {
+         return _delegates.find(key.key);
+      }
+      else
+      {
+         return _delegates.find(key);
+      }
+   }
+
+   static void resolve(delegate_type& existing,
+                       delegate_type& incoming,
+                       conflict_policy policy)
+   {
+      switch (policy)
+      {
+      case conflict_policy::keep_existing:
+         break;
+
+      case conflict_policy::replace:
+         existing.swap(incoming);
+         break;
+
+      case conflict_policy::combine:
+         existing.take_missing_functions(incoming);
+         break;
+
+      case conflict_policy::reject:
+         throw std::invalid_argument("The key is already registered.");
+      }
+   }
+
    delegates_type _delegates;
 };
 
@@ -645,6 +1082,7 @@ public:
    using function_types = std::tuple<functions_t...>;
    typedef key_delegates_functions<key_type, functions_t...> key_delegates_type;
    typedef typename key_delegates_type::delegate_type delegate_type;
+   typedef typename key_delegates_type::node_type node_type;
 
    key_class_factory() = default;
    key_class_factory(const key_class_factory&) = default;
@@ -666,6 +1104,8 @@ public:
    void register_delegate(const key_type& key,
                           const delegate_type& delegate)
    {
+      PRGRMR_TRACE_FACTORY(register_delegate, key, no_signature);
+
       _delegates.register_delegate(key, delegate);
    }
 
@@ -680,6 +1120,8 @@ public:
    void register_delegate(const key_type& key,
                           delegate_type&& delegate)
    {
+      PRGRMR_TRACE_FACTORY(register_delegate, key, no_signature);
+
       _delegates.register_delegate(key, delegate);
    }
 
@@ -694,6 +1136,8 @@ public:
    void register_functions(const key_type& key,
                            function_types functions)
    {
+      PRGRMR_TRACE_FACTORY(register_functions, key, no_signature);
+
       _delegates.register_delegate(key, delegate_type(std::move(functions)));
    }
 
@@ -706,6 +1150,8 @@ public:
    ///
    void unregister_delegate(const key_type& key)
    {
+      PRGRMR_TRACE_FACTORY(unregister_delegate, key, no_signature);
+
       return _delegates.unregister_delegate(key);
    }
 
@@ -721,6 +1167,8 @@ public:
    void register_function(const key_type& key,
                           function_t function)
    {
+      PRGRMR_TRACE_FACTORY(register_function, key, (signature_index_of<function_t, functions_t...>()));
+
       _delegates.register_function(key, std::move(function));
    }
 
@@ -734,7 +1182,9 @@ public:
    template<class function_t>
    void unregister_function(const key_type& key)
    {
-      _delegates.unregister_function<function_t>(key);
+      PRGRMR_TRACE_FACTORY(unregister_function, key, (signature_index_of<function_t, functions_t...>()));
+
+      _delegates.template unregister_function<function_t>(key);
    }
 
    ///
@@ -747,7 +1197,9 @@ public:
    template<int index_t>
    void unregister_function(const key_type& key)
    {
-      _delegates.unregister_function<index_t>(key);
+      PRGRMR_TRACE_FACTORY(unregister_function, key, index_t);
+
+      _delegates.template unregister_function<index_t>(key);
    }
 
    ///
@@ -761,7 +1213,7 @@ public:
    template<class function_t>
    decltype(auto) get_function(const key_type& key) const
    {
-      return _delegates.get_function<function_t>(key);
+      return _delegates.template get_function<function_t>(key);
    }
 
    ///
@@ -775,7 +1227,7 @@ public:
    template<int index_t>
    decltype(auto) get_function(const key_type& key) const
    {
-      return _delegates.get_function<index_t>(key);
+      return _delegates.template get_function<index_t>(key);
    }
 
    ///
@@ -792,11 +1244,25 @@ public:
    auto construct(const key_type& key,
                   args_t&&... args) const -> typename function_t::result_type
    {
-      const auto& function = _delegates.get_function<function_t>(key);
+      PRGRMR_TRACE_FACTORY(construct, key, (signature_index_of<function_t, functions_t...>()));
 
-      return (function)
-             ? function(std::forward<args_t>(args)...)
-             : nullptr;
+      return invoke_delegate<function_t>(_delegates.get_delegate(key), std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, with a key whose hash value was already computed.
+   /// </summary>
+   ///
+   /// <see cref="construct"/>
+   ///
+   template<class function_t, class... args_t>
+   auto construct(const hashed_key<key_type>& key,
+                  args_t&&... args) const -> typename function_t::result_type
+   {
+      PRGRMR_TRACE_FACTORY(construct, key.key, (signature_index_of<function_t, functions_t...>()));
+
+      return invoke_delegate<function_t>(_delegates.get_delegate(key), std::forward<args_t>(args)...);
    }
 
    ///
@@ -813,11 +1279,243 @@ public:
    auto construct(const key_type& key,
                   args_t&&... args) const
    {
-      const auto& function = _delegates.get_function<index_t>(key);
+      PRGRMR_TRACE_FACTORY(construct, key, index_t);
 
-      return (function)
-             ? function(std::forward<args_t>(args)...)
-             : decltype(function(std::forward<args_t>(args)...))(nullptr);
+      return invoke_delegate<index_t>(_delegates.get_delegate(key), std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, with a key whose hash value was already computed.
+   /// </summary>
+   ///
+   /// <see cref="construct"/>
+   ///
+   template<int index_t, class... args_t>
+   auto construct(const hashed_key<key_type>& key,
+                  args_t&&... args) const
+   {
+      PRGRMR_TRACE_FACTORY(construct, key.key, index_t);
+
+      return invoke_delegate<index_t>(_delegates.get_delegate(key), std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, reporting why it cannot be constructed rather than throwing.
+   /// </summary>
+   ///
+   /// <remarks>It can be used in code built without exceptions. When built with exceptions, those thrown by the function are caught.</remarks>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>factory_errc::missing_key, missing_signature or constructor_failed otherwise.<returns>
+   ///
+   template<class function_t, class... args_t>
+   auto try_construct(const key_type& key,
+                      args_t&&... args) const noexcept -> result<typename function_t::result_type, factory_errc>
+   {
+      PRGRMR_TRACE_FACTORY(try_construct, key, (signature_index_of<function_t, functions_t...>()));
+
+      const auto* delegate = _delegates.get_delegate(key);
+
+      if (delegate == nullptr)
+      {
+         return make_failure(factory_errc::missing_key);
+      }
+
+      return try_invoke(delegate->template get_function<function_t>(), std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, reporting why it cannot be constructed rather than throwing.
+   /// </summary>
+   ///
+   /// <see cref="try_construct"/>
+   ///
+   template<int index_t, class... args_t>
+   auto try_construct(const key_type& key,
+                      args_t&&... args) const noexcept
+   {
+      PRGRMR_TRACE_FACTORY(try_construct, key, index_t);
+
+      using result_type = result<function_result_t<std::tuple_element_t<index_t, function_types>>, factory_errc>;
+
+      const auto* delegate = _delegates.get_delegate(key);
+
+      if (delegate == nullptr)
+      {
+         return result_type(make_failure(factory_errc::missing_key));
+      }
+
+      return try_invoke(delegate->template get_function<index_t>(), std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class with the signature that is the best match for the given arguments.
+   /// </summary>
+   ///
+   /// <remarks>
+   ///   The signature is selected at compile-time: one that takes exactly the argument types is preferred, otherwise
+   ///   the one that they convert to. It is a compile-time error when no signature matches, or when more than one
+   ///   matches equally well.
+   /// </remarks>
+   ///
+   /// <see cref="best_signature"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class... args_t>
+      requires (!is_signature_named<function_types, args_t...>)
+   auto construct(const key_type& key,
+                  args_t&&... args) const
+   {
+      using selection = best_signature<function_types, args_t...>;
+
+      static_assert(selection::is_found, "None of the constructor signatures can be invoked with the given arguments.");
+      static_assert(!selection::is_found || selection::is_unique,
+                    "The given arguments match more than one constructor signature, name the signature instead.");
+
+      if constexpr (selection::is_found && selection::is_unique)
+      {
+         return construct<static_cast<int>(selection::index)>(key, std::forward<args_t>(args)...);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class with a signature that is only known at runtime.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   /// <param name="signature_id">The tuple index of the function signature.</param>
+   /// <param name="packed_args">The arguments of the function, as packed by pack_arguments.</param>
+   ///
+   /// <see cref="delegate_functions::invoke_packed"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found, or the signature cannot be invoked with the arguments.<returns>
+   ///
+   auto construct_dynamic(const key_type& key,
+                          std::size_t signature_id,
+                          std::span<const std::byte> packed_args) const -> typename delegate_type::result_type
+   {
+      PRGRMR_TRACE_FACTORY(construct_dynamic, key, signature_id);
+
+      const auto* delegate = _delegates.get_delegate(key);
+
+      return (delegate != nullptr)
+             ? delegate->invoke_packed(signature_id, packed_args)
+             : typename delegate_type::result_type{};
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is registered.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for.</param>
+   ///
+   bool contains(const key_type& key) const
+   {
+      return _delegates.contains(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key, whose hash value was already computed, is registered.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for, with its hash value.</param>
+   ///
+   bool contains(const hashed_key<key_type>& key) const
+   {
+      return _delegates.contains(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of registered keys.
+   /// </summary>
+   ///
+   std::size_t size() const noexcept
+   {
+      return _delegates.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Reserves room for the given number of keys, e.g. before registering many keys at once.
+   /// </summary>
+   ///
+   void reserve(std::size_t count)
+   {
+      _delegates.reserve(count);
+   }
+
+   ///
+   /// <summary>
+   ///   Invokes a function with each registered key, in no particular order.
+   /// </summary>
+   ///
+   /// <param name="function">The function that is invoked with a const reference to each key.</param>
+   ///
+   template<class function_t>
+   void for_each_key(function_t&& function) const
+   {
+      _delegates.for_each_key(std::forward<function_t>(function));
+   }
+
+   ///
+   /// <summary>
+   ///   Removes the registration of the given key, and hands it over in a node that can be inserted into another factory.
+   /// </summary>
+   ///
+   /// <see cref="key_delegates_functions::extract"/>
+   ///
+   node_type extract(const key_type& key)
+   {
+      PRGRMR_TRACE_FACTORY(extract, key, no_signature);
+
+      return _delegates.extract(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Inserts the registration of a node, without copying its functions.
+   /// </summary>
+   ///
+   /// <see cref="key_delegates_functions::insert"/>
+   ///
+   node_type insert(node_type&& node,
+                    conflict_policy policy = conflict_policy::keep_existing)
+   {
+      if (node.empty())
+      {
+         return node_type();
+      }
+
+      PRGRMR_TRACE_FACTORY(insert, node.key(), no_signature);
+
+      return _delegates.insert(std::move(node), policy);
+   }
+
+   ///
+   /// <summary>
+   ///   Takes the registrations of another factory, e.g. of a module, without copying their functions.
+   /// </summary>
+   ///
+   /// <param name="other">The factory to take the registrations from, which keeps the ones that are left over.</param>
+   /// <param name="policy">How to resolve the keys that are registered in both.</param>
+   ///
+   /// <see cref="key_delegates_functions::merge"/>
+   ///
+   void merge(key_class_factory& other,
+              conflict_policy policy = conflict_policy::keep_existing)
+   {
+      _delegates.merge(other._delegates, policy);
    }
 
    ///
@@ -833,6 +1531,83 @@ public:
    }
 
 private:
+   ///
+   /// <summary>
+   ///   Invokes the function of a delegate by its signature, in place, as get_function would return a copy of it.
+   /// </summary>
+   ///
+   template<class function_t, class... args_t>
+   static auto invoke_delegate(const delegate_type* delegate,
+                               args_t&&... args) -> typename function_t::result_type
+   {
+      if (delegate == nullptr)
+      {
+         return nullptr;
+      }
+
+      const auto& function = delegate->template get_function<function_t>();
+
+      return (function)
+             ? function(std::forward<args_t>(args)...)
+             : nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Invokes the function of a delegate by its index position, in place.
+   /// </summary>
+   ///
+   template<int index_t, class... args_t>
+   static auto invoke_delegate(const delegate_type* delegate,
+                               args_t&&... args)
+   {
+      using result_type = function_result_t<std::tuple_element_t<index_t, function_types>>;
+
+      if (delegate == nullptr)
+      {
+         return result_type(nullptr);
+      }
+
+      const auto& function = delegate->template get_function<index_t>();
+
+      return (function)
+             ? function(std::forward<args_t>(args)...)
+             : result_type(nullptr);
+   }
+
+   template<class function_t, class... args_t>
+   static auto try_invoke(const function_t& function,
+                          args_t&&... args) noexcept -> result<function_result_t<function_t>, factory_errc>
+   {
+      if (!function)
+      {
+         return make_failure(factory_errc::missing_signature);
+      }
+
+#if PRGRMR_HAS_EXCEPTIONS
+      try
+      {
+#endif
+         auto instance = function(std::forward<args_t>(args)...);
+
+         if constexpr (requires { instance == nullptr; })
+         {
+            if (instance == nullptr)
+            {
+               return make_failure(factory_errc::constructor_failed);
+            }
+         }
+
+         return instance;
+#if PRGRMR_HAS_EXCEPTIONS
+      }
+      catch (...)
+      {
+         return make_failure(factory_errc::constructor_failed);
+      }
+#endif
+   }
+
    key_delegates_type _delegates;
 };
 }
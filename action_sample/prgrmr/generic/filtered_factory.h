@@ -0,0 +1,401 @@
+#pragma once
+
+#include "bloom_filter.h"
+#include "factory.h"
+#include "hashing.h"
+#include "thread_counters.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The counters of the lookups made by a filtered_key_class_factory.
+/// </summary>
+///
+struct lookup_statistics
+{
+   std::uint64_t lookups             = 0;   // Number of constructions that were requested.
+   std::uint64_t filter_rejections   = 0;   // Misses rejected by the membership filter.
+   std::uint64_t negative_cache_hits = 0;   // Misses rejected by the cache of recent misses.
+   std::uint64_t false_positives     = 0;   // Misses that the filter and the cache let through, found missing in the registry.
+
+   ///
+   /// <summary>
+   ///   Get the ratio of the unregistered keys that were looked up in the registry, as neither the membership filter nor
+   ///   the cache of recent misses rejected them.
+   /// </summary>
+   ///
+   double false_positive_rate() const noexcept
+   {
+      const auto negatives = filter_rejections + negative_cache_hits + false_positives;
+
+      return (negatives > 0)
+             ? static_cast<double>(false_positives) / static_cast<double>(negatives)
+             : 0.0;
+   }
+};
+
+///
+/// <summary>
+///   The filtered_key_class_factory class is a key_class_factory that rejects unregistered keys before probing its registry.
+///   <para>A blocked Bloom filter of the registered keys rejects most of the misses within a single cache line.</para>
+///   <para>The few misses that the filter lets through are remembered in a small cache, hence a repeated miss is also rejected early.</para>
+/// </summary>
+///
+/// <remarks>
+///   The key is hashed once for the filter, the cache and the registry, which looks it up as a hashed_key. The cache
+///   holds 64 bits hash values, hence a registered key whose hash value collides with a cached miss would be reported
+///   missing, which is as likely as 1 in 2^63.
+///   The filter cannot forget keys, hence it is rebuilt once half of the keys it holds were unregistered.
+///   Each thread counts its lookups in its own cache line, hence the lookups of different threads don't contend.
+/// </remarks>
+///
+/// <seealso cref="key_class_factory"/>
+/// <seealso cref="blocked_bloom_filter"/>
+///
+template<class key_t, class... functions_t>
+class filtered_key_class_factory final
+{
+public:
+   typedef key_t key_type;
+   using function_types = std::tuple<functions_t...>;
+   typedef key_class_factory<key_type, functions_t...> factory_type;
+   typedef typename factory_type::delegate_type delegate_type;
+
+   static constexpr std::size_t negative_cache_size = 256;
+
+   filtered_key_class_factory() = default;
+   filtered_key_class_factory(const filtered_key_class_factory&) = delete;
+   filtered_key_class_factory(filtered_key_class_factory&&) = delete;
+
+   ~filtered_key_class_factory() = default;
+
+   filtered_key_class_factory& operator=(const filtered_key_class_factory&) = delete;
+   filtered_key_class_factory& operator=(filtered_key_class_factory&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Registers all the delegate under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   void register_delegate(const key_type& key,
+                          const delegate_type& delegate)
+   {
+      _factory.register_delegate(key, delegate);
+      added(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the functions under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with these function signatures.</param>
+   /// <param name="functions">The functions that are to be registered.</param>
+   ///
+   void register_functions(const key_type& key,
+                           function_types functions)
+   {
+      _factory.register_functions(key, std::move(functions));
+      added(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Registers a single function under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with this function.</param>
+   /// <param name="function">The function that is to be registered.</param>
+   ///
+   template<class function_t>
+   void register_function(const key_type& key,
+                          function_t function)
+   {
+      _factory.register_function(key, std::move(function));
+      added(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters all the functions that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   void unregister_delegate(const key_type& key)
+   {
+      // Only the keys that are actually erased leave a stale entry in the filter.
+      if (!_factory.contains(key))
+      {
+         return;
+      }
+
+      _factory.unregister_delegate(key);
+
+      if (++_removed > _factory.size())
+      {
+         rebuild();
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<class function_t>
+   void unregister_function(const key_type& key)
+   {
+      _factory.template unregister_function<function_t>(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<int index_t>
+   void unregister_function(const key_type& key)
+   {
+      _factory.template unregister_function<index_t>(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class function_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const -> typename function_t::result_type
+   {
+      const auto hashed = make_hashed_key(key);
+
+      if (is_rejected(hashed.hash))
+      {
+         return nullptr;
+      }
+
+      auto instance = _factory.template construct<function_t>(hashed, std::forward<args_t>(args)...);
+
+      if (instance == nullptr)
+      {
+         missed(hashed);
+      }
+
+      return instance;
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<int index_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const
+   {
+      using result_type = decltype(_factory.template construct<index_t>(key, std::forward<args_t>(args)...));
+
+      const auto hashed = make_hashed_key(key);
+
+      if (is_rejected(hashed.hash))
+      {
+         return result_type(nullptr);
+      }
+
+      auto instance = _factory.template construct<index_t>(hashed, std::forward<args_t>(args)...);
+
+      if (instance == nullptr)
+      {
+         missed(hashed);
+      }
+
+      return instance;
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is registered, rejecting most of the unregistered keys without probing the registry.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for.</param>
+   ///
+   bool contains(const key_type& key) const
+   {
+      const auto hashed = make_hashed_key(key);
+
+      if (is_rejected(hashed.hash))
+      {
+         return false;
+      }
+
+      if (_factory.contains(hashed))
+      {
+         return true;
+      }
+
+      remember(hashed.hash);
+
+      return false;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the counters of the lookups made so far.
+   /// </summary>
+   ///
+   lookup_statistics statistics() const
+   {
+      const auto values = _counters.values();
+
+      lookup_statistics statistics;
+
+      statistics.lookups             = values[lookups];
+      statistics.filter_rejections   = values[filter_rejections];
+      statistics.negative_cache_hits = values[negative_cache_hits];
+      statistics.false_positives     = values[false_positives];
+
+      return statistics;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the underlying factory.
+   /// </summary>
+   ///
+   const factory_type& factory() const noexcept
+   {
+      return _factory;
+   }
+
+private:
+   enum counter : std::size_t
+   {
+      lookups,
+      filter_rejections,
+      negative_cache_hits,
+      false_positives,
+      counter_count
+   };
+
+   void count(counter index) const
+   {
+      _counters.add(index);
+   }
+
+   static std::uint64_t cached_value_of(std::uint64_t hash) noexcept
+   {
+      return hash | 1;   // Zero marks the empty slots of the cache.
+   }
+
+   static std::size_t slot_of(std::uint64_t hash) noexcept
+   {
+      // The lowest bit of a cached value is always set, hence the slot is selected by the bits above it.
+      return static_cast<std::size_t>((hash >> 1) % negative_cache_size);
+   }
+
+   bool is_rejected(std::uint64_t hash) const
+   {
+      count(lookups);
+
+      if (!_filter.may_contain(hash))
+      {
+         count(filter_rejections);
+         return true;
+      }
+
+      if (_negative_cache[slot_of(hash)].load(std::memory_order_relaxed) == cached_value_of(hash))
+      {
+         count(negative_cache_hits);
+         return true;
+      }
+
+      return false;
+   }
+
+   ///
+   /// <summary>
+   ///   Counts a key that the filter and the cache let through and that the registry found missing, and caches the miss.
+   /// </summary>
+   ///
+   void remember(std::uint64_t hash) const
+   {
+      count(false_positives);
+      _negative_cache[slot_of(hash)].store(cached_value_of(hash), std::memory_order_relaxed);
+   }
+
+   ///
+   /// <summary>
+   ///   Remembers a key that a construction didn't find, unless it is registered without the requested signature.
+   /// </summary>
+   ///
+   void missed(const hashed_key<key_type>& key) const
+   {
+      if (!_factory.contains(key))
+      {
+         remember(key.hash);
+      }
+   }
+
+   void added(const key_type& key)
+   {
+      // A miss cached for a key that is now registered would hide it.
+      for (auto& slot : _negative_cache)
+      {
+         slot.store(0, std::memory_order_relaxed);
+      }
+
+      if (_factory.size() > _capacity)
+      {
+         rebuild();
+         return;
+      }
+
+      _filter.insert(hash_key(key));
+   }
+
+   void rebuild()
+   {
+      _capacity = 2 * (_factory.size() > 0 ? _factory.size() : 1);
+      _removed  = 0;
+
+      blocked_bloom_filter filter(_capacity);
+
+      _factory.for_each_key([&filter](const key_type& key) { filter.insert(hash_key(key)); });
+      _filter.swap(filter);
+   }
+
+   static constexpr std::size_t initial_capacity = 64;
+
+   factory_type         _factory;
+   blocked_bloom_filter _filter{initial_capacity};
+   std::size_t          _capacity = initial_capacity;
+   std::size_t          _removed  = 0;
+
+   mutable std::array<std::atomic<std::uint64_t>, negative_cache_size> _negative_cache{};
+   mutable thread_counters<counter_count>                              _counters;
+};
+}
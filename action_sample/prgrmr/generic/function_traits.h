@@ -0,0 +1,14 @@
+#pragma once
+
+#include "../concepts/function_traits.h"
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The traits of the function signatures, which live with the concepts, as the signature checks depend on them.
+/// </summary>
+///
+using concepts::function_traits;
+using concepts::function_result_t;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   Scrambles the bits of a hash value, so that every bit of the result depends on every bit of the input.
+/// </summary>
+///
+/// <remarks>
+///   std::hash is the identity for integers with most standard libraries, hence its low or high bits alone cannot
+///   be relied upon to spread keys. This is the finalizer of SplitMix64.
+/// </remarks>
+///
+constexpr std::uint64_t mix_hash(std::uint64_t value) noexcept
+{
+   value ^= value >> 30;
+   value *= 0xbf58476d1ce4e5b9ULL;
+   value ^= value >> 27;
+   value *= 0x94d049bb133111ebULL;
+   value ^= value >> 31;
+
+   return value;
+}
+
+///
+/// <summary>
+///   Get the well spread 64 bits hash value of a key.
+/// </summary>
+///
+template<class key_t>
+std::uint64_t hash_key(const key_t& key)
+{
+   return mix_hash(static_cast<std::uint64_t>(std::hash<key_t>{}(key)));
+}
+
+///
+/// <summary>
+///   Combines the hash value of another value into a running hash value.
+/// </summary>
+///
+constexpr std::uint64_t combine_hash(std::uint64_t seed,
+                                     std::uint64_t value) noexcept
+{
+   return mix_hash(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+///
+/// <summary>
+///   A key along with its hash value, see hash_key, which a registry looks up without hashing the key again.
+/// </summary>
+///
+/// <remarks>The hash value must be the one of hash_key, as the hash function of the registries is key_hash.</remarks>
+///
+template<class key_t>
+struct hashed_key
+{
+   const key_t&  key;
+   std::uint64_t hash;
+};
+
+///
+/// <summary>
+///   Hashes a key once, for the lookups of a hashed_key.
+/// </summary>
+///
+template<class key_t>
+hashed_key<key_t> make_hashed_key(const key_t& key)
+{
+   return hashed_key<key_t>{key, hash_key(key)};
+}
+
+///
+/// <summary>
+///   The hash function of the registries, which hashes a key with hash_key and takes the hash value of a hashed_key
+///   as it is.
+/// </summary>
+///
+template<class key_t>
+struct key_hash
+{
+   using is_transparent = void;
+
+   std::size_t operator()(const key_t& key) const
+   {
+      return static_cast<std::size_t>(hash_key(key));
+   }
+
+   std::size_t operator()(const hashed_key<key_t>& key) const noexcept
+   {
+      return static_cast<std::size_t>(key.hash);
+   }
+};
+
+///
+/// <summary>
+///   The key comparison of the registries, which compares a hashed_key by its key.
+/// </summary>
+///
+template<class key_t>
+struct key_equal
+{
+   using is_transparent = void;
+
+   bool operator()(const key_t& left, const key_t& right) const
+   {
+      return left == right;
+   }
+
+   bool operator()(const hashed_key<key_t>& left, const key_t& right) const
+   {
+      return left.key == right;
+   }
+
+   bool operator()(const key_t& left, const hashed_key<key_t>& right) const
+   {
+      return left == right.key;
+   }
+};
+}
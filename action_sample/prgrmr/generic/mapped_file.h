@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The mapped_file class maps a whole file into memory, read-only.
+/// </summary>
+///
+/// <remarks>
+///   The pages of the file are only read from the disk when they are first touched, and they are shared with the
+///   page cache, hence a large file is mapped without being copied.
+/// </remarks>
+///
+class mapped_file final
+{
+public:
+   mapped_file() = default;
+   mapped_file(const mapped_file&) = delete;
+
+   mapped_file(mapped_file&& other) noexcept
+   : _data(std::exchange(other._data, nullptr)),
+     _size(std::exchange(other._size, 0)),
+     _error(std::move(other._error))
+   {
+   }
+
+   ~mapped_file()
+   {
+      close();
+   }
+
+   mapped_file& operator=(const mapped_file&) = delete;
+
+   mapped_file& operator=(mapped_file&& other) noexcept
+   {
+      if (this != &other)
+      {
+         close();
+         _data  = std::exchange(other._data, nullptr);
+         _size  = std::exchange(other._size, 0);
+         _error = std::move(other._error);
+      }
+
+      return *this;
+   }
+
+   ///
+   /// <summary>
+   ///   Maps the file at the given path, unmapping the file that was mapped.
+   /// </summary>
+   ///
+   /// <returns>false when it cannot be mapped, or is empty, in which case error() describes why.</returns>
+   ///
+   bool open(const std::string& path)
+   {
+      close();
+
+#if defined(_WIN32)
+      const auto file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+      if (file == INVALID_HANDLE_VALUE)
+      {
+         _error = "CreateFile failed with error " + std::to_string(::GetLastError()) + ": " + path;
+         return false;
+      }
+
+      LARGE_INTEGER size{};
+
+      if (!::GetFileSizeEx(file, &size) || size.QuadPart == 0)
+      {
+         _error = "The file is empty, or its size is unknown: " + path;
+         ::CloseHandle(file);
+         return false;
+      }
+
+      const auto mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+      // The view keeps the mapping alive, and the mapping keeps the file alive.
+      ::CloseHandle(file);
+
+      if (mapping == nullptr)
+      {
+         _error = "CreateFileMapping failed with error " + std::to_string(::GetLastError()) + ": " + path;
+         return false;
+      }
+
+      auto* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+      ::CloseHandle(mapping);
+
+      if (view == nullptr)
+      {
+         _error = "MapViewOfFile failed with error " + std::to_string(::GetLastError()) + ": " + path;
+         return false;
+      }
+
+      _data = static_cast<const std::byte*>(view);
+      _size = static_cast<std::size_t>(size.QuadPart);
+#else
+      const int descriptor = ::open(path.c_str(), O_RDONLY);
+
+      if (descriptor < 0)
+      {
+         _error = "open failed: " + path;
+         return false;
+      }
+
+      struct stat status{};
+
+      if (::fstat(descriptor, &status) != 0 || status.st_size == 0)
+      {
+         _error = "The file is empty, or its size is unknown: " + path;
+         ::close(descriptor);
+         return false;
+      }
+
+      auto* view = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+      // The mapping keeps the file alive.
+      ::close(descriptor);
+
+      if (view == MAP_FAILED)
+      {
+         _error = "mmap failed: " + path;
+         return false;
+      }
+
+      _data = static_cast<const std::byte*>(view);
+      _size = static_cast<std::size_t>(status.st_size);
+#endif
+
+      _error.clear();
+      return true;
+   }
+
+   ///
+   /// <summary>
+   ///   Unmaps the file, which invalidates the bytes that were handed out.
+   /// </summary>
+   ///
+   void close() noexcept
+   {
+      if (_data == nullptr)
+      {
+         return;
+      }
+
+#if defined(_WIN32)
+      ::UnmapViewOfFile(_data);
+#else
+      ::munmap(const_cast<std::byte*>(_data), _size);
+#endif
+
+      _data = nullptr;
+      _size = 0;
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if a file is mapped.
+   /// </summary>
+   ///
+   bool is_open() const noexcept
+   {
+      return _data != nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the bytes of the file, which remain valid until it is closed.
+   /// </summary>
+   ///
+   std::span<const std::byte> bytes() const noexcept
+   {
+      return { _data, _size };
+   }
+
+   ///
+   /// <summary>
+   ///   Get the description of the last failure.
+   /// </summary>
+   ///
+   const std::string& error() const noexcept
+   {
+      return _error;
+   }
+
+private:
+   const std::byte* _data = nullptr;
+   std::size_t      _size = 0;
+   std::string      _error;
+};
+}
@@ -0,0 +1,471 @@
+#pragma once
+
+#include "clock_cache.h"
+#include "factory.h"
+#include "function_traits.h"
+#include "hashing.h"
+#include "thread_counters.h"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The counters of the constructions made by a memoizing_key_class_factory.
+/// </summary>
+///
+struct memo_statistics
+{
+   std::uint64_t hits      = 0;   // Constructions served by a cached instance.
+   std::uint64_t misses    = 0;   // Constructions that invoked a registered function.
+   std::uint64_t evictions = 0;   // Cached instances evicted to make room.
+
+   ///
+   /// <summary>
+   ///   Get the ratio of the constructions served by a cached instance.
+   /// </summary>
+   ///
+   double hit_rate() const noexcept
+   {
+      const auto lookups = hits + misses;
+
+      return (lookups > 0)
+             ? static_cast<double>(hits) / static_cast<double>(lookups)
+             : 0.0;
+   }
+};
+
+///
+/// <summary>
+///   The memoizing_key_class_factory class is a key_class_factory that shares the instances constructed with the same
+///   key, signature and arguments.
+///   <para>The instances are treated as immutable, hence they are handed out as std::shared_ptr to const.</para>
+///   <para>Each signature has its own cache, bounded in number of entries and evicting with the CLOCK policy.</para>
+/// </summary>
+///
+/// <remarks>
+///   The arguments of the memoized signatures must be hashable and equality comparable, once decayed. Floating point
+///   arguments that are NaN are all equal to each other, hence constructions with NaN arguments are memoized too.
+///   The caches are split into shards, each with its own lock, selected by the hash value of the key and arguments.
+///   Hence threads that find different instances rarely wait on each other. The capacity is divided among the shards.
+///   An evicted instance lives on for as long as it is shared. Failed constructions aren't cached.
+///   Any change to the registrations clears the caches.
+/// </remarks>
+///
+/// <seealso cref="key_class_factory"/>
+/// <seealso cref="clock_cache"/>
+///
+template<class key_t, class... functions_t>
+class memoizing_key_class_factory final
+{
+public:
+   typedef key_t key_type;
+   using function_types = std::tuple<functions_t...>;
+   typedef key_class_factory<key_type, functions_t...> factory_type;
+   typedef typename factory_type::delegate_type delegate_type;
+   typedef typename delegate_type::result_type::element_type product_type;
+   typedef std::shared_ptr<const product_type> shared_pointer;
+
+   static constexpr std::size_t default_capacity = 1024;
+   static constexpr std::size_t shard_count      = 16;
+
+   ///
+   /// <summary>
+   ///   Constructs an instance without any keys.
+   /// </summary>
+   ///
+   /// <param name="capacity">The number of instances that each signature may cache.</param>
+   ///
+   explicit memoizing_key_class_factory(std::size_t capacity = default_capacity)
+   {
+      const auto shard_capacity = (capacity + shard_count - 1) / shard_count;
+
+      for (auto& shard : _shards)
+      {
+         shard.caches = std::make_tuple(cache_type<functions_t>(shard_capacity)...);
+      }
+   }
+
+   memoizing_key_class_factory(const memoizing_key_class_factory&) = delete;
+   memoizing_key_class_factory(memoizing_key_class_factory&&) = delete;
+
+   ~memoizing_key_class_factory() = default;
+
+   memoizing_key_class_factory& operator=(const memoizing_key_class_factory&) = delete;
+   memoizing_key_class_factory& operator=(memoizing_key_class_factory&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Registers all the delegate under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   void register_delegate(const key_type& key,
+                          const delegate_type& delegate)
+   {
+      _factory.register_delegate(key, delegate);
+      clear();
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the functions under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with these function signatures.</param>
+   /// <param name="functions">The functions that are to be registered.</param>
+   ///
+   void register_functions(const key_type& key,
+                           function_types functions)
+   {
+      _factory.register_functions(key, std::move(functions));
+      clear();
+   }
+
+   ///
+   /// <summary>
+   ///   Registers a single function under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with this function.</param>
+   /// <param name="function">The function that is to be registered.</param>
+   ///
+   template<class function_t>
+   void register_function(const key_type& key,
+                          function_t function)
+   {
+      _factory.register_function(key, std::move(function));
+      clear();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters all the functions that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   void unregister_delegate(const key_type& key)
+   {
+      _factory.unregister_delegate(key);
+      clear();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<class function_t>
+   void unregister_function(const key_type& key)
+   {
+      _factory.template unregister_function<function_t>(key);
+      clear();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<int index_t>
+   void unregister_function(const key_type& key)
+   {
+      _factory.template unregister_function<index_t>(key);
+      clear();
+   }
+
+   ///
+   /// <summary>
+   ///   Get the instance constructed with the key, signature and arguments, constructing it when it isn't cached.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>A shared instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class function_t, class... args_t>
+   shared_pointer construct(const key_type& key,
+                            args_t&&... args) const
+   {
+      return construct<static_cast<int>(index_of<function_t>())>(key, std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the instance constructed with the key, signature and arguments, constructing it when it isn't cached.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>A shared instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<int index_t, class... args_t>
+   shared_pointer construct(const key_type& key,
+                            args_t&&... args) const
+   {
+      using function_type = std::tuple_element_t<index_t, function_types>;
+
+      auto memo_key = make_memo_key<function_type>(key, args...);
+
+      auto& owner = _shards[memo_key.hash >> (64 - shard_bits)];
+      auto& cache = std::get<index_t>(owner.caches);
+
+      {
+         std::lock_guard<std::mutex> lock(owner.mutex);
+
+         if (const auto* found = cache.find(memo_key))
+         {
+            count(hits);
+            return *found;
+         }
+      }
+
+      count(misses);
+
+      // Constructed without holding the lock, hence constructors may themselves use the factory.
+      shared_pointer instance(_factory.template construct<index_t>(key, std::forward<args_t>(args)...));
+
+      if (instance == nullptr)
+      {
+         return instance;
+      }
+
+      std::lock_guard<std::mutex> lock(owner.mutex);
+
+      // Another thread may have constructed the same instance meanwhile, in which case it is the one shared.
+      if (const auto* found = cache.find(memo_key))
+      {
+         return *found;
+      }
+
+      if (cache.insert(std::move(memo_key), instance))
+      {
+         count(evictions);
+      }
+
+      return instance;
+   }
+
+   ///
+   /// <summary>
+   ///   Removes all the cached instances. The instances that are still shared live on.
+   /// </summary>
+   ///
+   void clear()
+   {
+      for (auto& shard : _shards)
+      {
+         std::lock_guard<std::mutex> lock(shard.mutex);
+
+         std::apply([](auto&... caches) { (caches.clear(), ...); }, shard.caches);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of cached instances, across all the signatures.
+   /// </summary>
+   ///
+   std::size_t size() const
+   {
+      std::size_t size = 0;
+
+      for (auto& shard : _shards)
+      {
+         std::lock_guard<std::mutex> lock(shard.mutex);
+
+         size += std::apply([](const auto&... caches) { return (std::size_t{0} + ... + caches.size()); }, shard.caches);
+      }
+
+      return size;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the counters of the constructions made so far.
+   /// </summary>
+   ///
+   memo_statistics statistics() const
+   {
+      const auto counts = _counters.values();
+
+      memo_statistics statistics;
+
+      statistics.hits      = counts[hits];
+      statistics.misses    = counts[misses];
+      statistics.evictions = counts[evictions];
+
+      return statistics;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the underlying factory.
+   /// </summary>
+   ///
+   const factory_type& factory() const noexcept
+   {
+      return _factory;
+   }
+
+private:
+   template<class function_t>
+   using arguments_type = typename function_traits<function_t>::decayed_argument_types;
+
+   enum counter : std::size_t
+   {
+      hits,
+      misses,
+      evictions,
+      counter_count
+   };
+
+   static constexpr int shard_bits = std::countr_zero(shard_count);
+
+   ///
+   /// <summary>
+   ///   The key and arguments of a construction, along with their hash value, which is computed once to select the
+   ///   shard and is then reused by the cache.
+   /// </summary>
+   ///
+   template<class arguments_t>
+   struct hashed_memo_key
+   {
+      key_type      key;
+      arguments_t   arguments;
+      std::uint64_t hash;
+   };
+
+   template<class function_t>
+   using memo_key_type = hashed_memo_key<arguments_type<function_t>>;
+
+   struct memo_key_hash
+   {
+      template<class arguments_t>
+      std::size_t operator()(const hashed_memo_key<arguments_t>& memo_key) const noexcept
+      {
+         return static_cast<std::size_t>(memo_key.hash);
+      }
+   };
+
+   struct memo_key_equal
+   {
+      template<class arguments_t>
+      bool operator()(const hashed_memo_key<arguments_t>& left,
+                      const hashed_memo_key<arguments_t>& right) const
+      {
+         return (left.hash == right.hash)
+             && (left.key == right.key)
+             && std::apply([&right](const auto&... lefts)
+                           {
+                              return std::apply([&lefts...](const auto&... rights) { return (same_argument(lefts, rights) && ...); },
+                                                right.arguments);
+                           },
+                           left.arguments);
+      }
+   };
+
+   template<class function_t>
+   using cache_type = clock_cache<memo_key_type<function_t>, shared_pointer, memo_key_hash, memo_key_equal>;
+
+   struct alignas(64) shard
+   {
+      mutable std::mutex                     mutex;
+      std::tuple<cache_type<functions_t>...> caches;
+   };
+
+   ///
+   /// <summary>
+   ///   Makes the memo key of a construction, in which every NaN argument is the same quiet NaN, hence hashes the same.
+   /// </summary>
+   ///
+   template<class function_t, class... args_t>
+   static memo_key_type<function_t> make_memo_key(const key_type& key,
+                                                  const args_t&... args)
+   {
+      memo_key_type<function_t> memo_key{key, arguments_type<function_t>(args...), 0};
+
+      auto seed = hash_key(memo_key.key);
+
+      std::apply([&seed](auto&... arguments) { ((seed = combine_hash(seed, hash_argument(arguments))), ...); }, memo_key.arguments);
+
+      memo_key.hash = seed;
+
+      return memo_key;
+   }
+
+   template<class argument_t>
+   static std::uint64_t hash_argument(argument_t& argument)
+   {
+      if constexpr (std::is_floating_point_v<argument_t>)
+      {
+         if (std::isnan(argument))
+         {
+            argument = std::numeric_limits<argument_t>::quiet_NaN();
+         }
+      }
+
+      return hash_key(argument);
+   }
+
+   template<class argument_t>
+   static bool same_argument(const argument_t& left,
+                             const argument_t& right)
+   {
+      if constexpr (std::is_floating_point_v<argument_t>)
+      {
+         return (left == right) || (std::isnan(left) && std::isnan(right));
+      }
+      else
+      {
+         return left == right;
+      }
+   }
+
+   template<class function_t>
+   static constexpr std::size_t index_of()
+   {
+      constexpr std::array<bool, sizeof...(functions_t)> matches = { std::is_same_v<function_t, functions_t>... };
+
+      for (std::size_t i = 0; i < matches.size(); ++i)
+      {
+         if (matches[i])
+         {
+            return i;
+         }
+      }
+
+      return matches.size();
+   }
+
+   void count(counter counter) const
+   {
+      _counters.add(counter);
+   }
+
+   factory_type _factory;
+
+   mutable std::array<shard, shard_count> _shards;
+
+   mutable thread_counters<counter_count> _counters;
+};
+}
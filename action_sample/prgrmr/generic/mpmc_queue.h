@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The mpmc_queue class is a bounded queue that many threads can push to and pop from at once, without locks.
+///   <para>Each cell of the ring has a sequence number, which tells a pushing thread when the cell is free, and a popping
+///   thread when it is full. A thread claims a position with a single compare and swap, then only touches its cell.</para>
+/// </summary>
+///
+/// <remarks>
+///   The values are moved in and out of the cells, hence they must be default constructible and move assignable.
+///   Pushing into a full queue and popping from an empty one fail at once, rather than wait.
+///   The positions of the pushing and the popping threads lie on their own cache lines, so that the two sides don't
+///   contend for a cache line while the queue is neither full nor empty.
+/// </remarks>
+///
+template<class value_t>
+class mpmc_queue final
+{
+public:
+   typedef value_t value_type;
+
+   static_assert(std::is_default_constructible_v<value_type> && std::is_move_assignable_v<value_type>,
+                 "The values of a mpmc_queue must be default constructible and move assignable.");
+
+   ///
+   /// <summary>
+   ///   Constructs an empty queue.
+   /// </summary>
+   ///
+   /// <param name="capacity">The number of values the queue holds, which is rounded up to a power of two.</param>
+   ///
+   explicit mpmc_queue(std::size_t capacity)
+   : _mask(std::bit_ceil((std::max)(capacity, std::size_t(2))) - 1),
+     _cells(std::make_unique<cell[]>(_mask + 1))
+   {
+      for (std::size_t i = 0; i <= _mask; ++i)
+      {
+         _cells[i].sequence.store(i, std::memory_order_relaxed);
+      }
+   }
+
+   mpmc_queue(const mpmc_queue&) = delete;
+   mpmc_queue(mpmc_queue&&) = delete;
+
+   ~mpmc_queue() = default;
+
+   mpmc_queue& operator=(const mpmc_queue&) = delete;
+   mpmc_queue& operator=(mpmc_queue&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Pushes a value at the back of the queue.
+   /// </summary>
+   ///
+   /// <returns>false when the queue is full, in which case the value isn't moved.</returns>
+   ///
+   template<class arg_t>
+   bool try_push(arg_t&& value)
+   {
+      auto position = _push_position.load(std::memory_order_relaxed);
+
+      for (;;)
+      {
+         auto& current = _cells[position & _mask];
+
+         const auto sequence   = current.sequence.load(std::memory_order_acquire);
+         const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+         if (difference == 0)
+         {
+            if (_push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+               current.value = std::forward<arg_t>(value);
+               current.sequence.store(position + 1, std::memory_order_release);
+               return true;
+            }
+         }
+         else if (difference < 0)
+         {
+            // The cell still holds the value pushed a lap earlier.
+            return false;
+         }
+         else
+         {
+            position = _push_position.load(std::memory_order_relaxed);
+         }
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Pops the value at the front of the queue.
+   /// </summary>
+   ///
+   /// <returns>false when the queue is empty, in which case the given value is unchanged.</returns>
+   ///
+   bool try_pop(value_type& value)
+   {
+      auto position = _pop_position.load(std::memory_order_relaxed);
+
+      for (;;)
+      {
+         auto& current = _cells[position & _mask];
+
+         const auto sequence   = current.sequence.load(std::memory_order_acquire);
+         const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+
+         if (difference == 0)
+         {
+            if (_pop_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+               value = std::move(current.value);
+               current.sequence.store(position + _mask + 1, std::memory_order_release);
+               return true;
+            }
+         }
+         else if (difference < 0)
+         {
+            // The cell is still waiting for the value of this lap.
+            return false;
+         }
+         else
+         {
+            position = _pop_position.load(std::memory_order_relaxed);
+         }
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of values the queue holds.
+   /// </summary>
+   ///
+   std::size_t capacity() const noexcept
+   {
+      return _mask + 1;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of values in the queue, which is only a hint while other threads push or pop.
+   /// </summary>
+   ///
+   std::size_t size_hint() const noexcept
+   {
+      const auto pushed = _push_position.load(std::memory_order_relaxed);
+      const auto popped = _pop_position.load(std::memory_order_relaxed);
+
+      return (pushed > popped) ? (std::min)(pushed - popped, capacity()) : 0;
+   }
+
+private:
+   struct cell
+   {
+      std::atomic<std::size_t> sequence{0};
+      value_type               value{};
+   };
+
+   const std::size_t       _mask;
+   std::unique_ptr<cell[]> _cells;
+
+   alignas(64) std::atomic<std::size_t> _push_position{0};
+   alignas(64) std::atomic<std::size_t> _pop_position{0};
+};
+}
@@ -0,0 +1,413 @@
+#pragma once
+
+#include "factory.h"
+#include "signature_selection.h"
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   A product family is the list of constructor signatures of one product, checked as delegate_functions checks them.
+/// </summary>
+///
+template<class... functions_t>
+using product_family = delegate_functions<functions_t...>;
+
+///
+/// <summary>
+///   The product_row class is a view of the delegates of every product family that are registered under a single key.
+///   <para>Once the row is found, the products of all the families are constructed without looking the key up again.</para>
+/// </summary>
+///
+/// <remarks>A row is invalidated by any change to the registrations of its factory.</remarks>
+///
+template<class... families_t>
+class product_row final
+{
+public:
+   using family_types = std::tuple<families_t...>;
+
+   explicit product_row(const family_types* delegates = nullptr) noexcept
+   : _delegates(delegates)
+   {
+   }
+
+   product_row(const product_row&) = default;
+   product_row(product_row&&) = default;
+
+   ~product_row() = default;
+
+   product_row& operator=(const product_row&) = default;
+   product_row& operator=(product_row&&) = default;
+
+   ///
+   /// <summary>
+   ///   Indicates if the key was found.
+   /// </summary>
+   ///
+   explicit operator bool() const noexcept
+   {
+      return _delegates != nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the delegate of a product family.
+   /// </summary>
+   ///
+   /// <remarks>The key must have been found.</remarks>
+   ///
+   template<class family_t>
+   const family_t& delegate() const noexcept
+   {
+      return std::get<family_t>(*_delegates);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs a product of a family with a specific function by its signature.
+   /// </summary>
+   ///
+   /// <returns>An instance of the product.<returns>
+   /// <returns>nullptr_t when the key wasn't found or the function has not been registered.<returns>
+   ///
+   template<class family_t, class function_t, class... args_t>
+   auto construct(args_t&&... args) const -> typename function_t::result_type
+   {
+      if (_delegates == nullptr)
+      {
+         return nullptr;
+      }
+
+      const auto& function = delegate<family_t>().template get_function<function_t>();
+
+      return (function)
+             ? function(std::forward<args_t>(args)...)
+             : nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs a product of a family with a specific function by its index position.
+   /// </summary>
+   ///
+   /// <returns>An instance of the product.<returns>
+   /// <returns>nullptr_t when the key wasn't found or the function has not been registered.<returns>
+   ///
+   template<class family_t, int index_t, class... args_t>
+   auto construct(args_t&&... args) const
+   {
+      using result_type = function_result_t<std::tuple_element_t<index_t, typename family_t::functions_type>>;
+
+      if (_delegates == nullptr)
+      {
+         return result_type(nullptr);
+      }
+
+      const auto& function = delegate<family_t>().template get_function<index_t>();
+
+      return (function)
+             ? function(std::forward<args_t>(args)...)
+             : result_type(nullptr);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs a product of every family, each with the signature that is the best match for the given arguments.
+   /// </summary>
+   ///
+   /// <remarks>
+   ///   Each family must have a single signature that can be invoked with the arguments, which is checked at compile-time.
+   ///   The arguments are passed as lvalues, since they are shared by all the families.
+   /// </remarks>
+   ///
+   /// <returns>A tuple of the products, in the order of the families. A product is nullptr_t when it cannot be constructed.<returns>
+   ///
+   template<class... args_t>
+   std::tuple<typename families_t::result_type...> construct_each(const args_t&... args) const
+   {
+      return std::tuple<typename families_t::result_type...>(construct_best<families_t>(args...)...);
+   }
+
+private:
+   template<class family_t, class... args_t>
+   typename family_t::result_type construct_best(const args_t&... args) const
+   {
+      using selection = best_signature<typename family_t::functions_type, const args_t&...>;
+
+      static_assert(selection::is_found, "None of the signatures of a product family can be invoked with the given arguments.");
+      static_assert(!selection::is_found || selection::is_unique,
+                    "The given arguments match more than one signature of a product family.");
+
+      if constexpr (selection::is_found && selection::is_unique)
+      {
+         return construct<family_t, static_cast<int>(selection::index)>(args...);
+      }
+      else
+      {
+         return nullptr;
+      }
+   }
+
+   const family_types* _delegates;
+};
+
+///
+/// <summary>
+///   The multi_product_factory class is a key_class_factory for several products that are identified by the same keys.
+///   <para>Each key maps to a row that holds one delegate per product family, hence a single lookup finds the
+///   constructors of all the products of a key.</para>
+///   <para>Each family has its own list of signatures, which is checked at compile-time as in delegate_functions.</para>
+/// </summary>
+///
+/// <remarks>A family is named by its delegate type, declared with product_family, hence the families must be different.</remarks>
+///
+/// <seealso cref="key_class_factory"/>
+/// <seealso cref="product_row"/>
+///
+template<class key_t, class... families_t>
+class multi_product_factory final
+{
+public:
+   typedef key_t key_type;
+   using family_types = std::tuple<families_t...>;
+   typedef product_row<families_t...> row_type;
+
+   static_assert(sizeof...(families_t) > 0, "The list of product families cannot be empty.");
+
+   multi_product_factory() = default;
+   multi_product_factory(const multi_product_factory&) = default;
+   multi_product_factory(multi_product_factory&&) = default;
+
+   ~multi_product_factory() = default;
+
+   multi_product_factory& operator=(const multi_product_factory&) = default;
+   multi_product_factory& operator=(multi_product_factory&&) = default;
+
+   ///
+   /// <summary>
+   ///   Registers the delegate of a product family under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   /// <remarks>As with key_class_factory, a delegate already registered for the family under the key is kept.</remarks>
+   ///
+   template<class family_t>
+   void register_delegate(const key_type& key,
+                          const family_t& delegate)
+   {
+      auto& registered = std::get<family_t>(_rows[key]);
+
+      if (!registered.has_functions())
+      {
+         registered = delegate;
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the delegate of a product family under the given key, replacing the one already registered.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   template<class family_t>
+   void replace_delegate(const key_type& key,
+                         const family_t& delegate)
+   {
+      std::get<family_t>(_rows[key]) = delegate;
+   }
+
+   ///
+   /// <summary>
+   ///   Registers a single function of a product family under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with this function.</param>
+   /// <param name="function">The function that is to be registered.</param>
+   ///
+   template<class family_t, class function_t>
+   void register_function(const key_type& key,
+                          function_t function)
+   {
+      std::get<family_t>(_rows[key]).register_function(std::move(function));
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters the functions of all the product families that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   void unregister_delegate(const key_type& key)
+   {
+      _rows.erase(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters the functions of a product family that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   /// <remarks>The key remains registered for the other families.</remarks>
+   ///
+   template<class family_t>
+   void unregister_delegate(const key_type& key)
+   {
+      const auto iter = _rows.find(key);
+
+      if (iter != std::end(_rows))
+      {
+         const family_t empty;
+
+         std::get<family_t>(iter->second) = empty;
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function of a product family by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<class family_t, class function_t>
+   void unregister_function(const key_type& key)
+   {
+      const auto iter = _rows.find(key);
+
+      if (iter != std::end(_rows))
+      {
+         std::get<family_t>(iter->second).template unregister_function<function_t>();
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Get the row of the delegates of all the product families registered under the given key, with a single lookup.
+   /// </summary>
+   ///
+   /// <returns>An empty row when the given key cannot be found.</returns>
+   ///
+   row_type find(const key_type& key) const
+   {
+      const auto iter = _rows.find(key);
+
+      return row_type((iter != std::end(_rows)) ? std::addressof(iter->second) : nullptr);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs a product of a family.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the product.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class family_t, class function_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const -> typename function_t::result_type
+   {
+      return find(key).template construct<family_t, function_t>(std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs a product of a family.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the product.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class family_t, int index_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const
+   {
+      return find(key).template construct<family_t, index_t>(std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs a product of every family registered under the given key, with a single lookup.
+   /// </summary>
+   ///
+   /// <see cref="product_row::construct_each"/>
+   ///
+   template<class... args_t>
+   auto construct_each(const key_type& key,
+                       const args_t&... args) const
+   {
+      return find(key).construct_each(args...);
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is registered for any product family.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for.</param>
+   ///
+   bool contains(const key_type& key) const
+   {
+      return _rows.find(key) != std::end(_rows);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of registered keys.
+   /// </summary>
+   ///
+   std::size_t size() const noexcept
+   {
+      return _rows.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Reserves room for the given number of keys.
+   /// </summary>
+   ///
+   void reserve(std::size_t count)
+   {
+      _rows.reserve(count);
+   }
+
+   ///
+   /// <summary>
+   ///   Swaps the contents with another reference.
+   /// </summary>
+   ///
+   /// <param name="other">The reference to swap contents with.</param>
+   ///
+   void swap(multi_product_factory& other)
+   {
+      _rows.swap(other._rows);
+   }
+
+private:
+   template<class family_t>
+   static constexpr std::size_t count_of()
+   {
+      return (std::size_t(0) + ... + std::size_t(std::is_same_v<family_t, families_t>));
+   }
+
+   static_assert(((count_of<families_t>() == 1) && ...), "At least two product families have the same signatures.");
+
+   std::unordered_map<key_type, family_types> _rows;
+};
+}
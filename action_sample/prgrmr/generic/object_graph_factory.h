@@ -0,0 +1,459 @@
+#pragma once
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The object_graph_factory class constructs whole graphs of products, whose keys declare the keys they depend on.
+///   <para>Each constructor receives the products of its dependencies, in the order they were declared.</para>
+///   <para>The construction plan of a key is computed once: its dependencies are sorted topologically into layers,
+///   in which no product depends on another. The products of a layer can then be constructed in parallel.</para>
+/// </summary>
+///
+/// <remarks>
+///   A product that several others depend on is constructed once per graph, and shared by them.
+///   A dependency on a key that isn't registered is passed to the constructor as nullptr.
+///   Registering a key whose dependencies would lead back to it throws, hence the graphs never have cycles.
+///   Like the key_class_factory, the registrations must not change while graphs are constructed.
+/// </remarks>
+///
+/// <seealso cref="key_class_factory"/>
+/// <seealso cref="thread_pool"/>
+///
+template<class key_t, class product_t>
+class object_graph_factory final
+{
+public:
+   typedef key_t key_type;
+   typedef product_t product_type;
+   typedef std::shared_ptr<product_type> pointer_type;
+   typedef std::function<pointer_type (std::span<const pointer_type>)> constructor_type;
+
+   object_graph_factory() = default;
+   object_graph_factory(const object_graph_factory&) = delete;
+   object_graph_factory(object_graph_factory&&) = delete;
+
+   ~object_graph_factory() = default;
+
+   object_graph_factory& operator=(const object_graph_factory&) = delete;
+   object_graph_factory& operator=(object_graph_factory&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Registers a constructor under the given key, along with the keys of the products it depends on.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the constructor.</param>
+   /// <param name="constructor">The constructor, which receives the products of the dependencies.</param>
+   /// <param name="dependencies">The keys of the dependencies, which need not be registered yet.</param>
+   ///
+   /// <remarks>A key that is already registered is replaced.</remarks>
+   ///
+   /// <exception cref="std::invalid_argument">When the dependencies lead back to the key. The factory is then unchanged.</exception>
+   ///
+   void register_constructor(const key_type& key,
+                             constructor_type constructor,
+                             std::vector<key_type> dependencies = {})
+   {
+      if (leads_to(dependencies, key))
+      {
+         throw std::invalid_argument("The dependencies of the key lead back to it.");
+      }
+
+      _nodes.insert_or_assign(key, node{ std::move(constructor), std::move(dependencies) });
+      invalidate();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters the constructor that was registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the constructor was registered under.</param>
+   ///
+   /// <remarks>The keys that depend on it then receive nullptr in its place.</remarks>
+   ///
+   void unregister_constructor(const key_type& key)
+   {
+      if (_nodes.erase(key) > 0)
+      {
+         invalidate();
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is registered.
+   /// </summary>
+   ///
+   bool contains(const key_type& key) const
+   {
+      return _nodes.find(key) != std::end(_nodes);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of registered keys.
+   /// </summary>
+   ///
+   std::size_t size() const noexcept
+   {
+      return _nodes.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs the product of the given key, along with all of its dependencies, on the calling thread.
+   /// </summary>
+   ///
+   /// <returns>The product of the key.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   pointer_type construct(const key_type& key) const
+   {
+      const auto found = plan_of(key);
+
+      if (found == nullptr)
+      {
+         return nullptr;
+      }
+
+      std::vector<pointer_type> products(found->steps.size());
+
+      for (std::size_t i = 0; i < found->steps.size(); ++i)
+      {
+         products[i] = run(found->steps[i], products);
+      }
+
+      return products.back();
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs the product of the given key, along with all of its dependencies, running each layer of the plan
+   ///   in parallel on the given thread pool.
+   /// </summary>
+   ///
+   /// <remarks>
+   ///   The calling thread waits for each layer to complete, hence it must not be one of the threads of the pool.
+   ///   The first exception thrown by a constructor is rethrown once its layer has completed.
+   /// </remarks>
+   ///
+   /// <returns>The product of the key.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   pointer_type construct(const key_type& key,
+                          thread_pool& pool) const
+   {
+      const auto found = plan_of(key);
+
+      if (found == nullptr)
+      {
+         return nullptr;
+      }
+
+      std::vector<pointer_type> products(found->steps.size());
+      std::vector<std::future<void>> pending;
+
+      std::size_t begin = 0;
+
+      for (const auto end : found->layer_ends)
+      {
+         // A layer of a single product isn't worth a hop to the pool.
+         if (end - begin == 1)
+         {
+            products[begin] = run(found->steps[begin], products);
+            begin = end;
+            continue;
+         }
+
+         pending.clear();
+
+         for (auto i = begin; i < end; ++i)
+         {
+            pending.push_back(pool.submit([&found, &products, i] { products[i] = run(found->steps[i], products); }));
+         }
+
+         std::exception_ptr failure;
+
+         for (auto& future : pending)
+         {
+            try
+            {
+               future.get();
+            }
+            catch (...)
+            {
+               if (!failure)
+               {
+                  failure = std::current_exception();
+               }
+            }
+         }
+
+         if (failure)
+         {
+            std::rethrow_exception(failure);
+         }
+
+         begin = end;
+      }
+
+      return products.back();
+   }
+
+   ///
+   /// <summary>
+   ///   Get the construction plan of the given key: the registered keys of its graph, in layers that can be constructed
+   ///   one after the other.
+   /// </summary>
+   ///
+   /// <returns>The layers, the last of which holds the key alone. Empty when the given key cannot be found.</returns>
+   ///
+   std::vector<std::vector<key_type>> construction_layers(const key_type& key) const
+   {
+      std::vector<std::vector<key_type>> layers;
+
+      const auto found = plan_of(key);
+
+      if (found != nullptr)
+      {
+         std::size_t begin = 0;
+
+         for (const auto end : found->layer_ends)
+         {
+            layers.emplace_back(std::begin(found->keys) + begin, std::begin(found->keys) + end);
+            begin = end;
+         }
+      }
+
+      return layers;
+   }
+
+private:
+   static constexpr std::size_t missing = static_cast<std::size_t>(-1);
+
+   struct node
+   {
+      constructor_type      constructor;
+      std::vector<key_type> dependencies;
+   };
+
+   struct step
+   {
+      constructor_type         constructor;    // A copy, hence the plan doesn't refer to the nodes.
+      std::vector<std::size_t> dependencies;   // The steps of the dependencies, or missing when they aren't registered.
+   };
+
+   ///
+   /// <summary>
+   ///   The steps are sorted by layer, and the key of the plan is the last step.
+   /// </summary>
+   ///
+   struct plan
+   {
+      std::vector<step>        steps;
+      std::vector<key_type>    keys;
+      std::vector<std::size_t> layer_ends;
+   };
+
+   static pointer_type run(const step& current,
+                           const std::vector<pointer_type>& products)
+   {
+      std::vector<pointer_type> arguments;
+
+      arguments.reserve(current.dependencies.size());
+
+      for (const auto dependency : current.dependencies)
+      {
+         arguments.push_back((dependency != missing) ? products[dependency] : nullptr);
+      }
+
+      return current.constructor(std::span<const pointer_type>(arguments));
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is reachable from any of the given keys, through the registered dependencies.
+   /// </summary>
+   ///
+   bool leads_to(const std::vector<key_type>& from,
+                 const key_type& key) const
+   {
+      std::vector<const key_type*> pending;
+      std::unordered_map<key_type, bool> visited;
+
+      for (const auto& dependency : from)
+      {
+         pending.push_back(&dependency);
+      }
+
+      while (!pending.empty())
+      {
+         const auto& current = *pending.back();
+
+         pending.pop_back();
+
+         if (current == key)
+         {
+            return true;
+         }
+
+         if (!visited.emplace(current, true).second)
+         {
+            continue;
+         }
+
+         const auto found = _nodes.find(current);
+
+         if (found != std::end(_nodes))
+         {
+            for (const auto& dependency : found->second.dependencies)
+            {
+               pending.push_back(&dependency);
+            }
+         }
+      }
+
+      return false;
+   }
+
+   std::shared_ptr<const plan> plan_of(const key_type& key) const
+   {
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+
+         const auto cached = _plans.find(key);
+
+         if (cached != std::end(_plans))
+         {
+            return cached->second;
+         }
+      }
+
+      if (!contains(key))
+      {
+         return nullptr;
+      }
+
+      auto computed = make_plan(key);
+
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      return _plans.emplace(key, std::move(computed)).first->second;
+   }
+
+   ///
+   /// <summary>
+   ///   Sorts the graph of the key topologically. The layer of a key is one past the deepest layer of its dependencies.
+   /// </summary>
+   ///
+   std::shared_ptr<const plan> make_plan(const key_type& key) const
+   {
+      std::unordered_map<key_type, std::size_t> layers;
+      std::vector<const key_type*> order;   // Each key after its dependencies.
+
+      layer_of(key, layers, order);
+
+      std::vector<std::size_t> positions(order.size());
+
+      for (std::size_t i = 0; i < positions.size(); ++i)
+      {
+         positions[i] = i;
+      }
+
+      std::stable_sort(std::begin(positions), std::end(positions),
+                       [&](std::size_t left, std::size_t right) { return layers[*order[left]] < layers[*order[right]]; });
+
+      auto result = std::make_shared<plan>();
+
+      std::unordered_map<key_type, std::size_t> steps;
+
+      for (std::size_t i = 0; i < positions.size(); ++i)
+      {
+         steps.emplace(*order[positions[i]], i);
+      }
+
+      for (const auto position : positions)
+      {
+         const auto& current = *order[position];
+         const auto& source  = _nodes.find(current)->second;
+
+         step added{ source.constructor, {} };
+
+         for (const auto& dependency : source.dependencies)
+         {
+            const auto found = steps.find(dependency);
+
+            added.dependencies.push_back((found != std::end(steps)) ? found->second : missing);
+         }
+
+         const auto layer = layers[current];
+
+         if (!result->keys.empty() && layers[result->keys.back()] != layer)
+         {
+            result->layer_ends.push_back(result->steps.size());
+         }
+
+         result->steps.push_back(std::move(added));
+         result->keys.push_back(current);
+      }
+
+      result->layer_ends.push_back(result->steps.size());
+
+      return result;
+   }
+
+   std::size_t layer_of(const key_type& key,
+                        std::unordered_map<key_type, std::size_t>& layers,
+                        std::vector<const key_type*>& order) const
+   {
+      const auto known = layers.find(key);
+
+      if (known != std::end(layers))
+      {
+         return known->second;
+      }
+
+      const auto found = _nodes.find(key);
+      std::size_t layer = 0;
+
+      for (const auto& dependency : found->second.dependencies)
+      {
+         if (contains(dependency))
+         {
+            layer = (std::max)(layer, layer_of(dependency, layers, order) + 1);
+         }
+      }
+
+      order.push_back(&found->first);
+
+      return layers.emplace(key, layer).first->second;
+   }
+
+   void invalidate()
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _plans.clear();
+   }
+
+   std::unordered_map<key_type, node> _nodes;
+
+   mutable std::mutex                                                  _mutex;
+   mutable std::unordered_map<key_type, std::shared_ptr<const plan>>   _plans;
+};
+}
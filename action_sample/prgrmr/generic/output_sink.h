@@ -0,0 +1,405 @@
+#pragma once
+
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace prgrmr::generic
+{
+
+///
+/// <summary>
+///   The output_sink class is the destination for lines of text produced while running objects.
+///   <para>Text is handed over one complete line at a time, hence lines from different threads never interleave.</para>
+/// </summary>
+///
+/// <seealso cref="output_line"/>
+///
+class output_sink
+{
+public:
+   output_sink() = default;
+   output_sink(const output_sink&) = delete;
+   output_sink(output_sink&&) = delete;
+
+   virtual ~output_sink() = default;
+
+   output_sink& operator=(const output_sink&) = delete;
+   output_sink& operator=(output_sink&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Get the calling thread's buffer in which a line of text is to be appended.
+   /// </summary>
+   ///
+   /// <returns>The buffer to append to, or nullptr when the text is to be discarded.</returns>
+   ///
+   /// <remarks>Every acquired buffer must be handed back with release_line_buffer.</remarks>
+   ///
+   virtual std::string* acquire_line_buffer() = 0;
+
+   ///
+   /// <summary>
+   ///   Hands back a buffer once a complete line has been appended to it.
+   /// </summary>
+   ///
+   /// <param name="buffer">The buffer that was acquired with acquire_line_buffer.</param>
+   ///
+   virtual void release_line_buffer(std::string* buffer) = 0;
+
+   ///
+   /// <summary>
+   ///   Writes out all the lines that are still buffered.
+   /// </summary>
+   ///
+   virtual void flush() = 0;
+};
+
+///
+/// <summary>
+///   The output_line class appends a single line of text to an output sink.
+///   <para>The line, with its terminating new line, is handed over to the sink once the instance goes out of scope.</para>
+/// </summary>
+///
+/// <remarks>Numbers are formatted like std::ostream does by default, without the cost of a stream.</remarks>
+///
+class output_line final
+{
+public:
+   explicit output_line(output_sink& sink)
+   : _sink(sink),
+     _buffer(sink.acquire_line_buffer())
+   {
+   }
+
+   output_line(const output_line&) = delete;
+   output_line(output_line&&) = delete;
+
+   ~output_line()
+   {
+      if (_buffer != nullptr)
+      {
+         _buffer->push_back('\n');
+         _sink.release_line_buffer(_buffer);
+      }
+   }
+
+   output_line& operator=(const output_line&) = delete;
+   output_line& operator=(output_line&&) = delete;
+
+   output_line& operator<<(std::string_view text)
+   {
+      if (_buffer != nullptr)
+      {
+         _buffer->append(text);
+      }
+
+      return *this;
+   }
+
+   output_line& operator<<(const char* text)
+   {
+      return *this << std::string_view(text);
+   }
+
+   output_line& operator<<(char character)
+   {
+      if (_buffer != nullptr)
+      {
+         _buffer->push_back(character);
+      }
+
+      return *this;
+   }
+
+   template<class value_t>
+      requires std::is_arithmetic_v<value_t>
+   output_line& operator<<(value_t value)
+   {
+      if (_buffer == nullptr)
+      {
+         return *this;
+      }
+
+      char text[64];
+      std::to_chars_result result;
+
+      if constexpr (std::is_floating_point_v<value_t>)
+      {
+         result = std::to_chars(std::begin(text), std::end(text), value, std::chars_format::general, 6);
+      }
+      else
+      {
+         result = std::to_chars(std::begin(text), std::end(text), value);
+      }
+
+      _buffer->append(text, result.ptr);
+
+      return *this;
+   }
+
+private:
+   output_sink& _sink;
+   std::string* _buffer;
+};
+
+///
+/// <summary>
+///   The null_output_sink class discards all text, which is useful for measuring execution without any I/O.
+/// </summary>
+///
+class null_output_sink final : public output_sink
+{
+public:
+   std::string* acquire_line_buffer() override
+   {
+      return nullptr;
+   }
+
+   void release_line_buffer(std::string*) override
+   {
+   }
+
+   void flush() override
+   {
+   }
+};
+
+///
+/// <summary>
+///   The buffered_output_sink class appends lines into per-thread buffers and writes them to a file descriptor in batches.
+///   <para>A thread's buffer is written out with a single write call once it reaches the capacity, on flush, when the
+///   thread exits and on destruction.</para>
+/// </summary>
+///
+/// <remarks>
+///   Lines of a given thread keep their order, there is no ordering between lines of different threads.
+///   The buffer of a thread is released when the thread exits, hence a sink that outlives many short lived threads,
+///   such as those of pools and pipelines, only holds the buffers of the threads that are still running.
+/// </remarks>
+///
+class buffered_output_sink final : public output_sink
+{
+public:
+   static constexpr int         standard_output_descriptor = 1;
+   static constexpr int         standard_error_descriptor  = 2;
+   static constexpr std::size_t default_capacity           = 64 * 1024;
+
+   ///
+   /// <summary>
+   ///   Constructs an instance that writes to the given file descriptor.
+   /// </summary>
+   ///
+   /// <param name="descriptor">The file descriptor to write to. It is not closed by this instance.</param>
+   /// <param name="capacity">The number of buffered bytes of a thread that triggers a write.</param>
+   ///
+   explicit buffered_output_sink(int descriptor,
+                                 std::size_t capacity = default_capacity)
+   : _capacity(capacity),
+     _state(std::make_shared<shared_state>(descriptor))
+   {
+   }
+
+   ~buffered_output_sink() override
+   {
+      flush();
+   }
+
+   std::string* acquire_line_buffer() override
+   {
+      auto& buffer = local_buffer();
+
+      buffer.mutex.lock();
+
+      return std::addressof(buffer.text);
+   }
+
+   void release_line_buffer(std::string* text) override
+   {
+      auto& buffer = local_buffer();
+
+      if (text->size() >= _capacity)
+      {
+         write_all(_state->descriptor, *text);
+      }
+
+      buffer.mutex.unlock();
+   }
+
+   void flush() override
+   {
+      std::lock_guard<std::mutex> lock(_state->mutex);
+
+      for (const auto& buffer : _state->buffers)
+      {
+         std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+
+         write_all(_state->descriptor, buffer->text);
+      }
+   }
+
+private:
+   struct thread_buffer
+   {
+      std::mutex  mutex;
+      std::string text;
+   };
+
+   ///
+   /// <summary>
+   ///   The buffers of the running threads, which a thread that exits may still reach after the sink is destroyed.
+   /// </summary>
+   ///
+   struct shared_state
+   {
+      explicit shared_state(int descriptor) : descriptor(descriptor)
+      {
+      }
+
+      const int                                   descriptor;
+      std::mutex                                  mutex;
+      std::vector<std::shared_ptr<thread_buffer>> buffers;
+   };
+
+   struct cached_buffer
+   {
+      std::uint64_t                  sink_id;
+      std::weak_ptr<shared_state>    sink;
+      std::shared_ptr<thread_buffer> buffer;
+   };
+
+   ///
+   /// <summary>
+   ///   The buffers of a thread, one per sink it writes to, which are written out and released when the thread exits.
+   /// </summary>
+   ///
+   struct thread_buffers
+   {
+      thread_buffers() = default;
+      thread_buffers(const thread_buffers&) = delete;
+
+      ~thread_buffers()
+      {
+         for (auto& entry : entries)
+         {
+            release(entry);
+         }
+      }
+
+      thread_buffers& operator=(const thread_buffers&) = delete;
+
+      std::vector<cached_buffer> entries;
+   };
+
+   static std::uint64_t next_id()
+   {
+      static std::atomic<std::uint64_t> id{0};
+
+      return ++id;
+   }
+
+   thread_buffer& local_buffer()
+   {
+      // Sink identifiers are never reused, thus entries of destroyed sinks are never matched.
+      thread_local thread_buffers cache;
+
+      for (const auto& entry : cache.entries)
+      {
+         if (entry.sink_id == _id)
+         {
+            return *entry.buffer;
+         }
+      }
+
+      // The entries of the sinks that were destroyed since are dropped with their buffers.
+      std::erase_if(cache.entries, [](const cached_buffer& entry) { return entry.sink.expired(); });
+
+      auto buffer = std::make_shared<thread_buffer>();
+
+      buffer->text.reserve(_capacity + _capacity / 4);
+
+      {
+         std::lock_guard<std::mutex> lock(_state->mutex);
+
+         _state->buffers.push_back(buffer);
+      }
+
+      cache.entries.push_back({_id, _state, buffer});
+
+      return *buffer;
+   }
+
+   ///
+   /// <summary>
+   ///   Writes out the buffer of an exiting thread, and removes it from its sink, unless the sink was destroyed.
+   /// </summary>
+   ///
+   static void release(cached_buffer& entry)
+   {
+      const auto state = entry.sink.lock();
+
+      if (state == nullptr)
+      {
+         return;
+      }
+
+      std::lock_guard<std::mutex> lock(state->mutex);
+
+      {
+         std::lock_guard<std::mutex> buffer_lock(entry.buffer->mutex);
+
+         write_all(state->descriptor, entry.buffer->text);
+      }
+
+      std::erase(state->buffers, entry.buffer);
+   }
+
+   static void write_all(int descriptor,
+                         std::string& text)
+   {
+      const char* data      = text.data();
+      std::size_t remaining = text.size();
+
+      while (remaining > 0)
+      {
+#if defined(_WIN32)
+         const auto written = ::_write(descriptor, data, static_cast<unsigned int>(remaining));
+#else
+         const auto written = ::write(descriptor, data, remaining);
+#endif
+         if (written < 0)
+         {
+            if (errno == EINTR)
+            {
+               continue;
+            }
+
+            break;
+         }
+
+         data      += written;
+         remaining -= static_cast<std::size_t>(written);
+      }
+
+      text.clear();
+   }
+
+   const std::uint64_t           _id = next_id();
+   const std::size_t             _capacity;
+   std::shared_ptr<shared_state> _state;
+};
+}
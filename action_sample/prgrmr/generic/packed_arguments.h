@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   Expression to indicate if the given arguments can be packed into a buffer of bytes, i.e. they are all trivially copyable.
+/// </summary>
+///
+template<class... args_t>
+inline constexpr bool are_packable = (std::is_trivially_copyable_v<std::decay_t<args_t>> && ...);
+
+///
+/// <summary>
+///   The number of bytes taken by the given arguments once packed.
+/// </summary>
+///
+/// <remarks>The arguments are laid out back to back, without any padding.</remarks>
+///
+template<class... args_t>
+inline constexpr std::size_t packed_size = (std::size_t{0} + ... + sizeof(std::decay_t<args_t>));
+
+///
+/// <summary>
+///   Packs the given arguments into a buffer of bytes, back to back and without any padding.
+/// </summary>
+///
+/// <param name="buffer">The buffer to write to, which must be at least packed_size bytes.</param>
+/// <param name="args">The arguments to pack, of the exact types of the signature that is to be invoked.</param>
+///
+/// <returns>The number of bytes that were written.</returns>
+///
+template<class... args_t>
+   requires are_packable<args_t...>
+std::size_t pack_arguments_into(std::span<std::byte> buffer,
+                                const args_t&... args) noexcept
+{
+   std::size_t offset = 0;
+
+   ((std::memcpy(buffer.data() + offset, std::addressof(args), sizeof(args_t)), offset += sizeof(args_t)), ...);
+
+   return offset;
+}
+
+///
+/// <summary>
+///   Packs the given arguments into an array of bytes, back to back and without any padding.
+/// </summary>
+///
+/// <remarks>Spell out the argument types, e.g. pack_arguments&lt;int, float&gt;(5, 5.0f), to match the signature exactly.</remarks>
+///
+template<class... args_t>
+   requires are_packable<args_t...>
+std::array<std::byte, packed_size<args_t...>> pack_arguments(const args_t&... args) noexcept
+{
+   std::array<std::byte, packed_size<args_t...>> buffer{};
+
+   pack_arguments_into<args_t...>(buffer, args...);
+
+   return buffer;
+}
+
+namespace detail
+{
+template<class arg_t>
+arg_t read_packed(const std::byte* data) noexcept
+{
+   std::array<std::byte, sizeof(arg_t)> bytes;
+
+   std::memcpy(bytes.data(), data, sizeof(arg_t));
+
+   return std::bit_cast<arg_t>(bytes);
+}
+
+template<class... args_t, std::size_t... index_t>
+std::tuple<args_t...> unpack_arguments(std::span<const std::byte> buffer,
+                                       std::index_sequence<index_t...>) noexcept
+{
+   constexpr std::array<std::size_t, sizeof...(args_t)> sizes = { sizeof(args_t)... };
+
+   [[maybe_unused]] constexpr auto offsets = [&sizes]
+   {
+      std::array<std::size_t, sizeof...(args_t)> offsets{};
+
+      for (std::size_t i = 1; i < offsets.size(); ++i)
+      {
+         offsets[i] = offsets[i - 1] + sizes[i - 1];
+      }
+
+      return offsets;
+   }();
+
+   return std::tuple<args_t...>{ read_packed<args_t>(buffer.data() + offsets[index_t])... };
+}
+}
+
+///
+/// <summary>
+///   Unpacks arguments that were packed with pack_arguments.
+/// </summary>
+///
+/// <param name="buffer">The packed arguments, which must be exactly packed_size bytes.</param>
+///
+template<class... args_t>
+   requires are_packable<args_t...>
+std::tuple<args_t...> unpack_arguments(std::span<const std::byte> buffer) noexcept
+{
+   return detail::unpack_arguments<args_t...>(buffer, std::index_sequence_for<args_t...>{});
+}
+}
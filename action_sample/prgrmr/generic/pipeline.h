@@ -0,0 +1,662 @@
+#pragma once
+
+#include "function_traits.h"
+#include "mpmc_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The configuration of a construct_execute_pipeline.
+/// </summary>
+///
+struct pipeline_options
+{
+   std::size_t constructors = 1;      // The threads that construct the products.
+   std::size_t executors    = 1;      // The threads that execute the products.
+   std::size_t capacity     = 1024;   // The products in flight, rounded up to a power of two.
+};
+
+///
+/// <summary>
+///   The counters of a stage of a construct_execute_pipeline, summed over its threads.
+/// </summary>
+///
+struct pipeline_stage_statistics
+{
+   std::uint64_t items         = 0;
+   std::uint64_t busy_ns       = 0;   // The time spent constructing, or executing.
+   std::uint64_t queued_ns     = 0;   // The time the items waited in the queue of the stage.
+   std::uint64_t max_queued_ns = 0;
+
+   double mean_busy_ns() const noexcept
+   {
+      return (items > 0) ? static_cast<double>(busy_ns) / static_cast<double>(items) : 0.0;
+   }
+
+   double mean_queued_ns() const noexcept
+   {
+      return (items > 0) ? static_cast<double>(queued_ns) / static_cast<double>(items) : 0.0;
+   }
+
+   pipeline_stage_statistics& operator+=(const pipeline_stage_statistics& other) noexcept
+   {
+      items         += other.items;
+      busy_ns       += other.busy_ns;
+      queued_ns     += other.queued_ns;
+      max_queued_ns  = (std::max)(max_queued_ns, other.max_queued_ns);
+      return *this;
+   }
+};
+
+///
+/// <summary>
+///   The counters of a construct_execute_pipeline.
+/// </summary>
+///
+struct pipeline_statistics
+{
+   pipeline_stage_statistics construct;
+   pipeline_stage_statistics execute;
+   std::uint64_t failed     = 0;   // The keys whose product couldn't be constructed.
+   std::uint64_t recycled   = 0;   // The products that were reused rather than constructed.
+   std::uint64_t stalls     = 0;   // The pushes that waited for a product in flight to complete.
+   std::uint64_t elapsed_ns = 0;   // From the start of the pipeline until its threads completed.
+
+   ///
+   /// <summary>
+   ///   Get the number of products executed per second.
+   /// </summary>
+   ///
+   double throughput() const noexcept
+   {
+      return (elapsed_ns > 0) ? static_cast<double>(execute.items) * 1e9 / static_cast<double>(elapsed_ns) : 0.0;
+   }
+};
+
+namespace detail
+{
+template<class result_t, class key_t, class tuple_t>
+struct pipeline_recycle;
+
+template<class result_t, class key_t, class... args_t>
+struct pipeline_recycle<result_t, key_t, std::tuple<args_t...>>
+{
+   typedef std::function<bool (result_t&, const key_t&, const args_t&...)> type;
+};
+}
+
+///
+/// <summary>
+///   The construct_execute_pipeline class constructs products with a factory on some threads, and executes them on
+///   other threads.
+///   <para>The keys and the arguments that are pushed are constructed by the constructing threads, which hand the
+///   products over to the executing threads. Once executed, a product flows back to the constructing threads, which
+///   either recycle it for a following key, or destroy it.</para>
+///   <para>The products in flight lie in a fixed array of slots, whose indices travel through three mpmc_queue: the free
+///   slots, the slots to construct and the slots to execute. Hence the stages never take a lock, nor allocate.</para>
+/// </summary>
+///
+/// <remarks>
+///   Each stage keeps its counters per thread, and sums them once its threads complete.
+///   A push waits while every slot is in flight, which holds the producers back to the pace of the slowest stage.
+///   A thread that finds nothing to take, or a push that finds no free slot, spins for a while, then sleeps until the
+///   queue it waits for is pushed to. The pushes only pay for a wake up while a thread sleeps on their queue.
+///   The keys can be pushed by many threads at once, and close must only be invoked once they are all pushed.
+///   The factory must not change while the pipeline runs, as for any construction from many threads.
+///   The first exception thrown by a construction or an execution is rethrown by wait; its product is dropped.
+/// </remarks>
+///
+/// <seealso cref="mpmc_queue"/>
+///
+template<class factory_t, class function_t>
+class construct_execute_pipeline final
+{
+public:
+   typedef factory_t factory_type;
+   typedef typename factory_type::key_type key_type;
+   typedef function_t function_type;
+   typedef function_result_t<function_type> result_type;
+   typedef typename function_traits<function_type>::decayed_argument_types argument_types;
+
+   ///
+   /// <summary>
+   ///   Executes a product.
+   /// </summary>
+   ///
+   typedef std::function<void (result_type&)> execute_type;
+
+   ///
+   /// <summary>
+   ///   Reinitializes an executed product for the given key and arguments, instead of constructing another.
+   /// </summary>
+   ///
+   /// <returns>false when the product cannot be reused, in which case it is destroyed and a product is constructed.</returns>
+   ///
+   typedef typename detail::pipeline_recycle<result_type, key_type, argument_types>::type recycle_type;
+
+   ///
+   /// <summary>
+   ///   Starts the threads of the pipeline.
+   /// </summary>
+   ///
+   /// <param name="factory">The factory that constructs the products, which must outlive the pipeline.</param>
+   /// <param name="execute">Executes each product.</param>
+   /// <param name="options">The number of threads of each stage, and of products in flight.</param>
+   /// <param name="recycle">Reinitializes the executed products, when it is set.</param>
+   ///
+   construct_execute_pipeline(const factory_type& factory,
+                              execute_type execute,
+                              pipeline_options options = {},
+                              recycle_type recycle = nullptr)
+   : _factory(factory),
+     _execute(std::move(execute)),
+     _recycle(std::move(recycle)),
+     _free(options.capacity),
+     _constructing(_free.capacity()),
+     _executing(_free.capacity()),
+     _slots(_free.capacity()),
+     _start(now())
+   {
+      for (std::size_t i = 0; i < _slots.size(); ++i)
+      {
+         _free.try_push(static_cast<std::uint32_t>(i));
+      }
+
+      const auto constructors = (std::max)(options.constructors, std::size_t(1));
+      const auto executors    = (std::max)(options.executors, std::size_t(1));
+
+      _running_constructors.store(constructors, std::memory_order_relaxed);
+      _running_threads.store(constructors + executors, std::memory_order_relaxed);
+
+      for (std::size_t i = 0; i < constructors; ++i)
+      {
+         _threads.emplace_back([this] { run_constructor(); });
+      }
+
+      for (std::size_t i = 0; i < executors; ++i)
+      {
+         _threads.emplace_back([this] { run_executor(); });
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Starts the threads of a pipeline that executes the products by invoking their do_it method.
+   /// </summary>
+   ///
+   explicit construct_execute_pipeline(const factory_type& factory,
+                                       pipeline_options options = {},
+                                       recycle_type recycle = nullptr)
+      requires requires(result_type& product) { product->do_it(); }
+   : construct_execute_pipeline(factory, [](result_type& product) { product->do_it(); }, options, std::move(recycle))
+   {
+   }
+
+   construct_execute_pipeline(const construct_execute_pipeline&) = delete;
+   construct_execute_pipeline(construct_execute_pipeline&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Completes the products that were pushed, then stops the threads.
+   /// </summary>
+   ///
+   ~construct_execute_pipeline()
+   {
+      close();
+      join();
+   }
+
+   construct_execute_pipeline& operator=(const construct_execute_pipeline&) = delete;
+   construct_execute_pipeline& operator=(construct_execute_pipeline&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Pushes a key and the arguments of its construction, waiting while every product is in flight.
+   /// </summary>
+   ///
+   template<class... args_t>
+   void push(const key_type& key,
+             args_t&&... args)
+   {
+      std::uint32_t slot = 0;
+
+      if (!_free.try_pop(slot))
+      {
+         _stalls.fetch_add(1, std::memory_order_relaxed);
+
+         for (unsigned attempt = 0; !_free.try_pop(slot); )
+         {
+            if (attempt < spin_limit)
+            {
+               back_off(attempt);
+            }
+            else
+            {
+               _free_signal.wait_unless([this] { return _free.size_hint() > 0; });
+            }
+         }
+      }
+
+      enqueue(slot, key, std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Pushes a key and the arguments of its construction, unless every product is in flight.
+   /// </summary>
+   ///
+   /// <returns>false when every product is in flight, in which case nothing is pushed.</returns>
+   ///
+   template<class... args_t>
+   bool try_push(const key_type& key,
+                 args_t&&... args)
+   {
+      std::uint32_t slot = 0;
+
+      if (!_free.try_pop(slot))
+      {
+         return false;
+      }
+
+      enqueue(slot, key, std::forward<args_t>(args)...);
+      return true;
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates that all the keys are pushed, hence the threads stop once their products are executed.
+   /// </summary>
+   ///
+   void close() noexcept
+   {
+      _closed.store(true, std::memory_order_release);
+      _constructing_signal.notify_all();
+   }
+
+   ///
+   /// <summary>
+   ///   Closes the pipeline, then waits for all the products to be executed.
+   /// </summary>
+   ///
+   /// <exception cref="std::exception">The first exception thrown by a construction or an execution.</exception>
+   ///
+   void wait()
+   {
+      close();
+      join();
+
+      std::exception_ptr failure;
+
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         failure = std::exchange(_failure, nullptr);
+      }
+
+      if (failure)
+      {
+         std::rethrow_exception(failure);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Get the counters of the pipeline, which are complete once wait returned.
+   /// </summary>
+   ///
+   pipeline_statistics statistics() const
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      auto result = _statistics;
+
+      result.stalls = _stalls.load(std::memory_order_relaxed);
+      return result;
+   }
+
+private:
+   struct slot_type
+   {
+      key_type       key{};
+      argument_types arguments{};
+      result_type    product{};
+      std::uint64_t  queued_ns = 0;   // When the slot was pushed into the queue of its current stage.
+   };
+
+   ///
+   /// <summary>
+   ///   Puts the threads that wait on a queue to sleep, and wakes them once it is pushed to.
+   /// </summary>
+   ///
+   /// <remarks>
+   ///   A sleeper is counted before it checks the queue one last time, and a push checks the count after it pushed, with
+   ///   a full fence on each side. Hence either the sleeper sees the push, or the push sees the sleeper and bumps the
+   ///   epoch that the sleeper waits on.
+   /// </remarks>
+   ///
+   class signal final
+   {
+   public:
+      ///
+      /// <summary>
+      ///   Sleeps until the queue is pushed to, unless ready returns true once the thread is counted as a sleeper.
+      /// </summary>
+      ///
+      template<class ready_t>
+      void wait_unless(ready_t&& ready) noexcept
+      {
+         _sleepers.fetch_add(1, std::memory_order_relaxed);
+         std::atomic_thread_fence(std::memory_order_seq_cst);
+
+         const auto epoch = _epoch.load(std::memory_order_relaxed);
+
+         if (!ready())
+         {
+            _epoch.wait(epoch, std::memory_order_relaxed);
+         }
+
+         _sleepers.fetch_sub(1, std::memory_order_relaxed);
+      }
+
+      void notify_one() noexcept
+      {
+         if (has_sleepers())
+         {
+            _epoch.fetch_add(1, std::memory_order_relaxed);
+            _epoch.notify_one();
+         }
+      }
+
+      void notify_all() noexcept
+      {
+         if (has_sleepers())
+         {
+            _epoch.fetch_add(1, std::memory_order_relaxed);
+            _epoch.notify_all();
+         }
+      }
+
+   private:
+      bool has_sleepers() const noexcept
+      {
+         std::atomic_thread_fence(std::memory_order_seq_cst);
+
+         return _sleepers.load(std::memory_order_relaxed) != 0;
+      }
+
+      alignas(64) std::atomic<std::uint32_t> _epoch{0};
+      std::atomic<std::uint32_t>             _sleepers{0};
+   };
+
+   // The attempts that spin or yield before a thread sleeps, a few tens of microseconds: a stage that merely lags
+   // behind is waited for without a system call, while an idle one stops using its core.
+   static constexpr unsigned spin_limit = 256;
+
+   static std::uint64_t now() noexcept
+   {
+      return static_cast<std::uint64_t>(
+         std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+   }
+
+   ///
+   /// <summary>
+   ///   Spins a few times, then yields, since the other side usually completes within a few hundred cycles. The waits
+   ///   that may last, for a slot to take or a free one, sleep on a signal once spin_limit attempts are spent.
+   /// </summary>
+   ///
+   static void back_off(unsigned& attempt) noexcept
+   {
+      if (++attempt > 16)
+      {
+         std::this_thread::yield();
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Pushes a slot into a queue that cannot be full, since it has room for every slot, yet a push may have to wait for
+   ///   the pop of the previous lap of its cell to complete.
+   /// </summary>
+   ///
+   static void hand_over(mpmc_queue<std::uint32_t>& queue,
+                         signal& pushed,
+                         std::uint32_t slot) noexcept
+   {
+      for (unsigned attempt = 0; !queue.try_push(slot); )
+      {
+         back_off(attempt);
+      }
+
+      pushed.notify_one();
+   }
+
+   ///
+   /// <summary>
+   ///   Pops a slot from the queue of a stage, until the previous stage is complete and the queue is empty.
+   /// </summary>
+   ///
+   static bool take(mpmc_queue<std::uint32_t>& queue,
+                    signal& pushed,
+                    const std::atomic<bool>& complete,
+                    std::uint32_t& slot) noexcept
+   {
+      for (unsigned attempt = 0; !queue.try_pop(slot); )
+      {
+         // All the pushes happen before the previous stage completes, hence a last pop after it sees them all.
+         if (complete.load(std::memory_order_acquire))
+         {
+            return queue.try_pop(slot);
+         }
+
+         if (attempt < spin_limit)
+         {
+            back_off(attempt);
+         }
+         else
+         {
+            pushed.wait_unless([&] { return queue.size_hint() > 0 || complete.load(std::memory_order_acquire); });
+         }
+      }
+
+      return true;
+   }
+
+   template<class... args_t>
+   void enqueue(std::uint32_t slot,
+                const key_type& key,
+                args_t&&... args)
+   {
+      auto& current = _slots[slot];
+
+      current.key       = key;
+      current.arguments = argument_types(std::forward<args_t>(args)...);
+      current.queued_ns = now();
+
+      hand_over(_constructing, _constructing_signal, slot);
+   }
+
+   void run_constructor()
+   {
+      pipeline_stage_statistics statistics;
+      std::uint64_t failed   = 0;
+      std::uint64_t recycled = 0;
+      std::uint32_t slot     = 0;
+
+      while (take(_constructing, _constructing_signal, _closed, slot))
+      {
+         auto& current = _slots[slot];
+         const auto start = now();
+
+         account(statistics, start - current.queued_ns);
+
+         try
+         {
+            if (current.product != nullptr && _recycle && reuse(current))
+            {
+               ++recycled;
+            }
+            else
+            {
+               // The product that was executed is destroyed here, rather than on an executing thread.
+               current.product = nullptr;
+               current.product = std::apply([this, &current](const auto&... args)
+                                            {
+                                               return _factory.template construct<function_type>(current.key, args...);
+                                            },
+                                            current.arguments);
+            }
+         }
+         catch (...)
+         {
+            current.product = nullptr;
+            fail(std::current_exception());
+         }
+
+         const auto end = now();
+
+         statistics.busy_ns += end - start;
+
+         if (current.product == nullptr)
+         {
+            ++failed;
+            hand_over(_free, _free_signal, slot);
+            continue;
+         }
+
+         current.queued_ns = end;
+         hand_over(_executing, _executing_signal, slot);
+      }
+
+      if (_running_constructors.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+         _constructed.store(true, std::memory_order_release);
+         _executing_signal.notify_all();
+      }
+
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      _statistics.construct += statistics;
+      _statistics.failed    += failed;
+      _statistics.recycled  += recycled;
+      complete();
+   }
+
+   void run_executor()
+   {
+      pipeline_stage_statistics statistics;
+      std::uint32_t slot = 0;
+
+      while (take(_executing, _executing_signal, _constructed, slot))
+      {
+         auto& current = _slots[slot];
+         const auto start = now();
+
+         account(statistics, start - current.queued_ns);
+
+         try
+         {
+            _execute(current.product);
+         }
+         catch (...)
+         {
+            current.product = nullptr;
+            fail(std::current_exception());
+         }
+
+         statistics.busy_ns += now() - start;
+         hand_over(_free, _free_signal, slot);
+      }
+
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      _statistics.execute += statistics;
+      complete();
+   }
+
+   bool reuse(slot_type& current)
+   {
+      return std::apply([this, &current](const auto&... args) { return _recycle(current.product, current.key, args...); },
+                        current.arguments);
+   }
+
+   static void account(pipeline_stage_statistics& statistics,
+                       std::uint64_t queued_ns) noexcept
+   {
+      ++statistics.items;
+      statistics.queued_ns     += queued_ns;
+      statistics.max_queued_ns  = (std::max)(statistics.max_queued_ns, queued_ns);
+   }
+
+   void fail(std::exception_ptr failure)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      if (!_failure)
+      {
+         _failure = std::move(failure);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Records the elapsed time once the last thread completes. The mutex must be held.
+   /// </summary>
+   ///
+   void complete() noexcept
+   {
+      if (_running_threads.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+         _statistics.elapsed_ns = now() - _start;
+      }
+   }
+
+   void join()
+   {
+      for (auto& thread : _threads)
+      {
+         if (thread.joinable())
+         {
+            thread.join();
+         }
+      }
+   }
+
+   const factory_type& _factory;
+   execute_type        _execute;
+   recycle_type        _recycle;
+
+   mpmc_queue<std::uint32_t> _free;
+   mpmc_queue<std::uint32_t> _constructing;
+   mpmc_queue<std::uint32_t> _executing;
+   std::vector<slot_type>    _slots;
+
+   std::uint64_t _start;
+
+   alignas(64) std::atomic<bool>          _closed{false};
+   alignas(64) std::atomic<bool>          _constructed{false};
+   std::atomic<std::size_t>               _running_constructors{0};
+   std::atomic<std::size_t>               _running_threads{0};
+   alignas(64) std::atomic<std::uint64_t> _stalls{0};
+
+   signal _free_signal;
+   signal _constructing_signal;
+   signal _executing_signal;
+
+   mutable std::mutex       _mutex;
+   pipeline_statistics      _statistics;
+   std::exception_ptr       _failure;
+   std::vector<std::thread> _threads;
+};
+}
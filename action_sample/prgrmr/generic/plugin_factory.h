@@ -0,0 +1,363 @@
+#pragma once
+
+#include "factory.h"
+#include "shared_library.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The plugin_key_class_factory class is a key_class_factory whose keys can be provided by plugins, loaded on demand.
+///   <para>A catalog maps keys to the shared library of their plugin, and to the function it exports to register them.</para>
+///   <para>The first construction with a key that isn't registered loads its plugin, which registers its keys, then
+///   the construction is retried. Hence only the plugins that are used are ever loaded.</para>
+/// </summary>
+///
+/// <remarks>
+///   Each plugin is loaded at most once: concurrent misses wait for the same load. A plugin that fails to load isn't
+///   retried, unless its registration function threw. The plugins are never unloaded.
+///   The registration function of a plugin must be exported with PRGRMR_PLUGIN_EXPORT, and built against the same
+///   factory type, since it receives the underlying key_class_factory.
+///   The methods can be invoked by many threads at once.
+/// </remarks>
+///
+/// <seealso cref="key_class_factory"/>
+/// <seealso cref="shared_library"/>
+///
+template<class key_t, class... functions_t>
+class plugin_key_class_factory final
+{
+public:
+   typedef key_t key_type;
+   using function_types = std::tuple<functions_t...>;
+   typedef key_class_factory<key_type, functions_t...> factory_type;
+   typedef typename factory_type::delegate_type delegate_type;
+
+   ///
+   /// <summary>
+   ///   The signature of the function that a plugin exports to register its keys.
+   /// </summary>
+   ///
+   typedef void (plugin_entry_type)(factory_type& factory);
+
+   plugin_key_class_factory() = default;
+   plugin_key_class_factory(const plugin_key_class_factory&) = delete;
+   plugin_key_class_factory(plugin_key_class_factory&&) = delete;
+
+   ~plugin_key_class_factory() = default;
+
+   plugin_key_class_factory& operator=(const plugin_key_class_factory&) = delete;
+   plugin_key_class_factory& operator=(plugin_key_class_factory&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Adds a key to the catalog, without loading its plugin.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key that the plugin registers.</param>
+   /// <param name="path">The path of the shared library of the plugin.</param>
+   /// <param name="entry">The name of the function that the plugin exports to register its keys.</param>
+   ///
+   /// <remarks>The keys of a plugin share a single load of its library.</remarks>
+   ///
+   void register_plugin(const key_type& key,
+                        const std::string& path,
+                        const std::string& entry)
+   {
+      std::unique_lock<std::shared_mutex> lock(_mutex);
+
+      auto& found = _plugins[path + '\0' + entry];
+
+      if (found == nullptr)
+      {
+         found = std::make_unique<plugin>();
+         found->path  = path;
+         found->entry = entry;
+      }
+
+      _catalog.insert_or_assign(key, found.get());
+   }
+
+   ///
+   /// <summary>
+   ///   Registers all the delegate under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   void register_delegate(const key_type& key,
+                          const delegate_type& delegate)
+   {
+      std::unique_lock<std::shared_mutex> lock(_mutex);
+      _factory.register_delegate(key, delegate);
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the functions under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with these function signatures.</param>
+   /// <param name="functions">The functions that are to be registered.</param>
+   ///
+   void register_functions(const key_type& key,
+                           function_types functions)
+   {
+      std::unique_lock<std::shared_mutex> lock(_mutex);
+      _factory.register_functions(key, std::move(functions));
+   }
+
+   ///
+   /// <summary>
+   ///   Registers a single function under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with this function.</param>
+   /// <param name="function">The function that is to be registered.</param>
+   ///
+   template<class function_t>
+   void register_function(const key_type& key,
+                          function_t function)
+   {
+      std::unique_lock<std::shared_mutex> lock(_mutex);
+      _factory.register_function(key, std::move(function));
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters all the functions that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   /// <remarks>A plugin that was already loaded isn't loaded again, hence its keys remain unregistered.</remarks>
+   ///
+   void unregister_delegate(const key_type& key)
+   {
+      std::unique_lock<std::shared_mutex> lock(_mutex);
+      _factory.unregister_delegate(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<class function_t>
+   void unregister_function(const key_type& key)
+   {
+      std::unique_lock<std::shared_mutex> lock(_mutex);
+      _factory.template unregister_function<function_t>(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<int index_t>
+   void unregister_function(const key_type& key)
+   {
+      std::unique_lock<std::shared_mutex> lock(_mutex);
+      _factory.template unregister_function<index_t>(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, loading the plugin of the key when it isn't registered yet.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found, even once its plugin is loaded.<returns>
+   ///
+   template<class function_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const -> typename function_t::result_type
+   {
+      auto function = find_function<function_t>(key);
+
+      return (function)
+             ? function(std::forward<args_t>(args)...)
+             : nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, loading the plugin of the key when it isn't registered yet.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found, even once its plugin is loaded.<returns>
+   ///
+   template<int index_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const
+   {
+      auto function = find_function<index_t>(key);
+
+      return (function)
+             ? function(std::forward<args_t>(args)...)
+             : decltype(function(std::forward<args_t>(args)...))(nullptr);
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is registered, without loading its plugin.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for.</param>
+   ///
+   bool contains(const key_type& key) const
+   {
+      std::shared_lock<std::shared_mutex> lock(_mutex);
+      return _factory.contains(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the plugin of the given key is loaded.
+   /// </summary>
+   ///
+   bool is_plugin_loaded(const key_type& key) const
+   {
+      const auto* found = plugin_of(key);
+
+      return found != nullptr && found->loaded.load(std::memory_order_acquire);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the description of the failure to load the plugin of the given key.
+   /// </summary>
+   ///
+   /// <returns>An empty string when the plugin didn't fail to load, or isn't in the catalog.</returns>
+   ///
+   std::string plugin_error(const key_type& key) const
+   {
+      auto* found = plugin_of(key);
+
+      if (found == nullptr || !found->failed.load(std::memory_order_acquire))
+      {
+         return std::string();
+      }
+
+      return found->library.error();
+   }
+
+private:
+   struct plugin
+   {
+      std::string       path;
+      std::string       entry;
+      std::once_flag    once;
+      shared_library    library;
+      std::atomic<bool> loaded{false};
+      std::atomic<bool> failed{false};
+   };
+
+   template<class function_t>
+   auto find_function(const key_type& key) const
+   {
+      {
+         std::shared_lock<std::shared_mutex> lock(_mutex);
+
+         auto function = _factory.template get_function<function_t>(key);
+
+         if (function || !_catalog.contains(key))
+         {
+            return function;
+         }
+      }
+
+      load(key);
+
+      std::shared_lock<std::shared_mutex> lock(_mutex);
+      return _factory.template get_function<function_t>(key);
+   }
+
+   template<int index_t>
+   auto find_function(const key_type& key) const
+   {
+      {
+         std::shared_lock<std::shared_mutex> lock(_mutex);
+
+         auto function = _factory.template get_function<index_t>(key);
+
+         if (function || !_catalog.contains(key))
+         {
+            return function;
+         }
+      }
+
+      load(key);
+
+      std::shared_lock<std::shared_mutex> lock(_mutex);
+      return _factory.template get_function<index_t>(key);
+   }
+
+   plugin* plugin_of(const key_type& key) const
+   {
+      std::shared_lock<std::shared_mutex> lock(_mutex);
+
+      const auto found = _catalog.find(key);
+
+      return (found != std::end(_catalog)) ? found->second : nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Loads the plugin of the key once, then lets it register its keys under an exclusive lock.
+   /// </summary>
+   ///
+   void load(const key_type& key) const
+   {
+      auto* found = plugin_of(key);
+
+      if (found == nullptr)
+      {
+         return;
+      }
+
+      std::call_once(found->once, [this, found]
+      {
+         auto& library = found->library;
+         auto* entry   = library.open(found->path) ? library.template symbol<plugin_entry_type>(found->entry) : nullptr;
+
+         if (entry == nullptr)
+         {
+            found->failed.store(true, std::memory_order_release);
+            return;
+         }
+
+         {
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            entry(_factory);
+         }
+
+         found->loaded.store(true, std::memory_order_release);
+      });
+   }
+
+   mutable std::shared_mutex _mutex;
+   mutable factory_type      _factory;
+
+   std::unordered_map<key_type, plugin*>                     _catalog;
+   std::unordered_map<std::string, std::unique_ptr<plugin>>  _plugins;   // By path and entry.
+};
+}
@@ -0,0 +1,363 @@
+#pragma once
+
+#include "factory.h"
+#include "radix_trie.h"
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The prefix_key_class_factory class is a key_class_factory whose keys are also indexed in a radix trie.
+///   <para>Hierarchical keys, such as "nike/running/runner", can then be enumerated and unregistered by prefix.</para>
+///   <para>A key that isn't registered can also fall back on the longest registered key that is a prefix of it.</para>
+/// </summary>
+///
+/// <remarks>
+///   The cost of the prefix operations is proportional to the prefix and to the keys found, not to the number of keys.
+///   Prefixes match whole segments of the keys, separated by '/': "nike/run" doesn't match "nike/running".
+/// </remarks>
+///
+/// <seealso cref="key_class_factory"/>
+/// <seealso cref="radix_trie"/>
+///
+template<class key_t, class... functions_t>
+class prefix_key_class_factory final
+{
+public:
+   typedef key_t key_type;
+   using function_types = std::tuple<functions_t...>;
+   typedef key_class_factory<key_type, functions_t...> factory_type;
+   typedef typename factory_type::delegate_type delegate_type;
+
+   static_assert(std::is_convertible_v<const key_type&, std::string_view> && std::is_constructible_v<key_type, std::string>,
+                 "The keys of a prefix factory must be strings.");
+
+   prefix_key_class_factory() = default;
+   prefix_key_class_factory(const prefix_key_class_factory&) = default;
+   prefix_key_class_factory(prefix_key_class_factory&&) = default;
+
+   ~prefix_key_class_factory() = default;
+
+   prefix_key_class_factory& operator=(const prefix_key_class_factory&) = default;
+   prefix_key_class_factory& operator=(prefix_key_class_factory&&) = default;
+
+   ///
+   /// <summary>
+   ///   Registers all the delegate under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   void register_delegate(const key_type& key,
+                          const delegate_type& delegate)
+   {
+      _factory.register_delegate(key, delegate);
+      _keys.insert(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the functions under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with these function signatures.</param>
+   /// <param name="functions">The functions that are to be registered.</param>
+   ///
+   void register_functions(const key_type& key,
+                           function_types functions)
+   {
+      _factory.register_functions(key, std::move(functions));
+      _keys.insert(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Registers a single function under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with this function.</param>
+   /// <param name="function">The function that is to be registered.</param>
+   ///
+   template<class function_t>
+   void register_function(const key_type& key,
+                          function_t function)
+   {
+      _factory.register_function(key, std::move(function));
+      _keys.insert(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters all the functions that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   void unregister_delegate(const key_type& key)
+   {
+      _factory.unregister_delegate(key);
+      _keys.erase(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters all the functions of all the keys that start with the given segments.
+   /// </summary>
+   ///
+   /// <param name="prefix">The prefix of the keys to unregister. An empty prefix unregisters all the keys.</param>
+   ///
+   /// <returns>The number of keys that were unregistered.</returns>
+   ///
+   std::size_t unregister_prefix(std::string_view prefix)
+   {
+      const auto keys = _keys.erase_prefix(prefix);
+
+      for (const auto& key : keys)
+      {
+         _factory.unregister_delegate(key_type(key));
+      }
+
+      return keys.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   /// <remarks>The key remains registered, as it does in the key_class_factory.</remarks>
+   ///
+   template<class function_t>
+   void unregister_function(const key_type& key)
+   {
+      _factory.template unregister_function<function_t>(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   /// <remarks>The key remains registered, as it does in the key_class_factory.</remarks>
+   ///
+   template<int index_t>
+   void unregister_function(const key_type& key)
+   {
+      _factory.template unregister_function<index_t>(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Get a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   template<class function_t>
+   decltype(auto) get_function(const key_type& key) const
+   {
+      return _factory.template get_function<function_t>(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Get a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   template<int index_t>
+   decltype(auto) get_function(const key_type& key) const
+   {
+      return _factory.template get_function<index_t>(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Get all the registered keys that start with the given segments, in lexicographic order.
+   /// </summary>
+   ///
+   /// <param name="prefix">The prefix of the keys. An empty prefix gets all the keys.</param>
+   ///
+   std::vector<key_type> keys_with_prefix(std::string_view prefix) const
+   {
+      std::vector<key_type> keys;
+
+      _keys.for_each_with_prefix(prefix, [&keys](const std::string& key) { keys.emplace_back(key); });
+
+      return keys;
+   }
+
+   ///
+   /// <summary>
+   ///   Invokes a function with each registered key that starts with the given segments, in lexicographic order.
+   /// </summary>
+   ///
+   /// <param name="prefix">The prefix of the keys. An empty prefix enumerates all the keys.</param>
+   /// <param name="function">The function that is invoked with a const reference to each key.</param>
+   ///
+   template<class function_t>
+   void for_each_key_with_prefix(std::string_view prefix,
+                                 function_t&& function) const
+   {
+      _keys.for_each_with_prefix(prefix, std::forward<function_t>(function));
+   }
+
+   ///
+   /// <summary>
+   ///   Get the longest registered key whose segments lead the given key, including the key itself.
+   /// </summary>
+   ///
+   /// <returns>std::nullopt when none of the registered keys is a prefix of the given key.</returns>
+   ///
+   std::optional<key_type> longest_prefix_key(const key_type& key) const
+   {
+      const std::string_view text = key;
+      const auto length = _keys.longest_prefix_length(text);
+
+      return (length)
+             ? std::optional<key_type>(key_type(std::string(text.substr(0, *length))))
+             : std::nullopt;
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class function_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const -> typename function_t::result_type
+   {
+      return _factory.template construct<function_t>(key, std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<int index_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const
+   {
+      return _factory.template construct<index_t>(key, std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class with the longest registered key, whose segments lead the given key, that
+   ///   has a function with the signature.
+   /// </summary>
+   ///
+   /// <remarks>
+   ///   For instance "nike/running/runner/trail" is constructed by "nike/running/runner" unless it is itself registered.
+   ///   When "nike/running/runner" doesn't have the signature, then it is constructed by "nike/running", and so on.
+   /// </remarks>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when none of the registered keys that lead the given key has the signature.<returns>
+   ///
+   template<class function_t, class... args_t>
+   auto construct_longest_prefix(const key_type& key,
+                                 args_t&&... args) const -> typename function_t::result_type
+   {
+      const auto found = longest_prefix_with([this](const key_type& candidate)
+                                             {
+                                                return static_cast<bool>(_factory.template get_function<function_t>(candidate));
+                                             }, key);
+
+      return (found)
+             ? _factory.template construct<function_t>(*found, std::forward<args_t>(args)...)
+             : nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class with the longest registered key, whose segments lead the given key, that
+   ///   has a function at the index position.
+   /// </summary>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when none of the registered keys that lead the given key has the function.<returns>
+   ///
+   template<int index_t, class... args_t>
+   auto construct_longest_prefix(const key_type& key,
+                                 args_t&&... args) const
+   {
+      using result_type = decltype(_factory.template construct<index_t>(key, std::forward<args_t>(args)...));
+
+      const auto found = longest_prefix_with([this](const key_type& candidate)
+                                             {
+                                                return static_cast<bool>(_factory.template get_function<index_t>(candidate));
+                                             }, key);
+
+      return (found)
+             ? _factory.template construct<index_t>(*found, std::forward<args_t>(args)...)
+             : result_type(nullptr);
+   }
+
+   ///
+   /// <summary>
+   ///   Swaps the contents with another reference.
+   /// </summary>
+   ///
+   /// <param name="other">The reference to swap contents with.</param>
+   ///
+   void swap(prefix_key_class_factory& other)
+   {
+      _factory.swap(other._factory);
+      _keys.swap(other._keys);
+   }
+
+private:
+   ///
+   /// <summary>
+   ///   Get the longest registered key, whose segments lead the given key, that the predicate accepts.
+   /// </summary>
+   ///
+   template<class predicate_t>
+   std::optional<key_type> longest_prefix_with(predicate_t&& predicate,
+                                               const key_type& key) const
+   {
+      const std::string_view text = key;
+
+      std::optional<key_type> found;
+
+      _keys.longest_prefix_length(text, [&](std::size_t length)
+                                        {
+                                           auto candidate = key_type(std::string(text.substr(0, length)));
+
+                                           if (!predicate(candidate))
+                                           {
+                                              return false;
+                                           }
+
+                                           found = std::move(candidate);
+                                           return true;
+                                        });
+
+      return found;
+   }
+
+   factory_type _factory;
+   radix_trie   _keys;
+};
+}
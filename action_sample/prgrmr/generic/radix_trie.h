@@ -0,0 +1,604 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The radix_trie class is an ordered set of strings stored as a compressed prefix tree.
+///   <para>Each edge holds the longest run of characters shared by all the strings beneath it.</para>
+///   <para>Hence, finding the strings under a prefix costs the length of the prefix, plus the strings that are found.</para>
+/// </summary>
+///
+/// <remarks>
+///   The strings are enumerated in lexicographic order.
+///   The strings are paths of segments, and prefixes match whole segments: with the default separator, "nike/run" is
+///   a prefix of neither "nike/running" nor "nike/running/runner", whereas "nike/running" and "nike/running/" are
+///   prefixes of "nike/running/runner".
+/// </remarks>
+///
+class radix_trie final
+{
+public:
+   static constexpr char default_separator = '/';
+
+   radix_trie() = default;
+
+   ///
+   /// <summary>
+   ///   Constructs an empty trie whose strings are paths of segments separated by the given character.
+   /// </summary>
+   ///
+   explicit radix_trie(char separator)
+   : _separator(separator)
+   {
+   }
+
+   radix_trie(const radix_trie&) = default;
+   radix_trie(radix_trie&&) = default;
+
+   ~radix_trie() = default;
+
+   radix_trie& operator=(const radix_trie&) = default;
+   radix_trie& operator=(radix_trie&&) = default;
+
+   ///
+   /// <summary>
+   ///   Inserts a string.
+   /// </summary>
+   ///
+   /// <returns>false when the string was already present.</returns>
+   ///
+   bool insert(std::string_view key)
+   {
+      node* current = &_root;
+
+      for (;;)
+      {
+         if (key.empty())
+         {
+            if (current->terminal)
+            {
+               return false;
+            }
+
+            current->terminal = true;
+            ++_size;
+            return true;
+         }
+
+         const auto position = lower_bound(*current, key.front());
+
+         if (position == std::end(current->children) || (*position)->label.front() != key.front())
+         {
+            auto leaf = std::make_unique<node>();
+
+            leaf->label    = key;
+            leaf->terminal = true;
+            current->children.insert(position, std::move(leaf));
+            ++_size;
+            return true;
+         }
+
+         auto& child = *position;
+
+         const auto common = static_cast<std::size_t>(std::mismatch(std::begin(child->label), std::end(child->label),
+                                                                    std::begin(key), std::end(key)).first
+                                                    - std::begin(child->label));
+
+         if (common < child->label.size())
+         {
+            // Split the edge where the string diverges from it.
+            auto branch = std::make_unique<node>();
+
+            branch->label = child->label.substr(0, common);
+            child->label.erase(0, common);
+            branch->children.push_back(std::move(child));
+            child = std::move(branch);
+         }
+
+         current = child.get();
+         key.remove_prefix(common);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Removes a string.
+   /// </summary>
+   ///
+   /// <returns>false when the string wasn't present.</returns>
+   ///
+   bool erase(std::string_view key)
+   {
+      std::vector<std::pair<node*, std::size_t>> path;
+
+      node* current = &_root;
+
+      while (!key.empty())
+      {
+         const auto index = child_index(*current, key.front());
+
+         if (index == npos || !key.starts_with(current->children[index]->label))
+         {
+            return false;
+         }
+
+         path.emplace_back(current, index);
+         key.remove_prefix(current->children[index]->label.size());
+         current = current->children[index].get();
+      }
+
+      if (!current->terminal)
+      {
+         return false;
+      }
+
+      current->terminal = false;
+      --_size;
+
+      if (path.empty())
+      {
+         return true;
+      }
+
+      auto [parent, index] = path.back();
+
+      if (!current->children.empty())
+      {
+         merge_single_child(*current);
+         return true;
+      }
+
+      parent->children.erase(std::begin(parent->children) + index);
+
+      if (parent != &_root)
+      {
+         merge_single_child(*parent);
+      }
+
+      return true;
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if a string is present.
+   /// </summary>
+   ///
+   bool contains(std::string_view key) const
+   {
+      const node* current = &_root;
+
+      while (!key.empty())
+      {
+         const auto index = child_index(*current, key.front());
+
+         if (index == npos || !key.starts_with(current->children[index]->label))
+         {
+            return false;
+         }
+
+         key.remove_prefix(current->children[index]->label.size());
+         current = current->children[index].get();
+      }
+
+      return current->terminal;
+   }
+
+   ///
+   /// <summary>
+   ///   Invokes a function with each string that starts with the given segments, in lexicographic order.
+   /// </summary>
+   ///
+   /// <param name="prefix">The leading segments of the strings. An empty prefix enumerates all the strings.</param>
+   /// <param name="function">The function that is invoked with a const reference to each string.</param>
+   ///
+   template<class function_t>
+   void for_each_with_prefix(std::string_view prefix,
+                             function_t&& function) const
+   {
+      if (is_whole_prefix(prefix))
+      {
+         for_each_with_text_prefix(prefix, function);
+         return;
+      }
+
+      // The prefix itself, then the strings that carry on with a separator, which all sort after it.
+      if (contains(prefix))
+      {
+         const std::string key(prefix);
+
+         function(key);
+      }
+
+      for_each_with_text_prefix(std::string(prefix) + _separator, function);
+   }
+
+   ///
+   /// <summary>
+   ///   Get all the strings that start with the given prefix, in lexicographic order.
+   /// </summary>
+   ///
+   std::vector<std::string> with_prefix(std::string_view prefix) const
+   {
+      std::vector<std::string> keys;
+
+      for_each_with_prefix(prefix, [&keys](const std::string& key) { keys.push_back(key); });
+
+      return keys;
+   }
+
+   ///
+   /// <summary>
+   ///   Removes all the strings that start with the given segments.
+   /// </summary>
+   ///
+   /// <returns>The removed strings, in lexicographic order.</returns>
+   ///
+   /// <remarks>The whole subtree is detached at once, rather than removing its strings one by one.</remarks>
+   ///
+   std::vector<std::string> erase_prefix(std::string_view prefix)
+   {
+      if (is_whole_prefix(prefix))
+      {
+         return erase_text_prefix(prefix);
+      }
+
+      std::vector<std::string> keys;
+
+      if (erase(prefix))
+      {
+         keys.emplace_back(prefix);
+      }
+
+      auto beneath = erase_text_prefix(std::string(prefix) + _separator);
+
+      keys.insert(std::end(keys), std::make_move_iterator(std::begin(beneath)), std::make_move_iterator(std::end(beneath)));
+
+      return keys;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the length of the longest string whose segments lead the given key, including the key itself.
+   /// </summary>
+   ///
+   /// <returns>std::nullopt when none of the strings leads the key.</returns>
+   ///
+   std::optional<std::size_t> longest_prefix_length(std::string_view key) const
+   {
+      return longest_prefix_length(key, [](std::size_t) { return true; });
+   }
+
+   ///
+   /// <summary>
+   ///   Get the length of the longest string whose segments lead the given key, and that the predicate accepts.
+   /// </summary>
+   ///
+   /// <param name="key">The key whose leading strings are looked for.</param>
+   /// <param name="predicate">The predicate that is invoked with the length of each leading string, longest first,
+   /// until it accepts one.</param>
+   ///
+   /// <returns>std::nullopt when none of the strings that lead the key is accepted.</returns>
+   ///
+   template<class predicate_t>
+   std::optional<std::size_t> longest_prefix_length(std::string_view key,
+                                                    predicate_t&& predicate) const
+   {
+      return find_longest_prefix(_root, key, 0, predicate);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of strings.
+   /// </summary>
+   ///
+   std::size_t size() const noexcept
+   {
+      return _size;
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if there aren't any strings.
+   /// </summary>
+   ///
+   bool empty() const noexcept
+   {
+      return _size == 0;
+   }
+
+   ///
+   /// <summary>
+   ///   Removes all the strings.
+   /// </summary>
+   ///
+   void clear()
+   {
+      _root = node{};
+      _size = 0;
+   }
+
+   ///
+   /// <summary>
+   ///   Swaps the contents with another reference.
+   /// </summary>
+   ///
+   /// <param name="other">The reference to swap contents with.</param>
+   ///
+   void swap(radix_trie& other)
+   {
+      std::swap(_root, other._root);
+      std::swap(_size, other._size);
+      std::swap(_separator, other._separator);
+   }
+
+private:
+   static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+   struct node
+   {
+      node() = default;
+      node(node&&) = default;
+
+      node(const node& other)
+      : label(other.label),
+        terminal(other.terminal)
+      {
+         children.reserve(other.children.size());
+
+         for (const auto& child : other.children)
+         {
+            children.push_back(std::make_unique<node>(*child));
+         }
+      }
+
+      ~node() = default;
+
+      node& operator=(node&&) = default;
+
+      node& operator=(const node& other)
+      {
+         node copy(other);
+
+         return *this = std::move(copy);
+      }
+
+      std::string                        label;
+      bool                               terminal = false;
+      std::vector<std::unique_ptr<node>> children;   // Sorted by the first character of their label.
+   };
+
+   struct subtree_location
+   {
+      node*       parent  = nullptr;   // nullptr when the subtree is the whole trie.
+      std::size_t index   = 0;
+      const node* subtree = nullptr;   // nullptr when there isn't any string with the prefix.
+      std::string path;                // The string spelled from the root down to the subtree.
+   };
+
+   typedef std::vector<std::unique_ptr<node>> children_type;
+
+   static bool precedes(const std::unique_ptr<node>& child, char first)
+   {
+      return static_cast<unsigned char>(child->label.front()) < static_cast<unsigned char>(first);
+   }
+
+   static children_type::const_iterator lower_bound(const node& parent, char first)
+   {
+      return std::lower_bound(std::begin(parent.children), std::end(parent.children), first, precedes);
+   }
+
+   static children_type::iterator lower_bound(node& parent, char first)
+   {
+      return std::lower_bound(std::begin(parent.children), std::end(parent.children), first, precedes);
+   }
+
+   static std::size_t child_index(const node& parent, char first)
+   {
+      const auto position = lower_bound(parent, first);
+
+      return (position != std::end(parent.children) && (*position)->label.front() == first)
+             ? static_cast<std::size_t>(position - std::begin(parent.children))
+             : npos;
+   }
+
+   ///
+   /// <summary>
+   ///   Folds a node that is no longer a string, and that has a single child, into that child.
+   /// </summary>
+   ///
+   static void merge_single_child(node& parent)
+   {
+      if (parent.terminal || parent.children.size() != 1)
+      {
+         return;
+      }
+
+      auto child = std::move(parent.children.front());
+
+      parent.label   += child->label;
+      parent.terminal = child->terminal;
+      parent.children = std::move(child->children);
+   }
+
+   subtree_location find_subtree(std::string_view prefix) const
+   {
+      subtree_location found;
+
+      node* current = const_cast<node*>(&_root);
+      std::size_t length = 0;
+
+      while (length < prefix.size())
+      {
+         const auto index = child_index(*current, prefix[length]);
+
+         if (index == npos)
+         {
+            return {};
+         }
+
+         const auto& label     = current->children[index]->label;
+         const auto  remaining = prefix.substr(length);
+
+         // The prefix may end part way through an edge, in which case the whole child is beneath the prefix.
+         if (!(remaining.size() >= label.size() ? remaining.starts_with(label)
+                                                : std::string_view(label).starts_with(remaining)))
+         {
+            return {};
+         }
+
+         found.parent = current;
+         found.index  = index;
+         length      += label.size();
+         current      = current->children[index].get();
+      }
+
+      found.subtree = current;
+      found.path    = prefix;
+
+      if (length > prefix.size())
+      {
+         const auto& label = current->label;
+
+         found.path.append(label, label.size() - (length - prefix.size()), std::string::npos);
+      }
+
+      return found;
+   }
+
+   template<class function_t>
+   static void visit(const node& current,
+                     std::string& path,
+                     function_t&& function)
+   {
+      if (current.terminal)
+      {
+         function(static_cast<const std::string&>(path));
+      }
+
+      for (const auto& child : current.children)
+      {
+         const auto length = path.size();
+
+         path += child->label;
+         visit(*child, path, function);
+         path.resize(length);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the prefix ends on a segment boundary by itself, hence every string that starts with its characters
+   ///   also starts with its segments.
+   /// </summary>
+   ///
+   bool is_whole_prefix(std::string_view prefix) const noexcept
+   {
+      return prefix.empty() || prefix.back() == _separator;
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the first characters of the key, up to the given length, are whole segments.
+   /// </summary>
+   ///
+   bool is_segment_end(std::string_view key,
+                       std::size_t length) const noexcept
+   {
+      return length == 0 || length == key.size() || key[length] == _separator || key[length - 1] == _separator;
+   }
+
+   template<class function_t>
+   void for_each_with_text_prefix(std::string_view prefix,
+                                  function_t& function) const
+   {
+      const auto found = find_subtree(prefix);
+
+      if (found.subtree != nullptr)
+      {
+         std::string path = found.path;
+
+         visit(*found.subtree, path, function);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Walks down the key, then checks the strings that lead it on the way back up, hence the longest first.
+   /// </summary>
+   ///
+   template<class predicate_t>
+   std::optional<std::size_t> find_longest_prefix(const node& current,
+                                                  std::string_view key,
+                                                  std::size_t length,
+                                                  predicate_t& predicate) const
+   {
+      if (length < key.size())
+      {
+         const auto index = child_index(current, key[length]);
+
+         if (index != npos && key.substr(length).starts_with(current.children[index]->label))
+         {
+            const auto& child = *current.children[index];
+
+            if (const auto found = find_longest_prefix(child, key, length + child.label.size(), predicate))
+            {
+               return found;
+            }
+         }
+      }
+
+      if (current.terminal && is_segment_end(key, length) && predicate(length))
+      {
+         return length;
+      }
+
+      return std::nullopt;
+   }
+
+   std::vector<std::string> erase_text_prefix(std::string_view prefix)
+   {
+      std::vector<std::string> keys;
+
+      const auto found = find_subtree(prefix);
+
+      if (found.subtree == nullptr)
+      {
+         return keys;
+      }
+
+      std::string path = found.path;
+
+      visit(*found.subtree, path, [&keys](const std::string& key) { keys.push_back(key); });
+
+      if (found.parent == nullptr)
+      {
+         clear();
+         return keys;
+      }
+
+      found.parent->children.erase(std::begin(found.parent->children) + found.index);
+      _size -= keys.size();
+
+      if (found.parent != &_root)
+      {
+         merge_single_child(*found.parent);
+      }
+
+      return keys;
+   }
+
+   node        _root;
+   std::size_t _size      = 0;
+   char        _separator = default_separator;
+};
+}
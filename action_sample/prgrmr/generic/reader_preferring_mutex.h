@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The reader_preferring_mutex class is a reader-writer lock that lets readers in whenever no writer holds it, even
+///   while writers are waiting.
+///   <para>Hence a thread may take it shared again while it already holds it shared, or take the shared locks of several
+///   instances in any order, without ever waiting on a writer that waits on it. std::shared_mutex allows neither, as
+///   it may queue new readers behind a waiting writer.</para>
+/// </summary>
+///
+/// <remarks>
+///   The state is a single word: a bit for the writer that holds the lock, a bit for the writers that wait for it, and
+///   the count of the readers above them. A reader takes it with a single atomic increment.
+///   The writers may starve while readers keep on coming, hence it suits data that is read far more often than it is
+///   written. It meets the SharedMutex requirements, hence std::shared_lock and std::unique_lock work with it.
+/// </remarks>
+///
+class reader_preferring_mutex final
+{
+public:
+   reader_preferring_mutex() = default;
+   reader_preferring_mutex(const reader_preferring_mutex&) = delete;
+   reader_preferring_mutex(reader_preferring_mutex&&) = delete;
+
+   ~reader_preferring_mutex() = default;
+
+   reader_preferring_mutex& operator=(const reader_preferring_mutex&) = delete;
+   reader_preferring_mutex& operator=(reader_preferring_mutex&&) = delete;
+
+   void lock_shared() noexcept
+   {
+      for (;;)
+      {
+         auto state = _state.fetch_add(reader, std::memory_order_acquire);
+
+         if ((state & writer) == 0)
+         {
+            return;
+         }
+
+         // A writer holds the lock: step back out, and wait for it to leave.
+         state = _state.fetch_sub(reader, std::memory_order_relaxed) - reader;
+
+         wake_writers(state);
+
+         while ((state & writer) != 0)
+         {
+            _state.wait(state, std::memory_order_relaxed);
+            state = _state.load(std::memory_order_relaxed);
+         }
+      }
+   }
+
+   bool try_lock_shared() noexcept
+   {
+      const auto state = _state.fetch_add(reader, std::memory_order_acquire);
+
+      if ((state & writer) == 0)
+      {
+         return true;
+      }
+
+      wake_writers(_state.fetch_sub(reader, std::memory_order_relaxed) - reader);
+
+      return false;
+   }
+
+   void unlock_shared() noexcept
+   {
+      wake_writers(_state.fetch_sub(reader, std::memory_order_release) - reader);
+   }
+
+   void lock() noexcept
+   {
+      auto state = _state.load(std::memory_order_relaxed);
+
+      for (;;)
+      {
+         if ((state & ~waiting) == 0)
+         {
+            // Taking the lock clears the waiting bit, the other waiting writers are woken when it is released.
+            if (_state.compare_exchange_weak(state, writer, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+               return;
+            }
+
+            continue;
+         }
+
+         if ((state & waiting) == 0 && !_state.compare_exchange_weak(state, state | waiting, std::memory_order_relaxed))
+         {
+            continue;
+         }
+
+         _state.wait(state | waiting, std::memory_order_relaxed);
+         state = _state.load(std::memory_order_relaxed);
+      }
+   }
+
+   bool try_lock() noexcept
+   {
+      auto state = _state.load(std::memory_order_relaxed);
+
+      return (state & ~waiting) == 0
+          && _state.compare_exchange_strong(state, writer, std::memory_order_acquire, std::memory_order_relaxed);
+   }
+
+   void unlock() noexcept
+   {
+      _state.fetch_sub(writer, std::memory_order_release);
+      _state.notify_all();
+   }
+
+private:
+   static constexpr std::uint64_t writer  = 1;
+   static constexpr std::uint64_t waiting = 2;
+   static constexpr std::uint64_t reader  = 4;
+
+   ///
+   /// <summary>
+   ///   Wakes the waiting writers once the last reader has left, which is the only state change they cannot see coming.
+   /// </summary>
+   ///
+   void wake_writers(std::uint64_t state) noexcept
+   {
+      if (state == waiting)
+      {
+         _state.notify_all();
+      }
+   }
+
+   std::atomic<std::uint64_t> _state{0};
+};
+}
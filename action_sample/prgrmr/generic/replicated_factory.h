@@ -0,0 +1,432 @@
+#pragma once
+
+#include "factory.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The replicated_key_class_factory class is a key_class_factory whose registry is replicated in every thread that
+///   constructs with it.
+///   <para>The registrations are made to a master registry, under a lock, and each of them bumps a version. A thread
+///   that constructs copies the master registry into its own replica the first time, and again whenever the version
+///   has moved on since its last copy.</para>
+///   <para>Hence the constructions of a thread only read the version, which is written solely by the registrations,
+///   and the hash table and the constructors of its replica, which it allocated itself. The cores never contend for
+///   the cache lines of the registry, however many threads construct at once.</para>
+/// </summary>
+///
+/// <remarks>
+///   Every change to the registrations costs a full copy of the registry in each thread that constructs afterwards,
+///   hence the replicas suit registries that are read far more often than they are changed.
+///   A replica holds copies of the constructors: the state that a constructor holds is replicated with it, while the
+///   state that it merely refers to remains shared.
+///   A constructor may itself use the factory; the replica of a thread isn't refreshed while one of its constructors
+///   is running, hence a nested construction sees the registrations of the outer one.
+///   The methods can be invoked by many threads at once. The replica of a thread is released when the thread exits,
+///   or when the thread next creates a replica once the factory is destroyed.
+///   Each live factory holds a small slot number, which indexes the replicas of a thread, hence a construction finds its
+///   replica without searching, however many factories the thread uses.
+/// </remarks>
+///
+/// <seealso cref="key_class_factory"/>
+/// <seealso cref="sharded_key_class_factory"/>
+///
+template<class key_t, class... functions_t>
+class replicated_key_class_factory final
+{
+public:
+   typedef key_t key_type;
+   using function_types = std::tuple<functions_t...>;
+   typedef key_delegates_functions<key_type, functions_t...> key_delegates_type;
+   typedef typename key_delegates_type::delegate_type delegate_type;
+
+   replicated_key_class_factory()
+   : _id(next_id().fetch_add(1, std::memory_order_relaxed)),
+     _slot(slots().acquire())
+   {
+   }
+
+   replicated_key_class_factory(const replicated_key_class_factory&) = delete;
+   replicated_key_class_factory(replicated_key_class_factory&&) = delete;
+
+   ~replicated_key_class_factory()
+   {
+      slots().release(_slot);
+   }
+
+   replicated_key_class_factory& operator=(const replicated_key_class_factory&) = delete;
+   replicated_key_class_factory& operator=(replicated_key_class_factory&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Registers all the delegate under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   void register_delegate(const key_type& key,
+                          const delegate_type& delegate)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _master.register_delegate(key, delegate);
+      publish();
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the functions under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with these function signatures.</param>
+   /// <param name="functions">The functions that are to be registered.</param>
+   ///
+   void register_functions(const key_type& key,
+                           function_types functions)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _master.register_functions(key, std::move(functions));
+      publish();
+   }
+
+   ///
+   /// <summary>
+   ///   Registers a single function under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with this function.</param>
+   /// <param name="function">The function that is to be registered.</param>
+   ///
+   template<class function_t>
+   void register_function(const key_type& key,
+                          function_t function)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _master.register_function(key, std::move(function));
+      publish();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters all the functions that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   void unregister_delegate(const key_type& key)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _master.unregister_delegate(key);
+      publish();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<class function_t>
+   void unregister_function(const key_type& key)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _master.template unregister_function<function_t>(key);
+      publish();
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<int index_t>
+   void unregister_function(const key_type& key)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _master.template unregister_function<index_t>(key);
+      publish();
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, with the replica of the calling thread.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class function_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const -> typename function_t::result_type
+   {
+      auto& current = local();
+      const auto* entry = current.delegates.get_entry(key);
+
+      if (entry == nullptr)
+      {
+         return nullptr;
+      }
+
+      const auto& function = entry->second.template get_function<function_t>();
+
+      if (!function)
+      {
+         return nullptr;
+      }
+
+      const in_use guard(current);
+
+      return function(std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class, with the replica of the calling thread.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<int index_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const
+   {
+      using result_type = decltype(std::declval<const delegate_type&>().template get_function<index_t>()(std::forward<args_t>(args)...));
+
+      auto& current = local();
+      const auto* entry = current.delegates.get_entry(key);
+
+      if (entry == nullptr)
+      {
+         return result_type(nullptr);
+      }
+
+      const auto& function = entry->second.template get_function<index_t>();
+
+      if (!function)
+      {
+         return result_type(nullptr);
+      }
+
+      const in_use guard(current);
+
+      return function(std::forward<args_t>(args)...);
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is registered, according to the replica of the calling thread.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for.</param>
+   ///
+   bool contains(const key_type& key) const
+   {
+      return local().delegates.contains(key);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of registered keys, according to the replica of the calling thread.
+   /// </summary>
+   ///
+   std::size_t size() const
+   {
+      return local().delegates.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Get the version of the registrations, which is bumped by any change to them.
+   /// </summary>
+   ///
+   std::uint64_t version() const noexcept
+   {
+      return _version.load(std::memory_order_acquire);
+   }
+
+   ///
+   /// <summary>
+   ///   Brings the replica of the calling thread up to date, so that its first construction doesn't pay for the copy.
+   /// </summary>
+   ///
+   /// <remarks>A worker thread would typically invoke it once it starts, and after a batch of registrations.</remarks>
+   ///
+   void refresh() const
+   {
+      local();
+   }
+
+private:
+   static constexpr std::uint64_t stale = static_cast<std::uint64_t>(-1);
+
+   struct replica
+   {
+      std::uint64_t         owner   = 0;       // The identifier of the factory.
+      std::weak_ptr<void>   alive;             // Expires along with the factory.
+      std::uint64_t         version = stale;
+      std::size_t           depth   = 0;       // The constructors of the replica that are running.
+      key_delegates_type    delegates;
+   };
+
+   ///
+   /// <summary>
+   ///   Holds off the refreshes of a replica while one of its constructors is running.
+   /// </summary>
+   ///
+   struct in_use final
+   {
+      explicit in_use(replica& current) noexcept
+      : _current(current)
+      {
+         ++_current.depth;
+      }
+
+      in_use(const in_use&) = delete;
+      in_use& operator=(const in_use&) = delete;
+
+      ~in_use()
+      {
+         --_current.depth;
+      }
+
+   private:
+      replica& _current;
+   };
+
+   static std::atomic<std::uint64_t>& next_id() noexcept
+   {
+      // Identifiers aren't reused, unlike addresses, hence the replicas of a destroyed factory never match a new one.
+      static std::atomic<std::uint64_t> id{1};
+
+      return id;
+   }
+
+   ///
+   /// <summary>
+   ///   Hands out the slot numbers of the live factories, reusing those of the destroyed ones so the numbers stay small.
+   /// </summary>
+   ///
+   class slot_allocator final
+   {
+   public:
+      std::size_t acquire()
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+
+         if (_free.empty())
+         {
+            return _next++;
+         }
+
+         const auto slot = _free.back();
+
+         _free.pop_back();
+
+         return slot;
+      }
+
+      void release(std::size_t slot)
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         _free.push_back(slot);
+      }
+
+   private:
+      std::mutex               _mutex;
+      std::size_t              _next = 0;
+      std::vector<std::size_t> _free;
+   };
+
+   static slot_allocator& slots() noexcept
+   {
+      static slot_allocator allocator;
+
+      return allocator;
+   }
+
+   static std::vector<std::unique_ptr<replica>>& replicas() noexcept
+   {
+      // Indexed by the slots of the factories. The replicas are held by pointer, hence a replica doesn't move while its
+      // constructors are running.
+      thread_local std::vector<std::unique_ptr<replica>> owned;
+
+      return owned;
+   }
+
+   void publish() noexcept
+   {
+      _version.fetch_add(1, std::memory_order_release);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the replica of the calling thread, copying the master registry when it is missing or out of date.
+   /// </summary>
+   ///
+   replica& local() const
+   {
+      auto& owned = replicas();
+      replica* current = (_slot < owned.size()) ? owned[_slot].get() : nullptr;
+
+      // The slot may still hold the replica of a destroyed factory that had the same slot.
+      if (current == nullptr || current->owner != _id)
+      {
+         for (auto& candidate : owned)
+         {
+            if (candidate != nullptr && candidate->alive.expired())
+            {
+               candidate.reset();
+            }
+         }
+
+         if (_slot >= owned.size())
+         {
+            owned.resize(_slot + 1);
+         }
+
+         auto created = std::make_unique<replica>();
+
+         created->owner = _id;
+         created->alive = _alive;
+         current = created.get();
+         owned[_slot] = std::move(created);
+      }
+
+      if (current->version != _version.load(std::memory_order_acquire) && current->depth == 0)
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+
+         // The copy is made by the calling thread, hence its memory is allocated for, and first written by, that thread.
+         current->delegates = _master;
+         current->version   = _version.load(std::memory_order_relaxed);
+      }
+
+      return *current;
+   }
+
+   key_delegates_type                       _master;
+   std::uint64_t                            _id;
+   std::size_t                              _slot;
+   std::shared_ptr<void>                    _alive = std::make_shared<bool>(true);
+   mutable std::mutex                       _mutex;
+
+   // On its own cache line, since it is read by every construction and written only by the registrations.
+   alignas(64) std::atomic<std::uint64_t>   _version{0};
+};
+}
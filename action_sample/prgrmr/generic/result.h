@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define PRGRMR_HAS_EXCEPTIONS 1
+#else
+#define PRGRMR_HAS_EXCEPTIONS 0
+#endif
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The errors of a construction.
+/// </summary>
+///
+enum class factory_errc
+{
+   missing_key = 1,      // No functions are registered under the key.
+   missing_signature,    // The key doesn't have a function registered with the signature.
+   constructor_failed    // The function threw an exception, or returned an empty result.
+};
+
+///
+/// <summary>
+///   Get the description of an error.
+/// </summary>
+///
+constexpr const char* to_string(factory_errc error) noexcept
+{
+   switch (error)
+   {
+   case factory_errc::missing_key:        return "missing key";
+   case factory_errc::missing_signature:  return "missing signature";
+   case factory_errc::constructor_failed: return "constructor failed";
+   }
+
+   return "unknown error";
+}
+
+///
+/// <summary>
+///   Wraps an error, to tell it apart from a value when constructing a result.
+/// </summary>
+///
+template<class error_t>
+struct failure
+{
+   error_t error;
+};
+
+template<class error_t>
+failure<error_t> make_failure(error_t error)
+{
+   return failure<error_t>{ std::move(error) };
+}
+
+///
+/// <summary>
+///   The result class holds either a value or an error, in the manner of std::expected.
+///   <para>None of its methods throws, hence it can be used in code built without exceptions.</para>
+/// </summary>
+///
+/// <remarks>Accessing the value of a result that holds an error, or the error of a result that holds a value, is a precondition violation.</remarks>
+///
+template<class value_t, class error_t>
+class result final
+{
+public:
+   typedef value_t value_type;
+   typedef error_t error_type;
+
+   result(value_type value) noexcept(std::is_nothrow_move_constructible_v<value_type>)
+   : _state(std::in_place_index<0>, std::move(value))
+   {
+   }
+
+   result(failure<error_type> failure) noexcept(std::is_nothrow_move_constructible_v<error_type>)
+   : _state(std::in_place_index<1>, std::move(failure.error))
+   {
+   }
+
+   result(const result&) = default;
+   result(result&&) = default;
+
+   ~result() = default;
+
+   result& operator=(const result&) = default;
+   result& operator=(result&&) = default;
+
+   bool has_value() const noexcept
+   {
+      return _state.index() == 0;
+   }
+
+   explicit operator bool() const noexcept
+   {
+      return has_value();
+   }
+
+   value_type& value() & noexcept
+   {
+      assert(has_value());
+      return *std::get_if<0>(&_state);
+   }
+
+   const value_type& value() const & noexcept
+   {
+      assert(has_value());
+      return *std::get_if<0>(&_state);
+   }
+
+   value_type&& value() && noexcept
+   {
+      assert(has_value());
+      return std::move(*std::get_if<0>(&_state));
+   }
+
+   ///
+   /// <summary>
+   ///   Get the value, or the given one when the result holds an error.
+   /// </summary>
+   ///
+   template<class other_t>
+   value_type value_or(other_t&& other) &&
+   {
+      return has_value()
+             ? std::move(*std::get_if<0>(&_state))
+             : static_cast<value_type>(std::forward<other_t>(other));
+   }
+
+   const error_type& error() const noexcept
+   {
+      assert(!has_value());
+      return *std::get_if<1>(&_state);
+   }
+
+   value_type& operator*() & noexcept
+   {
+      return value();
+   }
+
+   const value_type& operator*() const & noexcept
+   {
+      return value();
+   }
+
+   value_type* operator->() noexcept
+   {
+      return std::addressof(value());
+   }
+
+   const value_type* operator->() const noexcept
+   {
+      return std::addressof(value());
+   }
+
+private:
+   std::variant<value_type, error_type> _state;
+};
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+
+#if !defined(PRGRMR_NO_SIMD)
+#  if defined(__AVX2__)
+#     define PRGRMR_SIMD_AVX2 1
+#  endif
+#  if defined(__SSE4_1__) || defined(__AVX__)
+#     define PRGRMR_SIMD_SSE4_1 1
+#  endif
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#     define PRGRMR_SIMD_SSE2 1
+#  endif
+#endif
+
+#if defined(PRGRMR_SIMD_AVX2) || defined(PRGRMR_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace prgrmr::generic
+{
+
+///
+/// <summary>
+///   Multiplies, in place, a contiguous sequence of integers by the same factor.
+/// </summary>
+///
+/// <param name="values">The first of the integers to multiply.</param>
+/// <param name="count">The number of integers to multiply.</param>
+/// <param name="factor">The factor to multiply each integer by.</param>
+///
+/// <remarks>
+///   The widest instruction set enabled at compile-time is used (AVX2, then SSE), with a scalar loop for the tail.
+///   Define PRGRMR_NO_SIMD to only use the scalar loop. Overflows wrap around whichever loop is used.
+/// </remarks>
+///
+inline void scale(int* values,
+                  std::size_t count,
+                  int factor) noexcept
+{
+   std::size_t i = 0;
+
+#if defined(PRGRMR_SIMD_AVX2)
+   const __m256i factors8 = _mm256_set1_epi32(factor);
+
+   for (; i + 8 <= count; i += 8)
+   {
+      auto* chunk = reinterpret_cast<__m256i*>(values + i);
+
+      _mm256_storeu_si256(chunk, _mm256_mullo_epi32(_mm256_loadu_si256(chunk), factors8));
+   }
+#endif
+
+#if defined(PRGRMR_SIMD_SSE2)
+   const __m128i factors4 = _mm_set1_epi32(factor);
+
+   for (; i + 4 <= count; i += 4)
+   {
+      auto* chunk = reinterpret_cast<__m128i*>(values + i);
+      const __m128i value = _mm_loadu_si128(chunk);
+
+#if defined(PRGRMR_SIMD_SSE4_1)
+      _mm_storeu_si128(chunk, _mm_mullo_epi32(value, factors4));
+#else
+      // SSE2 only multiplies the even lanes, hence the odd lanes are shifted down and the products interleaved back.
+      const __m128i even = _mm_mul_epu32(value, factors4);
+      const __m128i odd  = _mm_mul_epu32(_mm_srli_si128(value, 4), _mm_srli_si128(factors4, 4));
+
+      _mm_storeu_si128(chunk, _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                                 _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0))));
+#endif
+   }
+#endif
+
+   for (; i < count; ++i)
+   {
+      values[i] = static_cast<int>(static_cast<unsigned int>(values[i]) * static_cast<unsigned int>(factor));
+   }
+}
+
+///
+/// <summary>
+///   Multiplies, in place, a contiguous sequence of floats by the same factor.
+/// </summary>
+///
+/// <param name="values">The first of the floats to multiply.</param>
+/// <param name="count">The number of floats to multiply.</param>
+/// <param name="factor">The factor to multiply each float by.</param>
+///
+/// <remarks>The widest instruction set enabled at compile-time is used (AVX2, then SSE), with a scalar loop for the tail.</remarks>
+///
+inline void scale(float* values,
+                  std::size_t count,
+                  float factor) noexcept
+{
+   std::size_t i = 0;
+
+#if defined(PRGRMR_SIMD_AVX2)
+   const __m256 factors8 = _mm256_set1_ps(factor);
+
+   for (; i + 8 <= count; i += 8)
+   {
+      _mm256_storeu_ps(values + i, _mm256_mul_ps(_mm256_loadu_ps(values + i), factors8));
+   }
+#endif
+
+#if defined(PRGRMR_SIMD_SSE2)
+   const __m128 factors4 = _mm_set1_ps(factor);
+
+   for (; i + 4 <= count; i += 4)
+   {
+      _mm_storeu_ps(values + i, _mm_mul_ps(_mm_loadu_ps(values + i), factors4));
+   }
+#endif
+
+   for (; i < count; ++i)
+   {
+      values[i] *= factor;
+   }
+}
+}
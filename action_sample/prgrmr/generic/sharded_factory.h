@@ -0,0 +1,423 @@
+#pragma once
+
+#include "factory.h"
+#include "hashing.h"
+#include "reader_preferring_mutex.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The sharded_key_class_factory class is a key_class_factory that can be used by many threads at once.
+///   <para>The keys are partitioned by their hash value across independently locked shards, each with its own registry.</para>
+///   <para>Hence, threads registering, unregistering or constructing with keys of different shards never wait on each other.</para>
+/// </summary>
+///
+/// <remarks>
+///   Each shard lies on its own cache lines, so that the locks of neighbouring shards don't share a cache line.
+///   The key is hashed once, the hash value selects the shard and is then handed to the shard's registry.
+///   A construction invokes the function in place under the shard's shared lock, hence it touches no reference count,
+///   and the delegate cannot be changed or unregistered while its function runs. The lock lets readers in whenever no
+///   writer holds it, hence a constructor may itself construct with the factory, as the forwarding constructors do,
+///   whichever shards the keys lie in. A constructor must not change the registrations of the factory, though.
+/// </remarks>
+///
+/// <seealso cref="key_class_factory"/>
+///
+template<class key_t, class... functions_t>
+class sharded_key_class_factory final
+{
+public:
+   typedef key_t key_type;
+   using function_types = std::tuple<functions_t...>;
+   typedef key_delegates_functions<key_type, functions_t...> key_delegates_type;
+   typedef typename key_delegates_type::delegate_type delegate_type;
+
+   static constexpr std::size_t default_shard_count = 64;
+
+   ///
+   /// <summary>
+   ///   Constructs an instance without any keys.
+   /// </summary>
+   ///
+   /// <param name="shard_count">The number of shards, which is rounded up to a power of two.</param>
+   ///
+   explicit sharded_key_class_factory(std::size_t shard_count = default_shard_count)
+   : _shard_count(std::bit_ceil(shard_count > 0 ? shard_count : 1)),
+     _shift(64 - std::countr_zero(_shard_count)),
+     _shards(std::make_unique<shard[]>(_shard_count))
+   {
+   }
+
+   sharded_key_class_factory(const sharded_key_class_factory&) = delete;
+   sharded_key_class_factory(sharded_key_class_factory&&) = delete;
+
+   ~sharded_key_class_factory() = default;
+
+   sharded_key_class_factory& operator=(const sharded_key_class_factory&) = delete;
+   sharded_key_class_factory& operator=(sharded_key_class_factory&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Registers all the delegate under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with the delegate.</param>
+   /// <param name="delegate">The functions delegate to be registered.</param>
+   ///
+   void register_delegate(const key_type& key,
+                          const delegate_type& delegate)
+   {
+      const auto hashed = make_hashed_key(key);
+      auto&      owner  = shard_at(hashed.hash);
+
+      std::unique_lock<reader_preferring_mutex> lock(owner.mutex);
+
+      if (owner.delegates.find(hashed) == std::end(owner.delegates))
+      {
+         owner.delegates.emplace(key, delegate);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Registers the functions under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with these function signatures.</param>
+   /// <param name="functions">The functions that are to be registered.</param>
+   ///
+   void register_functions(const key_type& key,
+                           function_types functions)
+   {
+      const delegate_type delegate(std::move(functions));
+
+      register_delegate(key, delegate);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters all the functions that were registered with the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the functions were registered under.</param>
+   ///
+   void unregister_delegate(const key_type& key)
+   {
+      const auto hashed = make_hashed_key(key);
+      auto&      owner  = shard_at(hashed.hash);
+
+      std::unique_lock<reader_preferring_mutex> lock(owner.mutex);
+
+      const auto iter = owner.delegates.find(hashed);
+
+      if (iter != std::end(owner.delegates))
+      {
+         owner.delegates.erase(iter);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Registers a single function under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to associate with this function.</param>
+   /// <param name="function">The function that is to be registered.</param>
+   ///
+   template<class function_t>
+   void register_function(const key_type& key,
+                          function_t function)
+   {
+      update(key, [&function](delegate_type& delegate) { delegate.register_function(std::move(function)); }, true);
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<class function_t>
+   void unregister_function(const key_type& key)
+   {
+      update(key, [](delegate_type& delegate) { delegate.template unregister_function<function_t>(); });
+   }
+
+   ///
+   /// <summary>
+   ///   Unregisters a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key in which the function was registered under.</param>
+   ///
+   template<int index_t>
+   void unregister_function(const key_type& key)
+   {
+      update(key, [](delegate_type& delegate) { delegate.template unregister_function<index_t>(); });
+   }
+
+   ///
+   /// <summary>
+   ///   Get a copy of a specific function by its signature that was registered under the given key.
+   /// </summary>
+   ///
+   /// <returns>A copy of the function object.<returns>
+   /// <returns>An empty function when the given key cannot be found.<returns>
+   ///
+   template<class function_t>
+   auto get_function(const key_type& key) const
+   {
+      return visit(key, [](const delegate_type* delegate)
+                        {
+                           return (delegate != nullptr)
+                                  ? delegate->template get_function<function_t>()
+                                  : function_t(nullptr);
+                        });
+   }
+
+   ///
+   /// <summary>
+   ///   Get a copy of a specific function by its index position that was registered under the given key.
+   /// </summary>
+   ///
+   /// <returns>A copy of the function object.<returns>
+   /// <returns>An empty function when the given key cannot be found.<returns>
+   ///
+   template<int index_t>
+   auto get_function(const key_type& key) const
+   {
+      using function_type = std::tuple_element_t<index_t, function_types>;
+
+      return visit(key, [](const delegate_type* delegate)
+                        {
+                           return (delegate != nullptr)
+                                  ? delegate->template get_function<index_t>()
+                                  : function_type(nullptr);
+                        });
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<class function_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const -> typename function_t::result_type
+   {
+      return visit(key, [&](const delegate_type* delegate) -> typename function_t::result_type
+                        {
+                           if (delegate == nullptr)
+                           {
+                              return nullptr;
+                           }
+
+                           const auto& function = delegate->template get_function<function_t>();
+
+                           return (function)
+                                  ? function(std::forward<args_t>(args)...)
+                                  : nullptr;
+                        });
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs an instance of the class.
+   /// </summary>
+   ///
+   /// <see cref="key_class_factory::construct"/>
+   ///
+   /// <returns>An instance of the class.<returns>
+   /// <returns>nullptr_t when the given key cannot be found.<returns>
+   ///
+   template<int index_t, class... args_t>
+   auto construct(const key_type& key,
+                  args_t&&... args) const
+   {
+      using result_type = function_result_t<std::tuple_element_t<index_t, function_types>>;
+
+      return visit(key, [&](const delegate_type* delegate) -> result_type
+                        {
+                           if (delegate == nullptr)
+                           {
+                              return result_type(nullptr);
+                           }
+
+                           const auto& function = delegate->template get_function<index_t>();
+
+                           return (function)
+                                  ? function(std::forward<args_t>(args)...)
+                                  : result_type(nullptr);
+                        });
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the given key is registered.
+   /// </summary>
+   ///
+   /// <param name="key">The unique identifying key to look for.</param>
+   ///
+   bool contains(const key_type& key) const
+   {
+      return visit(key, [](const delegate_type* delegate) { return delegate != nullptr; });
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of registered keys.
+   /// </summary>
+   ///
+   /// <remarks>The shards are counted one after the other, hence concurrent changes may or may not be counted.</remarks>
+   ///
+   std::size_t size() const
+   {
+      std::size_t count = 0;
+
+      for (std::size_t i = 0; i < _shard_count; ++i)
+      {
+         std::shared_lock<reader_preferring_mutex> lock(_shards[i].mutex);
+         count += _shards[i].delegates.size();
+      }
+
+      return count;
+   }
+
+   ///
+   /// <summary>
+   ///   Invokes a function with each registered key, in no particular order.
+   /// </summary>
+   ///
+   /// <param name="function">The function that is invoked with a const reference to each key. It must not change the factory.</param>
+   ///
+   template<class function_t>
+   void for_each_key(function_t&& function) const
+   {
+      for (std::size_t i = 0; i < _shard_count; ++i)
+      {
+         std::shared_lock<reader_preferring_mutex> lock(_shards[i].mutex);
+         for (const auto& entry : _shards[i].delegates)
+         {
+            function(entry.first);
+         }
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of shards.
+   /// </summary>
+   ///
+   std::size_t shard_count() const noexcept
+   {
+      return _shard_count;
+   }
+
+   ///
+   /// <summary>
+   ///   Swaps the contents with another reference.
+   /// </summary>
+   ///
+   /// <param name="other">The reference to swap contents with.</param>
+   ///
+   /// <remarks>Unlike the other methods, this one must not run concurrently with any other use of either instance.</remarks>
+   ///
+   void swap(sharded_key_class_factory& other) noexcept
+   {
+      std::swap(_shard_count, other._shard_count);
+      std::swap(_shift, other._shift);
+      _shards.swap(other._shards);
+   }
+
+private:
+   typedef std::unordered_map<key_type, delegate_type, key_hash<key_type>, key_equal<key_type>> delegates_type;
+
+   struct alignas(64) shard
+   {
+      mutable reader_preferring_mutex mutex;
+      delegates_type                  delegates;
+   };
+
+   ///
+   /// <summary>
+   ///   The high bits of the mixed hash value select the shard, which leaves the low bits to the registry of the shard.
+   /// </summary>
+   ///
+   shard& shard_at(std::uint64_t hash) const
+   {
+      return _shards[(_shard_count > 1) ? static_cast<std::size_t>(hash >> _shift) : 0];
+   }
+
+   ///
+   /// <summary>
+   ///   Invokes a function with the delegate registered under the given key, or nullptr, under the shard's shared lock.
+   /// </summary>
+   ///
+   template<class visitor_t>
+   decltype(auto) visit(const key_type& key,
+                        visitor_t&& visitor) const
+   {
+      const auto  hashed = make_hashed_key(key);
+      const auto& owner  = shard_at(hashed.hash);
+
+      std::shared_lock<reader_preferring_mutex> lock(owner.mutex);
+
+      const auto iter = owner.delegates.find(hashed);
+
+      return visitor((iter != std::end(owner.delegates)) ? std::addressof(iter->second) : nullptr);
+   }
+
+   ///
+   /// <summary>
+   ///   Updates the delegate of the given key in place, under the shard's exclusive lock.
+   /// </summary>
+   ///
+   /// <param name="key">The key of the delegate to update.</param>
+   /// <param name="change">The function that updates the delegate.</param>
+   /// <param name="create">Indicates whether a delegate is registered when the key cannot be found.</param>
+   ///
+   template<class change_t>
+   void update(const key_type& key,
+               change_t&& change,
+               bool create = false)
+   {
+      const auto hashed = make_hashed_key(key);
+      auto&      owner  = shard_at(hashed.hash);
+
+      std::unique_lock<reader_preferring_mutex> lock(owner.mutex);
+
+      auto iter = owner.delegates.find(hashed);
+
+      if (iter == std::end(owner.delegates))
+      {
+         if (!create)
+         {
+            return;
+         }
+
+         iter = owner.delegates.try_emplace(key).first;
+      }
+
+      change(iter->second);
+   }
+
+   std::size_t              _shard_count;
+   int                      _shift;
+   std::unique_ptr<shard[]> _shards;
+};
+}
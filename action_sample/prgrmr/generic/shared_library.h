@@ -0,0 +1,145 @@
+#pragma once
+
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+///
+/// Exports a function with C linkage from a shared library, so that it can be found by its name.
+///
+#if defined(_WIN32)
+#define PRGRMR_PLUGIN_EXPORT extern "C" __declspec(dllexport)
+#else
+#define PRGRMR_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The shared_library class loads a shared library, a .so or a .dll, and finds the functions it exports.
+/// </summary>
+///
+/// <remarks>
+///   The library is never unloaded: the functions and the objects that it hands out, such as registered constructors
+///   and the instances they construct, may outlive the instance of this class.
+/// </remarks>
+///
+class shared_library final
+{
+public:
+   shared_library() = default;
+   shared_library(const shared_library&) = delete;
+
+   shared_library(shared_library&& other) noexcept
+   : _handle(std::exchange(other._handle, nullptr)),
+     _error(std::move(other._error))
+   {
+   }
+
+   ~shared_library() = default;
+
+   shared_library& operator=(const shared_library&) = delete;
+
+   shared_library& operator=(shared_library&& other) noexcept
+   {
+      _handle = std::exchange(other._handle, nullptr);
+      _error  = std::move(other._error);
+      return *this;
+   }
+
+   ///
+   /// <summary>
+   ///   Loads the library at the given path.
+   /// </summary>
+   ///
+   /// <returns>false when it cannot be loaded, in which case error() describes why.</returns>
+   ///
+   bool open(const std::string& path)
+   {
+#if defined(_WIN32)
+      _handle = ::LoadLibraryA(path.c_str());
+
+      if (_handle == nullptr)
+      {
+         _error = "LoadLibrary failed with error " + std::to_string(::GetLastError()) + ": " + path;
+      }
+#else
+      _handle = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+      if (_handle == nullptr)
+      {
+         const char* error = ::dlerror();
+
+         _error = (error != nullptr) ? error : "dlopen failed: " + path;
+      }
+#endif
+
+      return _handle != nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the address of the function exported under the given name.
+   /// </summary>
+   ///
+   /// <returns>nullptr when the library isn't loaded or doesn't export the name, in which case error() describes why.</returns>
+   ///
+   template<class function_t>
+   function_t* symbol(const std::string& name)
+   {
+      if (_handle == nullptr)
+      {
+         return nullptr;
+      }
+
+#if defined(_WIN32)
+      auto* address = reinterpret_cast<void*>(::GetProcAddress(static_cast<HMODULE>(_handle), name.c_str()));
+#else
+      auto* address = ::dlsym(_handle, name.c_str());
+#endif
+
+      if (address == nullptr)
+      {
+         _error = "The library doesn't export " + name;
+      }
+
+      return reinterpret_cast<function_t*>(address);
+   }
+
+   ///
+   /// <summary>
+   ///   Indicates if the library is loaded.
+   /// </summary>
+   ///
+   bool is_open() const noexcept
+   {
+      return _handle != nullptr;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the description of the last failure.
+   /// </summary>
+   ///
+   const std::string& error() const noexcept
+   {
+      return _error;
+   }
+
+private:
+   void*       _handle = nullptr;
+   std::string _error;
+};
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "function_traits.h"
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   Expression to indicate if the given signature takes exactly the given arguments, ignoring references and cv-qualifiers.
+/// </summary>
+///
+template<class function_t, class... args_t>
+inline constexpr bool is_exact_signature = std::is_same_v<typename function_traits<function_t>::decayed_argument_types,
+                                                          std::tuple<std::remove_cvref_t<args_t>...>>;
+
+///
+/// <summary>
+///   Expression to indicate if the first of the given types is one of the signatures, i.e. the signature was named by
+///   the caller, as in construct&lt;function_t&gt;(key, args...).
+/// </summary>
+///
+template<class functions_type, class... args_t>
+inline constexpr bool is_signature_named = false;
+
+template<class... functions_t, class first_t, class... args_t>
+inline constexpr bool is_signature_named<std::tuple<functions_t...>, first_t, args_t...> = (std::is_same_v<first_t, functions_t> || ...);
+
+///
+/// <summary>
+///   The best_signature class selects, at compile-time, the signature that is the best match for the given arguments.
+///   <para>A signature that takes exactly the argument types is preferred, otherwise a signature whose arguments they convert to.</para>
+/// </summary>
+///
+/// <remarks>The selection is unique when there is a single exact match, or no exact match and a single convertible one.</remarks>
+///
+template<class functions_type, class... args_t>
+struct best_signature;
+
+template<class... functions_t, class... args_t>
+struct best_signature<std::tuple<functions_t...>, args_t...>
+{
+private:
+   typedef std::array<bool, sizeof...(functions_t)> matches_type;
+
+   static constexpr matches_type exact       = { is_exact_signature<functions_t, args_t...>... };
+   static constexpr matches_type convertible = { std::is_invocable_v<const functions_t&, args_t...>... };
+
+   static constexpr std::size_t count(const matches_type& matches)
+   {
+      std::size_t count = 0;
+
+      for (const bool match : matches)
+      {
+         count += match ? 1 : 0;
+      }
+
+      return count;
+   }
+
+   static constexpr std::size_t first(const matches_type& matches)
+   {
+      for (std::size_t i = 0; i < matches.size(); ++i)
+      {
+         if (matches[i])
+         {
+            return i;
+         }
+      }
+
+      return matches.size();
+   }
+
+public:
+   static constexpr std::size_t exact_matches       = count(exact);
+   static constexpr std::size_t convertible_matches = count(convertible);
+
+   static constexpr bool is_found  = convertible_matches > 0;
+   static constexpr bool is_unique = (exact_matches == 1) || (exact_matches == 0 && convertible_matches == 1);
+
+   ///
+   /// <summary>
+   ///   The tuple index of the selected signature.
+   /// </summary>
+   ///
+   static constexpr std::size_t index = (exact_matches > 0) ? first(exact) : first(convertible);
+};
+}
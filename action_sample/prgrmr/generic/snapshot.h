@@ -0,0 +1,855 @@
+#pragma once
+
+#include "function_traits.h"
+#include "mapped_file.h"
+#include "packed_arguments.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The version of the snapshot files that are written, and the only one that is read.
+/// </summary>
+///
+inline constexpr std::uint32_t snapshot_version = 1;
+
+///
+/// Expression to indicate if the keys of the type can be written into a snapshot: strings, or trivially copyable keys.
+///
+template<class key_t>
+inline constexpr bool is_snapshot_key = std::is_same_v<key_t, std::string> || std::is_trivially_copyable_v<key_t>;
+
+namespace detail
+{
+///
+/// <summary>
+///   The header of a snapshot file. All the offsets are from the start of the file, and all the sections are aligned
+///   on 8 bytes. The table of the columns follows the header.
+/// </summary>
+///
+struct snapshot_header
+{
+   char          magic[8];
+   std::uint32_t version;
+   std::uint32_t byte_order;     // snapshot_byte_order, as stored by the host that wrote the file.
+   std::uint32_t column_count;
+   std::uint32_t key_size;       // 0 for string keys, which are stored as offsets into their characters.
+   std::uint64_t row_count;
+   std::uint64_t key_count;
+   std::uint64_t keys_offset;
+   std::uint64_t keys_size;
+   std::uint64_t ids_offset;     // The key of each row, as an index into the keys.
+};
+
+///
+/// <summary>
+///   An argument column, which holds the argument of each row back to back.
+/// </summary>
+///
+struct snapshot_column
+{
+   std::uint32_t size;
+   std::uint32_t kind;           // 'i' for signed integers, 'u' for unsigned ones, 'f' for floating points, otherwise 'b'.
+   std::uint64_t offset;
+};
+
+static_assert(sizeof(snapshot_header) == 64 && sizeof(snapshot_column) == 16, "The layout of a snapshot file changed.");
+
+inline constexpr char          snapshot_magic[8]   = { 'P', 'R', 'G', 'R', 'S', 'N', 'A', 'P' };
+inline constexpr std::uint32_t snapshot_byte_order = 0x01020304;
+
+constexpr std::uint64_t align_snapshot(std::uint64_t offset) noexcept
+{
+   return (offset + 7) & ~std::uint64_t(7);
+}
+
+template<class value_t>
+constexpr snapshot_column snapshot_column_of(std::uint64_t offset) noexcept
+{
+   const std::uint32_t kind = std::is_floating_point_v<value_t>                               ? 'f'
+                            : (std::is_integral_v<value_t> && std::is_signed_v<value_t>)      ? 'i'
+                            : std::is_integral_v<value_t>                                       ? 'u'
+                                                                                                : 'b';
+
+   return snapshot_column{ static_cast<std::uint32_t>(sizeof(value_t)), kind, offset };
+}
+
+template<class tuple_t>
+struct snapshot_arguments;
+
+template<class... args_t>
+struct snapshot_arguments<std::tuple<args_t...>>
+{
+   typedef std::tuple<std::vector<args_t>...> columns_type;
+
+   static constexpr bool is_packable = are_packable<args_t...>;
+};
+}
+
+///
+/// <summary>
+///   The snapshot_writer class records the key and the arguments of each construction with a signature, then writes
+///   them into a snapshot file, from which snapshot_view reconstructs the products in bulk.
+/// </summary>
+///
+/// <remarks>
+///   The file is columnar: the distinct keys are stored once, then the key of each row as a 32 bits index, then one
+///   column per argument. The arguments must be trivially copyable, and are stored as they lie in memory, hence a
+///   snapshot is only read back by a host of the same byte order, which is checked.
+///   A product that is destroyed is forgotten by its row, and isn't written.
+/// </remarks>
+///
+/// <seealso cref="snapshot_view"/>
+///
+template<class key_t, class function_t>
+class snapshot_writer final
+{
+public:
+   typedef key_t key_type;
+   typedef function_t function_type;
+   typedef function_result_t<function_type> result_type;
+   typedef typename function_traits<function_type>::decayed_argument_types argument_types;
+
+   static_assert(is_snapshot_key<key_type>, "The keys of a snapshot must be strings, or trivially copyable.");
+   static_assert(detail::snapshot_arguments<argument_types>::is_packable,
+                 "The arguments of the signature of a snapshot must be trivially copyable.");
+
+   snapshot_writer() = default;
+   snapshot_writer(const snapshot_writer&) = default;
+   snapshot_writer(snapshot_writer&&) = default;
+
+   ~snapshot_writer() = default;
+
+   snapshot_writer& operator=(const snapshot_writer&) = default;
+   snapshot_writer& operator=(snapshot_writer&&) = default;
+
+   ///
+   /// <summary>
+   ///   Records a construction.
+   /// </summary>
+   ///
+   /// <param name="key">The key that the product was constructed with.</param>
+   /// <param name="args">The arguments that the product was constructed with.</param>
+   ///
+   /// <returns>The row of the construction, by which it can be forgotten.</returns>
+   ///
+   template<class... args_t>
+   std::size_t record(const key_type& key,
+                      const args_t&... args)
+   {
+      static_assert(sizeof...(args_t) == std::tuple_size_v<argument_types>,
+                    "The number of arguments doesn't match the signature of the snapshot.");
+
+      const auto found = _ids_by_key.emplace(key, static_cast<std::uint32_t>(_keys.size()));
+
+      if (found.second)
+      {
+         _keys.push_back(key);
+      }
+
+      _ids.push_back(found.first->second);
+      append_arguments(std::index_sequence_for<args_t...>{}, args...);
+      _live.push_back(true);
+      ++_live_count;
+
+      return _ids.size() - 1;
+   }
+
+   ///
+   /// <summary>
+   ///   Constructs a product with the factory, and records the construction when it succeeds.
+   /// </summary>
+   ///
+   /// <returns>The product, which is nullptr_t when it cannot be constructed.</returns>
+   ///
+   /// <remarks>The row of the construction is size() - 1 once it is recorded, as long as nothing was forgotten.</remarks>
+   ///
+   template<class factory_t, class... args_t>
+   result_type construct(const factory_t& factory,
+                         const key_type& key,
+                         const args_t&... args)
+   {
+      auto product = factory.template construct<function_type>(key, args...);
+
+      if (product != nullptr)
+      {
+         record(key, args...);
+      }
+
+      return product;
+   }
+
+   ///
+   /// <summary>
+   ///   Forgets the construction of a row, e.g. once its product is destroyed.
+   /// </summary>
+   ///
+   void forget(std::size_t row) noexcept
+   {
+      if (row < _live.size() && _live[row])
+      {
+         _live[row] = false;
+         --_live_count;
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of constructions that are recorded, and not forgotten.
+   /// </summary>
+   ///
+   std::size_t size() const noexcept
+   {
+      return _live_count;
+   }
+
+   ///
+   /// <summary>
+   ///   Forgets all the constructions.
+   /// </summary>
+   ///
+   void clear() noexcept
+   {
+      _keys.clear();
+      _ids_by_key.clear();
+      _ids.clear();
+      std::apply([](auto&... columns) { (columns.clear(), ...); }, _columns);
+      _live.clear();
+      _live_count = 0;
+   }
+
+   ///
+   /// <summary>
+   ///   Writes the constructions that aren't forgotten into a snapshot file, replacing it.
+   /// </summary>
+   ///
+   /// <returns>false when the file cannot be written.</returns>
+   ///
+   bool write(const std::string& path) const
+   {
+      // The keys are renumbered, hence the keys of the forgotten rows alone aren't written.
+      constexpr auto unused = std::numeric_limits<std::uint32_t>::max();
+
+      std::vector<std::uint32_t> renumbered(_keys.size(), unused);
+      std::vector<const key_type*> keys;
+      std::vector<std::uint32_t> ids;
+
+      ids.reserve(_live_count);
+
+      for (std::size_t row = 0; row < _ids.size(); ++row)
+      {
+         if (!_live[row])
+         {
+            continue;
+         }
+
+         auto& id = renumbered[_ids[row]];
+
+         if (id == unused)
+         {
+            id = static_cast<std::uint32_t>(keys.size());
+            keys.push_back(&_keys[_ids[row]]);
+         }
+
+         ids.push_back(id);
+      }
+
+      detail::snapshot_header header{};
+
+      std::memcpy(header.magic, detail::snapshot_magic, sizeof(header.magic));
+      header.version      = snapshot_version;
+      header.byte_order   = detail::snapshot_byte_order;
+      header.column_count = static_cast<std::uint32_t>(column_count);
+      header.key_size     = std::is_same_v<key_type, std::string> ? 0 : static_cast<std::uint32_t>(sizeof(key_type));
+      header.row_count    = ids.size();
+      header.key_count    = keys.size();
+      header.keys_offset  = detail::align_snapshot(sizeof(header) + column_count * sizeof(detail::snapshot_column));
+      header.keys_size    = keys_size(keys);
+      header.ids_offset   = detail::align_snapshot(header.keys_offset + header.keys_size);
+
+      const auto columns = column_table(detail::align_snapshot(header.ids_offset + ids.size() * sizeof(std::uint32_t)),
+                                        header.row_count,
+                                        std::make_index_sequence<column_count>{});
+
+      std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+
+      write_bytes(stream, &header, sizeof(header));
+      write_bytes(stream, columns.data(), columns.size() * sizeof(detail::snapshot_column));
+      pad(stream, header.keys_offset);
+      write_keys(stream, keys);
+      pad(stream, header.ids_offset);
+      write_bytes(stream, ids.data(), ids.size() * sizeof(std::uint32_t));
+      write_columns(stream, columns, std::make_index_sequence<column_count>{});
+
+      return static_cast<bool>(stream.flush());
+   }
+
+private:
+   static constexpr std::size_t column_count = std::tuple_size_v<argument_types>;
+
+   template<class... args_t, std::size_t... index_t>
+   void append_arguments(std::index_sequence<index_t...>,
+                         const args_t&... args)
+   {
+      (std::get<index_t>(_columns).push_back(static_cast<std::tuple_element_t<index_t, argument_types>>(args)), ...);
+   }
+
+   template<std::size_t... index_t>
+   static std::array<detail::snapshot_column, column_count> column_table(std::uint64_t offset,
+                                                                          std::uint64_t row_count,
+                                                                          std::index_sequence<index_t...>)
+   {
+      std::array<detail::snapshot_column, column_count> columns{};
+
+      ((columns[index_t] = detail::snapshot_column_of<std::tuple_element_t<index_t, argument_types>>(offset),
+        offset = detail::align_snapshot(offset + row_count * sizeof(std::tuple_element_t<index_t, argument_types>))), ...);
+
+      return columns;
+   }
+
+   static std::uint64_t keys_size(const std::vector<const key_type*>& keys)
+   {
+      if constexpr (std::is_same_v<key_type, std::string>)
+      {
+         // The offsets of the characters of each key, and of their end, then the characters.
+         std::uint64_t size = (keys.size() + 1) * sizeof(std::uint64_t);
+
+         for (const auto* key : keys)
+         {
+            size += key->size();
+         }
+
+         return size;
+      }
+      else
+      {
+         return keys.size() * sizeof(key_type);
+      }
+   }
+
+   static void write_bytes(std::ofstream& stream,
+                           const void* data,
+                           std::size_t size)
+   {
+      if (size > 0)
+      {
+         stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+      }
+   }
+
+   static void pad(std::ofstream& stream,
+                   std::uint64_t offset)
+   {
+      static constexpr char zeros[8] = {};
+
+      const auto position = static_cast<std::uint64_t>(stream.tellp());
+
+      if (stream && position < offset)
+      {
+         write_bytes(stream, zeros, static_cast<std::size_t>(offset - position));
+      }
+   }
+
+   static void write_keys(std::ofstream& stream,
+                          const std::vector<const key_type*>& keys)
+   {
+      if constexpr (std::is_same_v<key_type, std::string>)
+      {
+         std::uint64_t offset = 0;
+
+         for (const auto* key : keys)
+         {
+            write_bytes(stream, &offset, sizeof(offset));
+            offset += key->size();
+         }
+
+         write_bytes(stream, &offset, sizeof(offset));
+
+         for (const auto* key : keys)
+         {
+            write_bytes(stream, key->data(), key->size());
+         }
+      }
+      else
+      {
+         for (const auto* key : keys)
+         {
+            write_bytes(stream, key, sizeof(key_type));
+         }
+      }
+   }
+
+   template<std::size_t... index_t>
+   void write_columns(std::ofstream& stream,
+                      const std::array<detail::snapshot_column, column_count>& columns,
+                      std::index_sequence<index_t...>) const
+   {
+      (write_column(stream, columns[index_t].offset, std::get<index_t>(_columns)), ...);
+   }
+
+   template<class value_t>
+   void write_column(std::ofstream& stream,
+                     std::uint64_t offset,
+                     const std::vector<value_t>& column) const
+   {
+      pad(stream, offset);
+
+      if (_live_count == column.size())
+      {
+         write_bytes(stream, column.data(), column.size() * sizeof(value_t));
+         return;
+      }
+
+      std::vector<value_t> live;
+
+      live.reserve(_live_count);
+
+      for (std::size_t row = 0; row < column.size(); ++row)
+      {
+         if (_live[row])
+         {
+            live.push_back(column[row]);
+         }
+      }
+
+      write_bytes(stream, live.data(), live.size() * sizeof(value_t));
+   }
+
+   std::vector<key_type>                          _keys;
+   std::unordered_map<key_type, std::uint32_t>    _ids_by_key;
+   std::vector<std::uint32_t>                     _ids;
+   typename detail::snapshot_arguments<argument_types>::columns_type _columns;
+   std::vector<bool>                              _live;
+   std::size_t                                    _live_count = 0;
+};
+
+///
+/// <summary>
+///   The snapshot_view class maps a snapshot file written by snapshot_writer, and reconstructs its products in bulk.
+///   <para>The file is memory-mapped and validated once, then its columns are read in place, without being copied.</para>
+///   <para>The constructor of each distinct key is looked up once, rather than once per product, then the products are
+///   constructed in the order of the rows, either on the calling thread or in parallel on a thread pool.</para>
+/// </summary>
+///
+/// <remarks>
+///   A file of another version, byte order, key type or signature is rejected by open. The product of a row whose key
+///   isn't registered any more is nullptr, as for a construction.
+/// </remarks>
+///
+/// <seealso cref="snapshot_writer"/>
+///
+template<class key_t, class function_t>
+class snapshot_view final
+{
+public:
+   typedef key_t key_type;
+   typedef function_t function_type;
+   typedef function_result_t<function_type> result_type;
+   typedef typename function_traits<function_type>::decayed_argument_types argument_types;
+
+   static_assert(is_snapshot_key<key_type>, "The keys of a snapshot must be strings, or trivially copyable.");
+   static_assert(detail::snapshot_arguments<argument_types>::is_packable,
+                 "The arguments of the signature of a snapshot must be trivially copyable.");
+
+   static constexpr std::size_t default_rows_per_task = 4096;
+
+   snapshot_view() = default;
+   snapshot_view(const snapshot_view&) = delete;
+   snapshot_view(snapshot_view&&) = default;
+
+   ~snapshot_view() = default;
+
+   snapshot_view& operator=(const snapshot_view&) = delete;
+   snapshot_view& operator=(snapshot_view&&) = default;
+
+   ///
+   /// <summary>
+   ///   Maps and validates the snapshot file at the given path.
+   /// </summary>
+   ///
+   /// <returns>false when it cannot be mapped or isn't a valid snapshot of this type, in which case error() describes why.</returns>
+   ///
+   bool open(const std::string& path)
+   {
+      _rows = 0;
+      _keys = 0;
+
+      if (!_file.open(path))
+      {
+         _error = _file.error();
+         return false;
+      }
+
+      if (!validate())
+      {
+         _file.close();
+         _rows = 0;
+         _keys = 0;
+         return false;
+      }
+
+      _error.clear();
+      return true;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the description of the last failure.
+   /// </summary>
+   ///
+   const std::string& error() const noexcept
+   {
+      return _error;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of rows, i.e. of products.
+   /// </summary>
+   ///
+   std::size_t size() const noexcept
+   {
+      return _rows;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of distinct keys.
+   /// </summary>
+   ///
+   std::size_t key_count() const noexcept
+   {
+      return _keys;
+   }
+
+   ///
+   /// <summary>
+   ///   Get a distinct key by its index.
+   /// </summary>
+   ///
+   key_type key(std::size_t index) const
+   {
+      if constexpr (std::is_same_v<key_type, std::string>)
+      {
+         const auto begin = detail::read_packed<std::uint64_t>(_key_data + index * sizeof(std::uint64_t));
+         const auto end   = detail::read_packed<std::uint64_t>(_key_data + (index + 1) * sizeof(std::uint64_t));
+
+         return key_type(reinterpret_cast<const char*>(_key_chars + begin), static_cast<std::size_t>(end - begin));
+      }
+      else
+      {
+         return detail::read_packed<key_type>(_key_data + index * sizeof(key_type));
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Get the key of a row.
+   /// </summary>
+   ///
+   key_type key_of(std::size_t row) const
+   {
+      return key(id_of(row));
+   }
+
+   ///
+   /// <summary>
+   ///   Get the arguments of a row.
+   /// </summary>
+   ///
+   argument_types arguments(std::size_t row) const noexcept
+   {
+      return arguments(row, std::make_index_sequence<column_count>{});
+   }
+
+   ///
+   /// <summary>
+   ///   Reconstructs the products of all the rows with the given factory, on the calling thread.
+   /// </summary>
+   ///
+   /// <param name="factory">A factory whose get_function finds the function of a key, e.g. a key_class_factory.</param>
+   ///
+   /// <returns>The products, in the order of the rows.</returns>
+   ///
+   template<class factory_t>
+   std::vector<result_type> restore(const factory_t& factory) const
+   {
+      const auto functions = resolve(factory);
+
+      std::vector<result_type> products(_rows);
+
+      restore_rows(functions, products, 0, _rows);
+
+      return products;
+   }
+
+   ///
+   /// <summary>
+   ///   Reconstructs the products of all the rows with the given factory, in parallel on the given thread pool.
+   /// </summary>
+   ///
+   /// <param name="factory">A factory whose get_function finds the function of a key, e.g. a key_class_factory.</param>
+   /// <param name="pool">The threads that construct the products, which don't include the calling thread.</param>
+   /// <param name="rows_per_task">The number of rows that each task reconstructs.</param>
+   ///
+   /// <returns>The products, in the order of the rows.</returns>
+   ///
+   /// <remarks>
+   ///   The functions must be safe to invoke from many threads at once. The first exception thrown by a function is
+   ///   rethrown once all the tasks have completed.
+   /// </remarks>
+   ///
+   template<class factory_t>
+   std::vector<result_type> restore(const factory_t& factory,
+                                    thread_pool& pool,
+                                    std::size_t rows_per_task = default_rows_per_task) const
+   {
+      const auto functions = resolve(factory);
+
+      std::vector<result_type> products(_rows);
+      std::vector<std::future<void>> pending;
+
+      rows_per_task = (std::max)(rows_per_task, std::size_t(1));
+
+      for (std::size_t begin = 0; begin < _rows; begin += rows_per_task)
+      {
+         const auto end = (std::min)(begin + rows_per_task, _rows);
+
+         pending.push_back(pool.submit([this, &functions, &products, begin, end] { restore_rows(functions, products, begin, end); }));
+      }
+
+      std::exception_ptr failure;
+
+      for (auto& future : pending)
+      {
+         try
+         {
+            future.get();
+         }
+         catch (...)
+         {
+            if (!failure)
+            {
+               failure = std::current_exception();
+            }
+         }
+      }
+
+      if (failure)
+      {
+         std::rethrow_exception(failure);
+      }
+
+      return products;
+   }
+
+private:
+   static constexpr std::size_t column_count = std::tuple_size_v<argument_types>;
+
+   std::uint32_t id_of(std::size_t row) const noexcept
+   {
+      return detail::read_packed<std::uint32_t>(_ids + row * sizeof(std::uint32_t));
+   }
+
+   template<std::size_t... index_t>
+   argument_types arguments(std::size_t row,
+                            std::index_sequence<index_t...>) const noexcept
+   {
+      return argument_types{ detail::read_packed<std::tuple_element_t<index_t, argument_types>>(
+                                _columns[index_t] + row * sizeof(std::tuple_element_t<index_t, argument_types>))... };
+   }
+
+   template<class factory_t>
+   std::vector<function_type> resolve(const factory_t& factory) const
+   {
+      std::vector<function_type> functions;
+
+      functions.reserve(_keys);
+
+      for (std::size_t i = 0; i < _keys; ++i)
+      {
+         functions.push_back(factory.template get_function<function_type>(key(i)));
+      }
+
+      return functions;
+   }
+
+   void restore_rows(const std::vector<function_type>& functions,
+                     std::vector<result_type>& products,
+                     std::size_t begin,
+                     std::size_t end) const
+   {
+      for (auto row = begin; row < end; ++row)
+      {
+         const auto& function = functions[id_of(row)];
+
+         if (function)
+         {
+            products[row] = std::apply(function, arguments(row));
+         }
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Checks that the header matches this type, and that every section lies within the file.
+   /// </summary>
+   ///
+   bool validate()
+   {
+      const auto bytes = _file.bytes();
+      const auto size  = static_cast<std::uint64_t>(bytes.size());
+
+      // Indicates if count items of the given size fit in the file from the given offset.
+      const auto fits = [size](std::uint64_t offset, std::uint64_t count, std::uint64_t item_size)
+      {
+         return offset <= size && (item_size == 0 || count <= (size - offset) / item_size);
+      };
+
+      detail::snapshot_header header{};
+
+      if (!fits(0, 1, sizeof(header)))
+      {
+         return fail("The file is too small to be a snapshot.");
+      }
+
+      std::memcpy(&header, bytes.data(), sizeof(header));
+
+      if (std::memcmp(header.magic, detail::snapshot_magic, sizeof(header.magic)) != 0)
+      {
+         return fail("The file isn't a snapshot.");
+      }
+
+      if (header.version != snapshot_version)
+      {
+         return fail("The snapshot version " + std::to_string(header.version) + " isn't supported.");
+      }
+
+      if (header.byte_order != detail::snapshot_byte_order)
+      {
+         return fail("The snapshot was written by a host of another byte order.");
+      }
+
+      const std::uint32_t key_size = std::is_same_v<key_type, std::string> ? 0 : static_cast<std::uint32_t>(sizeof(key_type));
+
+      if (header.column_count != column_count || header.key_size != key_size)
+      {
+         return fail("The snapshot was written for another key type or signature.");
+      }
+
+      if (!fits(sizeof(header), column_count, sizeof(detail::snapshot_column))
+       || !fits(header.ids_offset, header.row_count, sizeof(std::uint32_t))
+       || !fits(header.keys_offset, header.keys_size, 1))
+      {
+         return fail("The snapshot is truncated.");
+      }
+
+      std::array<detail::snapshot_column, column_count> columns{};
+
+      std::memcpy(columns.data(), bytes.data() + sizeof(header), column_count * sizeof(detail::snapshot_column));
+
+      const auto expected = expected_columns(std::make_index_sequence<column_count>{});
+
+      for (std::size_t i = 0; i < column_count; ++i)
+      {
+         if (columns[i].size != expected[i].size || columns[i].kind != expected[i].kind)
+         {
+            return fail("The snapshot was written for another key type or signature.");
+         }
+
+         if (!fits(columns[i].offset, header.row_count, columns[i].size))
+         {
+            return fail("The snapshot is truncated.");
+         }
+
+         _columns[i] = bytes.data() + columns[i].offset;
+      }
+
+      _key_data = bytes.data() + header.keys_offset;
+
+      if constexpr (std::is_same_v<key_type, std::string>)
+      {
+         const auto table_size = (header.key_count + 1) * sizeof(std::uint64_t);
+
+         if (header.key_count >= header.keys_size / sizeof(std::uint64_t))
+         {
+            return fail("The snapshot is truncated.");
+         }
+
+         _key_chars = _key_data + table_size;
+
+         std::uint64_t previous = 0;
+
+         for (std::uint64_t i = 0; i <= header.key_count; ++i)
+         {
+            const auto offset = detail::read_packed<std::uint64_t>(_key_data + i * sizeof(std::uint64_t));
+
+            if (offset < previous || offset > header.keys_size - table_size)
+            {
+               return fail("The keys of the snapshot are corrupt.");
+            }
+
+            previous = offset;
+         }
+      }
+      else
+      {
+         if (header.key_count > header.keys_size / sizeof(key_type))
+         {
+            return fail("The snapshot is truncated.");
+         }
+      }
+
+      _ids  = bytes.data() + header.ids_offset;
+      _rows = static_cast<std::size_t>(header.row_count);
+      _keys = static_cast<std::size_t>(header.key_count);
+
+      for (std::size_t row = 0; row < _rows; ++row)
+      {
+         if (id_of(row) >= _keys)
+         {
+            return fail("The key of a row of the snapshot is corrupt.");
+         }
+      }
+
+      return true;
+   }
+
+   template<std::size_t... index_t>
+   static std::array<detail::snapshot_column, column_count> expected_columns(std::index_sequence<index_t...>) noexcept
+   {
+      return { detail::snapshot_column_of<std::tuple_element_t<index_t, argument_types>>(0)... };
+   }
+
+   bool fail(std::string error)
+   {
+      _error = std::move(error);
+      return false;
+   }
+
+   mapped_file                                _file;
+   std::string                                _error;
+   std::size_t                                _rows      = 0;
+   std::size_t                                _keys      = 0;
+   const std::byte*                           _ids       = nullptr;
+   const std::byte*                           _key_data  = nullptr;
+   const std::byte*                           _key_chars = nullptr;
+   std::array<const std::byte*, column_count> _columns{};
+};
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "function_traits.h"
+#include <cstddef>
+#include <span>
+#include <tuple>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   A record that the linker collects, with all the other records of the program, into a single section.
+/// </summary>
+///
+/// <remarks>The table tells which factory the entry registers into, since the records of all the factories share the section.</remarks>
+///
+struct static_record
+{
+   const void* table;
+   const void* entry;
+};
+
+///
+/// <summary>
+///   The static_table class identifies the static registrations of a factory type, by the address of its tag.
+/// </summary>
+///
+template<class factory_t>
+struct static_table
+{
+   static constexpr char tag = 0;
+};
+
+///
+/// <summary>
+///   The static_entry class is a key and its constructors, as plain function pointers, which is constant initialized.
+/// </summary>
+///
+/// <remarks>A null function pointer stands for a signature that isn't registered.</remarks>
+///
+template<class factory_t, class function_types = typename factory_t::function_types>
+struct static_entry;
+
+template<class factory_t, class... functions_t>
+struct static_entry<factory_t, std::tuple<functions_t...>>
+{
+   const char* key;
+   std::tuple<typename function_traits<functions_t>::pointer_type...> constructors;
+};
+}
+
+///
+/// The records are placed in a section of their own, which the linker concatenates across all the translation units:
+///  - ELF linkers define the __start_ and __stop_ symbols that bound a section whose name is a C identifier.
+///  - The MSVC linker sorts the sections of a same name by the suffix that follows the $ sign, hence the records of
+///    ".prgrmr$m" lie between the markers of ".prgrmr$a" and ".prgrmr$z".
+///  - The Mach-O linker defines the section$start$ and section$end$ symbols.
+///
+#if defined(_MSC_VER)
+
+#pragma section(".prgrmr$a", read)
+#pragma section(".prgrmr$m", read)
+#pragma section(".prgrmr$z", read)
+
+#define PRGRMR_STATIC_RECORD __declspec(allocate(".prgrmr$m"))
+
+namespace prgrmr::generic::detail
+{
+__declspec(allocate(".prgrmr$a")) __declspec(selectany) extern const static_record static_records_begin{};
+__declspec(allocate(".prgrmr$z")) __declspec(selectany) extern const static_record static_records_end{};
+}
+
+#elif defined(__APPLE__)
+
+#define PRGRMR_STATIC_RECORD __attribute__((used, section("__DATA,prgrmr_records")))
+
+namespace prgrmr::generic::detail
+{
+extern const static_record static_records_begin __asm("section$start$__DATA$prgrmr_records");
+extern const static_record static_records_end __asm("section$end$__DATA$prgrmr_records");
+}
+
+#else
+
+#define PRGRMR_STATIC_RECORD __attribute__((used, section("prgrmr_records")))
+
+// Weak, hence null when the program doesn't have any record.
+extern "C" const prgrmr::generic::static_record __start_prgrmr_records[] __attribute__((weak, visibility("hidden")));
+extern "C" const prgrmr::generic::static_record __stop_prgrmr_records[] __attribute__((weak, visibility("hidden")));
+
+#endif
+
+///
+/// Registers a key and its constructors into the factory type, when the program starts using load_static_registrations.
+/// The entry is constant initialized, hence it doesn't depend on the order of the static initialization, nor allocate.
+///
+/// Use it at namespace scope in a single translation unit per key, with a name that is unique within the program:
+///
+///    PRGRMR_STATIC_REGISTRATION(nike::shoe_factory, bird_registration, "bird", &make_bird, &make_bird_with_numerics);
+///
+#define PRGRMR_STATIC_REGISTRATION(factory_t, name, key, ...)                                                \
+   constinit const ::prgrmr::generic::static_entry<factory_t> name{ key, { __VA_ARGS__ } };                  \
+   PRGRMR_STATIC_RECORD extern constinit const ::prgrmr::generic::static_record name##_record{                \
+      &::prgrmr::generic::static_table<factory_t>::tag, &name }
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   Get all the records of the program, of all the factory types.
+/// </summary>
+///
+inline std::span<const static_record> static_records() noexcept
+{
+#if defined(_MSC_VER)
+   return { &detail::static_records_begin + 1, &detail::static_records_end };
+#elif defined(__APPLE__)
+   return { &detail::static_records_begin, &detail::static_records_end };
+#else
+   return (__start_prgrmr_records != nullptr)
+          ? std::span<const static_record>(__start_prgrmr_records, __stop_prgrmr_records)
+          : std::span<const static_record>();
+#endif
+}
+
+///
+/// <summary>
+///   Registers all the static registrations of the factory type into a factory, in a single pass.
+/// </summary>
+///
+/// <param name="factory">The factory to register into. Its keys must be constructible from a const char*.</param>
+///
+/// <returns>The number of keys that were registered.</returns>
+///
+/// <remarks>The factory reserves room for all the keys at once, hence registering them doesn't rehash.</remarks>
+///
+template<class factory_t>
+std::size_t load_static_registrations(factory_t& factory)
+{
+   typedef typename factory_t::key_type key_type;
+   typedef typename factory_t::function_types function_types;
+
+   const void* table = &static_table<factory_t>::tag;
+
+   std::size_t count = 0;
+
+   for (const auto& record : static_records())
+   {
+      count += (record.table == table) ? 1 : 0;
+   }
+
+   factory.reserve(factory.size() + count);
+
+   for (const auto& record : static_records())
+   {
+      // The MSVC linker may pad the section with nulls, which don't match any table.
+      if (record.table != table)
+      {
+         continue;
+      }
+
+      const auto& entry = *static_cast<const static_entry<factory_t>*>(record.entry);
+
+      std::apply([&factory, &entry](auto... constructors)
+                 {
+                    factory.register_functions(key_type(entry.key), function_types(constructors...));
+                 },
+                 entry.constructors);
+   }
+
+   return count;
+}
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The thread_counters class is a set of counters that each thread increments in its own cache line.
+///   <para>Counting is a relaxed load and store on memory that no other thread writes, hence threads counting at once
+///   don't bounce a cache line between their cores. Reading the counters sums those of all the threads.</para>
+/// </summary>
+///
+/// <remarks>
+///   The counters are unsigned and wrap around, hence a thread may subtract what another one added, and the sum is
+///   still exact. The counts of a thread are kept when it exits, and its cache line is released.
+///   Reading while other threads count gives a sum that each counter reached at some point, not a consistent snapshot
+///   of all the counters.
+/// </remarks>
+///
+template<std::size_t count_t>
+class thread_counters final
+{
+public:
+   typedef std::array<std::uint64_t, count_t> values_type;
+
+   thread_counters() = default;
+   thread_counters(const thread_counters&) = delete;
+   thread_counters(thread_counters&&) = delete;
+
+   ~thread_counters() = default;
+
+   thread_counters& operator=(const thread_counters&) = delete;
+   thread_counters& operator=(thread_counters&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Adds an amount to a counter of the calling thread.
+   /// </summary>
+   ///
+   /// <param name="index">The index of the counter.</param>
+   /// <param name="amount">The amount to add, which wraps around when it is the negation of an unsigned value.</param>
+   ///
+   void add(std::size_t index,
+            std::uint64_t amount = 1)
+   {
+      auto& counter = local_slot().values[index];
+
+      // Only the calling thread writes to its slot, hence a plain store, without a locked instruction.
+      counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+   }
+
+   ///
+   /// <summary>
+   ///   Subtracts an amount from a counter of the calling thread.
+   /// </summary>
+   ///
+   void subtract(std::size_t index,
+                 std::uint64_t amount = 1)
+   {
+      add(index, std::uint64_t(0) - amount);
+   }
+
+   ///
+   /// <summary>
+   ///   Get the value of a counter, summed over all the threads.
+   /// </summary>
+   ///
+   std::uint64_t value(std::size_t index) const
+   {
+      return values()[index];
+   }
+
+   ///
+   /// <summary>
+   ///   Get the values of all the counters, summed over all the threads.
+   /// </summary>
+   ///
+   values_type values() const
+   {
+      std::lock_guard<std::mutex> lock(_state->mutex);
+
+      auto values = _state->retired;
+
+      for (const auto& slot : _state->slots)
+      {
+         for (std::size_t i = 0; i < count_t; ++i)
+         {
+            values[i] += slot->values[i].load(std::memory_order_relaxed);
+         }
+      }
+
+      return values;
+   }
+
+private:
+   struct alignas(64) counter_slot
+   {
+      std::array<std::atomic<std::uint64_t>, count_t> values{};
+   };
+
+   ///
+   /// <summary>
+   ///   The slots of the running threads, and the counts of the threads that exited, which a thread that exits may
+   ///   still reach after the counters are destroyed.
+   /// </summary>
+   ///
+   struct shared_state
+   {
+      std::mutex                                 mutex;
+      std::vector<std::shared_ptr<counter_slot>> slots;
+      values_type                                retired{};
+   };
+
+   struct cached_slot
+   {
+      std::uint64_t                 counters_id;
+      std::weak_ptr<shared_state>   counters;
+      std::shared_ptr<counter_slot> slot;
+   };
+
+   ///
+   /// <summary>
+   ///   The slots of a thread, one per set of counters it counted with, which are retired when the thread exits.
+   /// </summary>
+   ///
+   struct thread_slots
+   {
+      thread_slots() = default;
+      thread_slots(const thread_slots&) = delete;
+
+      ~thread_slots()
+      {
+         for (auto& entry : entries)
+         {
+            retire(entry);
+         }
+      }
+
+      thread_slots& operator=(const thread_slots&) = delete;
+
+      std::vector<cached_slot> entries;
+   };
+
+   static std::uint64_t next_id()
+   {
+      static std::atomic<std::uint64_t> id{0};
+
+      return ++id;
+   }
+
+   counter_slot& local_slot()
+   {
+      // Identifiers are never reused, thus entries of destroyed counters are never matched.
+      thread_local thread_slots cache;
+
+      for (const auto& entry : cache.entries)
+      {
+         if (entry.counters_id == _id)
+         {
+            return *entry.slot;
+         }
+      }
+
+      std::erase_if(cache.entries, [](const cached_slot& entry) { return entry.counters.expired(); });
+
+      auto local = std::make_shared<counter_slot>();
+
+      {
+         std::lock_guard<std::mutex> lock(_state->mutex);
+
+         _state->slots.push_back(local);
+      }
+
+      cache.entries.push_back({_id, _state, local});
+
+      return *local;
+   }
+
+   ///
+   /// <summary>
+   ///   Folds the counts of an exiting thread into the retired counts, and releases its slot.
+   /// </summary>
+   ///
+   static void retire(cached_slot& entry)
+   {
+      const auto state = entry.counters.lock();
+
+      if (state == nullptr)
+      {
+         return;
+      }
+
+      std::lock_guard<std::mutex> lock(state->mutex);
+
+      for (std::size_t i = 0; i < count_t; ++i)
+      {
+         state->retired[i] += entry.slot->values[i].load(std::memory_order_relaxed);
+      }
+
+      std::erase(state->slots, entry.slot);
+   }
+
+   const std::uint64_t           _id    = next_id();
+   std::shared_ptr<shared_state> _state = std::make_shared<shared_state>();
+};
+}
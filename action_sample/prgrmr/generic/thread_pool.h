@@ -0,0 +1,139 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The thread_pool class runs the submitted tasks on a fixed number of threads, in their order of submission.
+/// </summary>
+///
+/// <remarks>The tasks still waiting to run when the instance is destroyed are run before the threads are joined.</remarks>
+///
+class thread_pool final
+{
+public:
+   ///
+   /// <summary>
+   ///   Constructs an instance and starts its threads.
+   /// </summary>
+   ///
+   /// <param name="thread_count">The number of threads, one per hardware thread by default.</param>
+   ///
+   explicit thread_pool(std::size_t thread_count = std::thread::hardware_concurrency())
+   {
+      if (thread_count == 0)
+      {
+         thread_count = 1;
+      }
+
+      _threads.reserve(thread_count);
+
+      for (std::size_t i = 0; i < thread_count; ++i)
+      {
+         _threads.emplace_back([this] { run(); });
+      }
+   }
+
+   thread_pool(const thread_pool&) = delete;
+   thread_pool(thread_pool&&) = delete;
+
+   ~thread_pool()
+   {
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         _stopping = true;
+      }
+
+      _condition.notify_all();
+
+      for (auto& thread : _threads)
+      {
+         thread.join();
+      }
+   }
+
+   thread_pool& operator=(const thread_pool&) = delete;
+   thread_pool& operator=(thread_pool&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Get the number of threads.
+   /// </summary>
+   ///
+   std::size_t size() const noexcept
+   {
+      return _threads.size();
+   }
+
+   ///
+   /// <summary>
+   ///   Submits a task to run on one of the threads.
+   /// </summary>
+   ///
+   /// <param name="task">The task to run, without any arguments.</param>
+   ///
+   /// <returns>The future result of the task, which also holds any exception it throws.</returns>
+   ///
+   template<class task_t>
+   auto submit(task_t&& task) -> std::future<std::invoke_result_t<std::decay_t<task_t>>>
+   {
+      using result_type = std::invoke_result_t<std::decay_t<task_t>>;
+
+      // std::function requires a copyable target, hence the packaged task is shared.
+      auto packaged = std::make_shared<std::packaged_task<result_type ()>>(std::forward<task_t>(task));
+      auto future   = packaged->get_future();
+
+      {
+         std::lock_guard<std::mutex> lock(_mutex);
+         _tasks.emplace_back([packaged] { (*packaged)(); });
+      }
+
+      _condition.notify_one();
+
+      return future;
+   }
+
+private:
+   void run()
+   {
+      for (;;)
+      {
+         std::function<void ()> task;
+
+         {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _condition.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+
+            if (_tasks.empty())
+            {
+               return;
+            }
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+         }
+
+         task();
+      }
+   }
+
+   std::mutex                          _mutex;
+   std::condition_variable             _condition;
+   std::deque<std::function<void ()>>  _tasks;
+   bool                                _stopping = false;
+   std::vector<std::thread>            _threads;
+};
+}
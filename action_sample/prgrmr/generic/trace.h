@@ -0,0 +1,675 @@
+#pragma once
+
+#include "hashing.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <iomanip>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PRGRMR_TRACE_TSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PRGRMR_TRACE_TSC 1
+#else
+#define PRGRMR_TRACE_TSC 0
+#endif
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   The operations of a factory that are traced.
+/// </summary>
+///
+enum class trace_operation : std::uint16_t
+{
+   register_delegate,
+   register_functions,
+   register_function,
+   unregister_delegate,
+   unregister_function,
+   construct,
+   construct_dynamic,
+   try_construct,
+   extract,
+   insert
+};
+
+///
+/// <summary>
+///   Get the name of an operation.
+/// </summary>
+///
+constexpr const char* to_string(trace_operation operation) noexcept
+{
+   switch (operation)
+   {
+   case trace_operation::register_delegate:   return "register_delegate";
+   case trace_operation::register_functions:  return "register_functions";
+   case trace_operation::register_function:   return "register_function";
+   case trace_operation::unregister_delegate: return "unregister_delegate";
+   case trace_operation::unregister_function: return "unregister_function";
+   case trace_operation::construct:           return "construct";
+   case trace_operation::construct_dynamic:   return "construct_dynamic";
+   case trace_operation::try_construct:       return "try_construct";
+   case trace_operation::extract:             return "extract";
+   case trace_operation::insert:              return "insert";
+   }
+
+   return "unknown";
+}
+
+///
+/// <summary>
+///   The signature index of an operation that doesn't name a signature.
+/// </summary>
+///
+inline constexpr std::int16_t no_signature = -1;
+
+///
+/// <summary>
+///   Get the index of a signature in a list of signatures, or no_signature when it isn't in the list.
+/// </summary>
+///
+template<class function_t, class... functions_t>
+constexpr std::int16_t signature_index_of() noexcept
+{
+   std::int16_t index = 0;
+
+   return ((std::is_same_v<function_t, functions_t> ? true : (++index, false)) || ...)
+          ? index
+          : no_signature;
+}
+
+///
+/// <summary>
+///   A traced operation, in 32 bytes.
+/// </summary>
+///
+struct trace_event
+{
+   std::uint64_t   start;       // In ticks of the trace_clock.
+   std::uint64_t   duration;    // In ticks of the trace_clock.
+   std::uint64_t   key;         // The hash value of the key, see hash_key.
+   trace_operation operation;
+   std::int16_t    signature;   // The tuple index of the signature, or no_signature.
+   std::uint32_t   thread;      // The sequence number of the thread, in order of its first traced operation.
+};
+
+static_assert(std::is_trivially_copyable_v<trace_event> && sizeof(trace_event) == 32);
+
+///
+/// <summary>
+///   The clock of the traces: the time stamp counter where there is one, the steady clock otherwise.
+/// </summary>
+///
+/// <remarks>Reading the time stamp counter takes a few nanoseconds. The ticks are converted to nanoseconds once, when dumped.</remarks>
+///
+struct trace_clock
+{
+   static std::uint64_t now() noexcept
+   {
+#if PRGRMR_TRACE_TSC
+      return __rdtsc();
+#else
+      return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+   }
+
+   ///
+   /// <summary>
+   ///   A tick count read along with the steady clock, to convert the ticks between two of them into nanoseconds.
+   /// </summary>
+   ///
+   struct reference
+   {
+      std::uint64_t ticks;
+      std::int64_t  nanoseconds;
+
+      static reference take() noexcept
+      {
+         const auto time = std::chrono::steady_clock::now().time_since_epoch();
+
+         return reference{ now(), std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() };
+      }
+   };
+};
+
+///
+/// <summary>
+///   The trace_ring class holds the events of a single thread, which appends them without any lock while another
+///   thread drains them.
+/// </summary>
+///
+/// <remarks>
+///   The events that don't fit are dropped and counted, rather than waiting for room.
+///   Once its thread exits, a ring is handed over to the next thread that traces, which appends after the events that
+///   are still to be drained.
+/// </remarks>
+///
+class trace_ring final
+{
+public:
+   static constexpr std::size_t capacity = 16 * 1024;
+
+   trace_ring() = default;
+
+   trace_ring(const trace_ring&) = delete;
+   trace_ring(trace_ring&&) = delete;
+
+   ~trace_ring() = default;
+
+   trace_ring& operator=(const trace_ring&) = delete;
+   trace_ring& operator=(trace_ring&&) = delete;
+
+   std::uint32_t thread() const noexcept
+   {
+      return _thread;
+   }
+
+   ///
+   /// <summary>
+   ///   Hands the ring over to the calling thread, whose events then carry the given sequence number.
+   /// </summary>
+   ///
+   void assign(std::uint32_t thread) noexcept
+   {
+      _thread = thread;
+   }
+
+   ///
+   /// <summary>
+   ///   Appends an event. Only the thread of the ring may append.
+   /// </summary>
+   ///
+   void push(const trace_event& event) noexcept
+   {
+      const auto head = _head.load(std::memory_order_relaxed);
+
+      // The tail is only read again when the ring looks full, to keep off the cache line of the draining thread.
+      if (head - _cached_tail >= capacity)
+      {
+         _cached_tail = _tail.load(std::memory_order_acquire);
+
+         if (head - _cached_tail >= capacity)
+         {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+         }
+      }
+
+      _events[head % capacity] = event;
+      _head.store(head + 1, std::memory_order_release);
+   }
+
+   ///
+   /// <summary>
+   ///   Moves the events appended so far into the given vector. Only one thread at a time may drain.
+   /// </summary>
+   ///
+   void drain(std::vector<trace_event>& events)
+   {
+      const auto tail = _tail.load(std::memory_order_relaxed);
+      const auto head = _head.load(std::memory_order_acquire);
+
+      for (auto i = tail; i < head; ++i)
+      {
+         events.push_back(_events[i % capacity]);
+      }
+
+      _tail.store(head, std::memory_order_release);
+   }
+
+   std::uint64_t dropped() const noexcept
+   {
+      return _dropped.load(std::memory_order_relaxed);
+   }
+
+private:
+   std::uint32_t _thread = 0;   // Only used by the thread of the ring.
+
+   alignas(64) std::atomic<std::uint64_t> _head{0};
+   std::uint64_t                          _cached_tail = 0;   // Only used by the thread of the ring.
+   alignas(64) std::atomic<std::uint64_t> _tail{0};
+   alignas(64) std::atomic<std::uint64_t> _dropped{0};
+
+   std::array<trace_event, capacity> _events;
+};
+
+///
+/// <summary>
+///   The trace_log class owns the rings of all the threads that traced an operation.
+/// </summary>
+///
+/// <remarks>
+///   The ring of a thread outlives the thread, hence its last events can still be dumped. It is then recycled for the
+///   next thread that traces, thus there are only as many rings as threads ever traced at once.
+/// </remarks>
+///
+class trace_log final
+{
+public:
+   ///
+   /// <summary>
+   ///   Get the single log of the process.
+   /// </summary>
+   ///
+   static trace_log& instance()
+   {
+      static trace_log log;
+
+      return log;
+   }
+
+   trace_log(const trace_log&) = delete;
+   trace_log(trace_log&&) = delete;
+
+   trace_log& operator=(const trace_log&) = delete;
+   trace_log& operator=(trace_log&&) = delete;
+
+   ///
+   /// <summary>
+   ///   Appends an event to the ring of the calling thread.
+   /// </summary>
+   ///
+   void record(trace_operation operation,
+               std::uint64_t key,
+               std::int16_t signature,
+               std::uint64_t start,
+               std::uint64_t end) noexcept
+   {
+      auto& ring = local_ring();
+
+      ring.push(trace_event{ start, end - start, key, operation, signature, ring.thread() });
+   }
+
+   ///
+   /// <summary>
+   ///   Moves the events of all the threads, recorded so far, into the given vector.
+   /// </summary>
+   ///
+   void drain(std::vector<trace_event>& events)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      for (const auto& ring : _rings)
+      {
+         ring->drain(events);
+      }
+   }
+
+   ///
+   /// <summary>
+   ///   Get the number of events that were dropped because the ring of their thread was full.
+   /// </summary>
+   ///
+   std::uint64_t dropped() const
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      std::uint64_t count = 0;
+
+      for (const auto& ring : _rings)
+      {
+         count += ring->dropped();
+      }
+
+      return count;
+   }
+
+   ///
+   /// <summary>
+   ///   Get the reference taken when the log was first used, from which the time stamps of the events are measured.
+   /// </summary>
+   ///
+   const trace_clock::reference& origin() const noexcept
+   {
+      return _origin;
+   }
+
+private:
+   trace_log()
+   : _origin(trace_clock::reference::take())
+   {
+   }
+
+   ///
+   /// <summary>
+   ///   The ring that a thread traces into, which is released when the thread exits.
+   /// </summary>
+   ///
+   struct ring_lease
+   {
+      ring_lease() = default;
+      ring_lease(const ring_lease&) = delete;
+
+      ~ring_lease()
+      {
+         if (ring != nullptr)
+         {
+            instance().release(*ring);
+         }
+      }
+
+      ring_lease& operator=(const ring_lease&) = delete;
+
+      trace_ring* ring = nullptr;
+   };
+
+   trace_ring& local_ring()
+   {
+      thread_local ring_lease lease;
+
+      if (lease.ring == nullptr)
+      {
+         lease.ring = &acquire();
+      }
+
+      return *lease.ring;
+   }
+
+   trace_ring& acquire()
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      if (_released.empty())
+      {
+         _rings.push_back(std::make_unique<trace_ring>());
+         _released.push_back(_rings.back().get());
+      }
+
+      auto& ring = *_released.back();
+
+      _released.pop_back();
+      ring.assign(++_threads);
+
+      return ring;
+   }
+
+   void release(trace_ring& ring)
+   {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      _released.push_back(&ring);
+   }
+
+   const trace_clock::reference               _origin;
+   mutable std::mutex                         _mutex;
+   std::vector<std::unique_ptr<trace_ring>>   _rings;
+   std::vector<trace_ring*>                   _released;      // The rings whose thread exited.
+   std::uint32_t                              _threads = 0;   // The number of threads that traced so far.
+};
+
+///
+/// <summary>
+///   The trace_scope class records the operation that runs during its lifetime.
+/// </summary>
+///
+class trace_scope final
+{
+public:
+   trace_scope(trace_operation operation,
+               std::uint64_t key,
+               std::int16_t signature = no_signature) noexcept
+   : _log(trace_log::instance()),   // Before the clock is read, since the log takes the origin of the time stamps.
+     _key(key),
+     _operation(operation),
+     _signature(signature),
+     _start(trace_clock::now())
+   {
+   }
+
+   trace_scope(const trace_scope&) = delete;
+   trace_scope(trace_scope&&) = delete;
+
+   ~trace_scope()
+   {
+      _log.record(_operation, _key, _signature, _start, trace_clock::now());
+   }
+
+   trace_scope& operator=(const trace_scope&) = delete;
+   trace_scope& operator=(trace_scope&&) = delete;
+
+private:
+   trace_log&      _log;
+   std::uint64_t   _key;
+   trace_operation _operation;
+   std::int16_t    _signature;
+   std::uint64_t   _start;
+};
+
+///
+/// <summary>
+///   Writes events in the compact binary format: the count of events, the clock references, the events as is, then
+///   the names of the keys, each as its hash value, its length and its characters.
+/// </summary>
+///
+/// <remarks>
+///   The format is meant to be read back on the same machine, by read_binary_trace. Writing it costs little more than
+///   copying the events, hence a program writes it and factory_trace_dump converts it into a Chrome trace later on.
+/// </remarks>
+///
+inline void write_binary_trace(std::ostream& stream,
+                               const std::vector<trace_event>& events,
+                               const trace_clock::reference& origin,
+                               const trace_clock::reference& end,
+                               const std::unordered_map<std::uint64_t, std::string>& names = {})
+{
+   const std::uint64_t count = events.size();
+
+   stream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+   stream.write(reinterpret_cast<const char*>(&origin), sizeof(origin));
+   stream.write(reinterpret_cast<const char*>(&end), sizeof(end));
+   stream.write(reinterpret_cast<const char*>(events.data()), static_cast<std::streamsize>(count * sizeof(trace_event)));
+
+   const std::uint64_t name_count = names.size();
+
+   stream.write(reinterpret_cast<const char*>(&name_count), sizeof(name_count));
+
+   for (const auto& [key, name] : names)
+   {
+      const std::uint64_t length = name.size();
+
+      stream.write(reinterpret_cast<const char*>(&key), sizeof(key));
+      stream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+      stream.write(name.data(), static_cast<std::streamsize>(length));
+   }
+}
+
+///
+/// <summary>
+///   Reads events, and the names of their keys, written by write_binary_trace.
+/// </summary>
+///
+/// <returns>false when the stream is truncated.</returns>
+///
+inline bool read_binary_trace(std::istream& stream,
+                              std::vector<trace_event>& events,
+                              trace_clock::reference& origin,
+                              trace_clock::reference& end,
+                              std::unordered_map<std::uint64_t, std::string>& names)
+{
+   std::uint64_t count = 0;
+
+   stream.read(reinterpret_cast<char*>(&count), sizeof(count));
+   stream.read(reinterpret_cast<char*>(&origin), sizeof(origin));
+   stream.read(reinterpret_cast<char*>(&end), sizeof(end));
+
+   if (!stream)
+   {
+      return false;
+   }
+
+   events.resize(static_cast<std::size_t>(count));
+   stream.read(reinterpret_cast<char*>(events.data()), static_cast<std::streamsize>(count * sizeof(trace_event)));
+
+   std::uint64_t name_count = 0;
+
+   stream.read(reinterpret_cast<char*>(&name_count), sizeof(name_count));
+
+   for (std::uint64_t i = 0; stream && i < name_count; ++i)
+   {
+      std::uint64_t key    = 0;
+      std::uint64_t length = 0;
+
+      stream.read(reinterpret_cast<char*>(&key), sizeof(key));
+      stream.read(reinterpret_cast<char*>(&length), sizeof(length));
+
+      std::string name(static_cast<std::size_t>(length), '\0');
+
+      stream.read(name.data(), static_cast<std::streamsize>(length));
+      names.emplace(key, std::move(name));
+   }
+
+   return static_cast<bool>(stream);
+}
+
+///
+/// <summary>
+///   Reads events written by write_binary_trace, without the names of their keys.
+/// </summary>
+///
+/// <returns>false when the stream is truncated.</returns>
+///
+inline bool read_binary_trace(std::istream& stream,
+                              std::vector<trace_event>& events,
+                              trace_clock::reference& origin,
+                              trace_clock::reference& end)
+{
+   std::unordered_map<std::uint64_t, std::string> names;
+
+   return read_binary_trace(stream, events, origin, end, names);
+}
+
+///
+/// <summary>
+///   Get the names of the keys of a factory, by their hash value, to name the keys of the events.
+/// </summary>
+///
+template<class factory_t>
+std::unordered_map<std::uint64_t, std::string> trace_key_names(const factory_t& factory)
+{
+   std::unordered_map<std::uint64_t, std::string> names;
+
+   factory.for_each_key([&names](const auto& key)
+   {
+      if constexpr (std::is_constructible_v<std::string, decltype(key)>)
+      {
+         names.emplace(hash_key(key), std::string(key));
+      }
+      else
+      {
+         names.emplace(hash_key(key), std::to_string(key));
+      }
+   });
+
+   return names;
+}
+
+///
+/// <summary>
+///   Writes events as a Chrome trace, in JSON, which chrome://tracing and Perfetto open.
+/// </summary>
+///
+/// <param name="stream">The stream to write to.</param>
+/// <param name="events">The events, as drained from the trace_log or read by read_binary_trace.</param>
+/// <param name="origin">The clock reference from which the time stamps are measured.</param>
+/// <param name="end">A clock reference taken after the events, to convert the ticks into nanoseconds.</param>
+/// <param name="names">The names of the keys, see trace_key_names. The keys without a name are written as their hash value.</param>
+///
+inline void write_chrome_trace(std::ostream& stream,
+                               const std::vector<trace_event>& events,
+                               const trace_clock::reference& origin,
+                               const trace_clock::reference& end,
+                               const std::unordered_map<std::uint64_t, std::string>& names = {})
+{
+   const auto elapsed_ticks = static_cast<double>(end.ticks - origin.ticks);
+   const auto ns_per_tick   = (elapsed_ticks > 0)
+                              ? static_cast<double>(end.nanoseconds - origin.nanoseconds) / elapsed_ticks
+                              : 1.0;
+
+   const auto to_microseconds = [ns_per_tick](double ticks) { return ticks * ns_per_tick / 1000.0; };
+
+   // The time stamps are written to the nanosecond, rather than to the 6 significant digits of the default format.
+   const auto flags     = stream.flags();
+   const auto precision = stream.precision();
+
+   stream << std::fixed << std::setprecision(3);
+
+   const auto write_escaped = [&stream](const std::string& text)
+   {
+      for (const auto c : text)
+      {
+         if (c == '"' || c == '\\')
+         {
+            stream << '\\' << c;
+         }
+         else if (static_cast<unsigned char>(c) >= 0x20)
+         {
+            stream << c;
+         }
+      }
+   };
+
+   stream << "{\"traceEvents\":[";
+
+   const char* separator = "\n";
+
+   for (const auto& event : events)
+   {
+      stream << separator
+             << "{\"name\":\"" << to_string(event.operation) << "\",\"cat\":\"factory\",\"ph\":\"X\""
+             << ",\"ts\":" << to_microseconds(static_cast<double>(static_cast<std::int64_t>(event.start - origin.ticks)))
+             << ",\"dur\":" << to_microseconds(static_cast<double>(event.duration))
+             << ",\"pid\":1,\"tid\":" << event.thread
+             << ",\"args\":{\"key\":\"";
+
+      const auto name = names.find(event.key);
+
+      if (name != std::end(names))
+      {
+         write_escaped(name->second);
+      }
+      else
+      {
+         stream << event.key;
+      }
+
+      stream << "\",\"signature\":" << event.signature << "}}";
+
+      separator = ",\n";
+   }
+
+   stream << "\n]}\n";
+
+   stream.flags(flags);
+   stream.precision(precision);
+}
+}
+
+///
+/// Traces the enclosing scope as an operation of a factory, when PRGRMR_FACTORY_TRACING is defined.
+///
+#if defined(PRGRMR_FACTORY_TRACING)
+#define PRGRMR_TRACE_FACTORY(operation, key, signature) \
+   const prgrmr::generic::trace_scope prgrmr_trace_scope(prgrmr::generic::trace_operation::operation, \
+                                                         prgrmr::generic::hash_key(key), \
+                                                         static_cast<std::int16_t>(signature))
+#else
+#define PRGRMR_TRACE_FACTORY(operation, key, signature) static_cast<void>(0)
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace prgrmr::generic
+{
+///
+/// <summary>
+///   A small integer identifying a type at runtime, which is cheaper to store and to compare than std::type_info.
+/// </summary>
+///
+/// <remarks>Tags are dense, starting at 1, in the order in which the types are first tagged. They differ from one run to another.</remarks>
+///
+using type_tag = std::uint32_t;
+
+///
+/// <summary>
+///   The tag of the objects whose type was never recorded.
+/// </summary>
+///
+inline constexpr type_tag untagged = 0;
+
+namespace detail
+{
+inline std::atomic<type_tag> last_type_tag{untagged};
+}
+
+///
+/// <summary>
+///   Get the tag of the given type.
+/// </summary>
+///
+template<class T>
+type_tag type_tag_of()
+{
+   static const type_tag tag = detail::last_type_tag.fetch_add(1, std::memory_order_relaxed) + 1;
+
+   return tag;
+}
+}
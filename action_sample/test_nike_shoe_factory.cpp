@@ -1,113 +1,42 @@
+#include "nike/arena_shoe_factory.h"
 #include "nike/bird.h"
+#include "nike/coded_shoe_factory.h"
 #include "nike/jordan.h"
 #include "nike/lebron.h"
 #include "nike/madison.h"
+#include "nike/plugin_shoe_factory.h"
 #include "nike/runner.h"
 #include "nike/shoe.h"
+#include "nike/shoe_collection.h"
 #include "nike/shoe_factory.h"
+#include "nike/shoe_output.h"
+#include "nike/shoe_pipeline.h"
+#include "nike/shoe_registration.h"
+#include "nike/shoe_snapshot.h"
+#include <prgrmr/generic/compact_factory.h>
+#include <prgrmr/generic/multi_product_factory.h>
+#include <prgrmr/generic/object_graph_factory.h>
+#include <prgrmr/generic/replicated_factory.h>
+#include <prgrmr/generic/thread_pool.h>
 #include <concepts>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <span>
+#include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
-template<class T>
-void register_constructors(nike::shoe_factory& factory,
-                           const nike::shoe_factory::key_type& key)
-{
-    using base     = nike::base_constructor;
-    using numerics = nike::numerics_constructor;
-
-    if constexpr (std::default_initializable<T>)
-    {
-       factory.register_function<base>(key, std::make_unique<T>);
-    }
-
-    if constexpr (std::constructible_from<T, int, double>)
-    {
-       factory.register_function<numerics>(key, std::make_unique<T, int, float>);
-    }
-
-    if constexpr (std::default_initializable<T> &&
-                  std::constructible_from<T, int, float>)
-    {
-       ;
-    }
-    else if constexpr (std::default_initializable<T>)
-    {
-       factory.register_function<numerics>
-       (
-        key,
-        [&factory, key]([[maybe_unused]] int a, [[maybe_unused]] float b)
-           { return factory.construct<base>(key); }
-       );
-    }
-    else if constexpr (std::constructible_from<T, int, float>)
-    {
-       factory.register_function<base>
-       (
-        key,
-        [&factory, key]()
-           { return factory.construct<numerics>(key, 0, 0.0f); }
-       );
-    }
-}
-
-/****
-/// <summary>
-///  The nike::runner class doesn't provide a constructor with numerics signature.
-/// 
-///  Thus, it's possible to register a function that accepts the above signature and will
-///  forward to the factory's registered base constructor instead.
-/// </summary>
-/// 
-/// <remarks>
-///  This example demonstrates the capability of being able to instantiate an object of
-///  a given class without having to altering that class in order that it complies
-///  with the application's factory.
-/// 
-///  This case is trivial, but there are situations in which application developers need
-///  to deserialize the contents from a JSON object or a database record(s) which is 
-///  typically more complex than in the underlying class constructor.
-/// 
-///  Sometimes developers don't want to incur more dependencies with JSON libraries or
-///  database functions within a class, or cannot change the class since it may introduce
-///  unwanted dependencies, or the class is from another library or group.
-/// 
-///  This factory approach is ideal then, since application developers whom simply need
-///  a specific instance invoke the appropriate function from the given factory. While,
-///  allowing developers to provide a shim for the application that instantiates an
-///  instance of the object.
-///
-///  For instance the nike runner only provides a constructor that doesn't accept any
-///  parameters. However, some shoes from the application's factory do take two
-///  floating point parameters.
-///
-///  Show below is that the application is configured at runtime so that second
-///  signatures, which takes two parameters, is wired as to invoke the factory's
-///  function without any parameters. This is called forwarding/chaining the
-///  functions. This is akin to how in C++ a class constructor is allow to invoke
-///  another of that class' constructors member.
-/// </remarks>
-template<>
-void register_constructors<nike::runner>(nike::shoe_factory& factory,
-                                         const nike::shoe_factory::key_type& key)
-{
-   factory.register_function(key, nike::base_constructor(
-                                  []()
-                                  {
-                                     return new nike::runner();
-                                  }));
-
-   factory.register_function(key, nike::numerics_constructor(
-                                  [&factory, key](int a, float b)
-                                  {
-                                     return factory.construct<nike::base_constructor>(key);
-                                  }));
-}
-*******/
-
 void run_shoe_tests(std::unique_ptr<nike::shoe> shoe_ptr)
 {
     if (shoe_ptr == nullptr)
@@ -117,7 +46,11 @@ void run_shoe_tests(std::unique_ptr<nike::shoe> shoe_ptr)
     }
 
     std::cout << "----------  Construction succeeded & now running the 'do_it' method.  -------------\n";
+    std::cout.flush();
+
+    // The shoes write into their own buffered sink, flush it to keep it in step with std::cout.
     shoe_ptr->do_it();
+    nike::output().flush();
 }
 
 void test_constructors(const nike::shoe_factory& factory,
@@ -138,6 +71,34 @@ void test_constructors(const nike::shoe_factory& factory,
 
    std::cout << "\nTuple<1>\n";
    run_shoe_tests(factory.construct<1>(key, 5, 5.0f));
+
+   std::cout << "\n----------  Constructing using deduced signatures.  --------------\n";
+
+   std::cout << "No arguments.\n";
+   run_shoe_tests(factory.construct(key));
+
+   std::cout << "\nArguments (5, 5.0f).\n";
+   run_shoe_tests(factory.construct(key, 5, 5.0f));
+
+   std::cout << "\n----------  Constructing using runtime signature ids.  --------------\n";
+
+   const auto packed_args = prgrmr::generic::pack_arguments<int, float>(5, 5.0f);
+
+   std::cout << "Signature id 1, packed arguments.\n";
+   run_shoe_tests(factory.construct_dynamic(key, 1, packed_args));
+
+   std::cout << "\n----------  Constructing without exceptions.  --------------\n";
+
+   auto result = factory.try_construct<nike::numerics_constructor>(key, 5, 5.0f);
+
+   if (result)
+   {
+      run_shoe_tests(std::move(*result));
+   }
+   else
+   {
+      std::cout << "Construction failed: " << prgrmr::generic::to_string(result.error()) << ".\n";
+   }
 }
 
 void test_factory(nike::shoe_factory& factory,
@@ -156,13 +117,555 @@ void test_factory(nike::shoe_factory& factory,
    std::cout << "\n============================================================================================\n\n";
 }
 
+template<class T>
+void register_arena_constructors(nike::arena_shoe_factory& factory,
+                                 const nike::arena_shoe_factory::key_type& key)
+{
+    using base     = nike::arena_base_constructor;
+    using numerics = nike::arena_numerics_constructor;
+
+    if constexpr (std::default_initializable<T>)
+    {
+       factory.register_function<base>(key, prgrmr::generic::make_arena<T>);
+    }
+
+    if constexpr (std::constructible_from<T, int, float>)
+    {
+       factory.register_function<numerics>(key, prgrmr::generic::make_arena<T, int, float>);
+    }
+    else
+    {
+       factory.register_function<numerics>
+       (
+        key,
+        [&factory, key](std::pmr::memory_resource* arena, [[maybe_unused]] int a, [[maybe_unused]] float b)
+           { return factory.construct<base>(key, arena); }
+       );
+    }
+}
+
+///
+/// <summary>
+///  Constructs all the shoes of a request within a single arena, then releases them all at once.
+/// </summary>
+///
+void run_arena_request(const nike::arena_shoe_factory& factory)
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Constructing all the shoes of a request in an arena.\n";
+    std::cout << "============================================================================================\n";
+
+    std::pmr::monotonic_buffer_resource arena(4096);
+    std::vector<nike::arena_shoe> shoes;
+
+    for (const auto& key : { "bird", "jordan", "lebron", "madison", "runner" })
+    {
+        if (auto shoe = factory.construct<nike::arena_numerics_constructor>(key, &arena, 1, 1.0f))
+        {
+           shoes.push_back(std::move(shoe));
+        }
+    }
+
+    std::cout.flush();
+
+    for (const auto& shoe : shoes)
+    {
+        shoe->do_it();
+    }
+
+    nike::output().flush();
+
+    // The shoes are destroyed, then their memory is freed at once with the arena.
+    shoes.clear();
+    arena.release();
+
+    std::cout << "\n";
+}
+
+///
+/// <summary>
+///  Registers the plain functions that construct a shoe with either signature, into any of the factories of shoes.
+/// </summary>
+///
+template<class T, class factory_t>
+void register_shoe_functions(factory_t& factory,
+                             const typename factory_t::key_type& key)
+{
+    using nike::make_shoe;
+
+    factory.register_functions(key,
+                               { static_cast<std::unique_ptr<nike::shoe> (*)()>(&make_shoe<T>),
+                                 static_cast<std::unique_ptr<nike::shoe> (*)(int, float)>(&make_shoe<T>) });
+}
+
+///
+/// <summary>
+///  Constructs the shoes by their product code, whose delegates the factory indexes by the code instead of hashing it.
+/// </summary>
+///
+void run_coded_request()
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Constructing shoes by their product code.\n";
+    std::cout << "============================================================================================\n";
+
+    nike::coded_shoe_factory factory;
+
+    register_shoe_functions<nike::bird>   ( factory, nike::shoe_code::bird    );
+    register_shoe_functions<nike::jordan> ( factory, nike::shoe_code::jordan  );
+    register_shoe_functions<nike::lebron> ( factory, nike::shoe_code::lebron  );
+    register_shoe_functions<nike::madison>( factory, nike::shoe_code::madison );
+    register_shoe_functions<nike::runner> ( factory, nike::shoe_code::runner  );
+
+    for (const auto code : { nike::shoe_code::bird, nike::shoe_code::lebron, nike::shoe_code::runner })
+    {
+        run_shoe_tests(factory.construct<nike::numerics_constructor>(code, 4, 4.0f));
+    }
+
+    std::cout << "\nUnregistered the lebron code.\n";
+    factory.unregister_delegate(nike::shoe_code::lebron);
+
+    run_shoe_tests(factory.construct<nike::numerics_constructor>(nike::shoe_code::lebron, 4, 4.0f));
+
+    std::cout << "\n";
+}
+
+///
+/// <summary>
+///  Registers every shoe under a few catalog keys, whose identical constructors the compact factory stores only once.
+/// </summary>
+///
+void run_compact_request()
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Constructing shoes that share their constructors.\n";
+    std::cout << "============================================================================================\n";
+
+    using compact_shoe_factory =
+          prgrmr::generic::compact_key_class_factory<std::string, nike::base_constructor, nike::numerics_constructor>;
+
+    compact_shoe_factory factory;
+
+    for (const auto& key : { "runner", "runner/road", "runner/trail" })
+    {
+        register_shoe_functions<nike::runner>(factory, key);
+    }
+
+    for (const auto& key : { "bird", "bird/classic" })
+    {
+        register_shoe_functions<nike::bird>(factory, key);
+    }
+
+    std::cout << factory.size() << " keys share " << factory.set_count() << " sets of constructors.\n";
+
+    run_shoe_tests(factory.construct<nike::base_constructor>("runner/trail"));
+    run_shoe_tests(factory.construct<nike::numerics_constructor>("bird/classic", 4, 4.0f));
+
+    std::cout << "\n";
+}
+
+using shoe_family  = prgrmr::generic::product_family<nike::base_constructor, nike::numerics_constructor>;
+using label_family = prgrmr::generic::product_family<std::function<std::unique_ptr<std::string> (int, float)>>;
+
+using labeled_shoe_factory = prgrmr::generic::multi_product_factory<std::string, shoe_family, label_family>;
+
+template<class T>
+void register_labeled_shoe(labeled_shoe_factory& factory,
+                           const std::string& key)
+{
+    using nike::make_shoe;
+
+    factory.register_function<shoe_family>(key, nike::base_constructor(static_cast<std::unique_ptr<nike::shoe> (*)()>(&make_shoe<T>)));
+    factory.register_function<shoe_family>(key, nike::numerics_constructor(static_cast<std::unique_ptr<nike::shoe> (*)(int, float)>(&make_shoe<T>)));
+
+    factory.register_function<label_family>(key, std::function<std::unique_ptr<std::string> (int, float)>(
+                                                 [key](int a, float)
+                                                 {
+                                                     return std::make_unique<std::string>("Label of the " + key + ", size " + std::to_string(a) + ".");
+                                                 }));
+}
+
+///
+/// <summary>
+///  Constructs each shoe along with its label, whose constructors are both found by a single lookup of the key.
+/// </summary>
+///
+void run_labeled_request()
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Constructing shoes along with their labels.\n";
+    std::cout << "============================================================================================\n";
+
+    labeled_shoe_factory factory;
+
+    register_labeled_shoe<nike::jordan>( factory, "jordan"  );
+    register_labeled_shoe<nike::madison>(factory, "madison" );
+
+    for (const auto& key : { "jordan", "madison" })
+    {
+        auto [shoe, label] = factory.construct_each(key, 9, 9.0f);
+
+        std::cout << *label << "\n";
+        run_shoe_tests(std::move(shoe));
+    }
+
+    const auto row = factory.find("madison");
+
+    run_shoe_tests(row.construct<shoe_family, nike::base_constructor>());
+
+    std::cout << "\n";
+}
+
+///
+/// <summary>
+///  Constructs shoes on a worker thread, from its own replica of the registry, which picks up a later registration.
+/// </summary>
+///
+void run_replicated_request()
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Constructing shoes from a replicated registry.\n";
+    std::cout << "============================================================================================\n";
+    std::cout.flush();
+
+    using replicated_shoe_factory =
+          prgrmr::generic::replicated_key_class_factory<std::string, nike::base_constructor, nike::numerics_constructor>;
+
+    replicated_shoe_factory factory;
+
+    register_shoe_functions<nike::runner>(factory, "runner");
+
+    std::cout << "Registrations at version " << factory.version() << ".\n";
+
+    // The worker copies the registry once it starts, rather than on its first construction.
+    std::thread([&factory]()
+                {
+                    factory.refresh();
+
+                    run_shoe_tests(factory.construct<nike::base_constructor>("runner"));
+                    run_shoe_tests(factory.construct<nike::base_constructor>("lebron"));
+                }).join();
+
+    register_shoe_functions<nike::lebron>(factory, "lebron");
+
+    std::cout << "Registrations at version " << factory.version() << ".\n";
+
+    std::thread([&factory]()
+                {
+                    run_shoe_tests(factory.construct<nike::numerics_constructor>("lebron", 6, 6.0f));
+                }).join();
+
+    std::cout << "\n";
+}
+
+///
+/// <summary>
+///  Takes the shoes of a module into the factory of the application, whose registrations are relinked rather than
+///  copied, and hands a single shoe over to another factory.
+/// </summary>
+///
+void run_merged_request()
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Constructing shoes that a module registered.\n";
+    std::cout << "============================================================================================\n";
+
+    using nike::make_shoe;
+
+    nike::shoe_factory application;
+    nike::shoe_factory module;
+
+    application.register_function("runner", nike::base_constructor(static_cast<std::unique_ptr<nike::shoe> (*)()>(&make_shoe<nike::runner>)));
+
+    register_shoe_functions<nike::bird>  (module, "bird"  );
+    register_shoe_functions<nike::runner>(module, "runner");
+
+    try
+    {
+        application.merge(module, prgrmr::generic::conflict_policy::reject);
+    }
+    catch (const std::invalid_argument& e)
+    {
+        std::cout << "Rejected the module: " << e.what() << "\n";
+    }
+
+    // The runner of the application takes the numerics constructor, which only the module registers.
+    application.merge(module, prgrmr::generic::conflict_policy::combine);
+
+    std::cout << "The application registers " << application.size() << " keys, the module " << module.size() << ".\n";
+
+    run_shoe_tests(application.construct<nike::numerics_constructor>("runner", 2, 2.0f));
+
+    nike::shoe_factory outlet;
+
+    outlet.insert(application.extract("bird"));
+
+    std::cout << "The application registers " << application.size() << " keys, the outlet " << outlet.size() << ".\n";
+
+    run_shoe_tests(application.construct<nike::base_constructor>("bird"));
+    run_shoe_tests(outlet.construct<nike::numerics_constructor>("bird", 2, 2.0f));
+
+    std::cout << "\n";
+}
+
+using shoe_graph_factory = prgrmr::generic::object_graph_factory<std::string, nike::shoe>;
+
+///
+/// <summary>
+///  Constructs a window display, whose constructor receives the shoes it depends on, each constructed once.
+/// </summary>
+///
+void run_graph_request()
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Constructing a graph of shoes.\n";
+    std::cout << "============================================================================================\n";
+
+    using dependencies = std::span<const std::shared_ptr<nike::shoe>>;
+
+    shoe_graph_factory factory;
+
+    factory.register_constructor("jordan", [](dependencies) { return std::make_shared<nike::jordan>(3, 3.0f); });
+    factory.register_constructor("lebron", [](dependencies) { return std::make_shared<nike::lebron>(3, 3.0f); });
+    factory.register_constructor("pair",   [](dependencies shoes) { return shoes[0]; }, { "jordan" });
+
+    // The display runs the shoes it received, and is itself the madison whose size is their number.
+    factory.register_constructor("display",
+                                 [](dependencies shoes)
+                                 {
+                                     for (const auto& shoe : shoes)
+                                     {
+                                         shoe->do_it();
+                                     }
+
+                                     return std::make_shared<nike::madison>(static_cast<int>(shoes.size()), 1.0f);
+                                 },
+                                 { "jordan", "lebron", "pair" });
+
+    const auto layers = factory.construction_layers("display");
+
+    for (std::size_t i = 0; i < layers.size(); ++i)
+    {
+        std::cout << "Layer " << i << ":";
+
+        for (const auto& key : layers[i])
+        {
+            std::cout << " " << key;
+        }
+
+        std::cout << "\n";
+    }
+
+    std::cout << "----------  Constructing the display.  -------------\n";
+    std::cout.flush();
+
+    factory.construct("display")->do_it();
+    nike::output().flush();
+
+    prgrmr::generic::thread_pool pool(2);
+
+    std::cout << "----------  Constructing the display on a thread pool.  -------------\n";
+    std::cout.flush();
+
+    factory.construct("display", pool)->do_it();
+    nike::output().flush();
+
+    std::cout << "\n";
+}
+
+///
+/// <summary>
+///  Constructs the shoes of the sample plugin, which is only loaded by the first construction of one of them.
+/// </summary>
+///
+void run_plugin_request()
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Constructing the shoes of a plugin loaded on demand.\n";
+    std::cout << "============================================================================================\n";
+
+    nike::plugin_shoe_factory factory;
+
+    for (const auto& key : { "plugin/lebron", "plugin/madison" })
+    {
+        factory.register_plugin(key, nike::sample_plugin_path, nike::sample_plugin_entry);
+    }
+
+    for (const auto& key : { "plugin/lebron", "plugin/madison" })
+    {
+        auto shoe = factory.construct<nike::numerics_constructor>(key, 2, 2.0f);
+
+        if (shoe == nullptr)
+        {
+            std::cout << "Cannot construct " << key << ". " << factory.plugin_error(key) << "\n";
+            continue;
+        }
+
+        run_shoe_tests(std::move(shoe));
+    }
+
+    std::cout << "\n";
+}
+
+///
+/// <summary>
+///  Writes the shoes constructed with the numerics signature into a snapshot, then constructs them again from it, as on
+///  a warm restart.
+/// </summary>
+///
+void run_snapshot_request(const nike::shoe_factory& factory)
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Constructing shoes again from a snapshot.\n";
+    std::cout << "============================================================================================\n";
+
+    nike::shoe_snapshot_writer writer;
+
+    for (const auto& key : { "bird", "jordan", "lebron" })
+    {
+        writer.construct(factory, key, 3, 3.0f);
+    }
+
+    // The snapshot lives in the temporary directory, and only as long as this request.
+    const auto path = std::filesystem::temp_directory_path() / "shoe_snapshot.bin";
+
+    if (!writer.write(path.string()))
+    {
+        std::cout << "Cannot write shoe_snapshot.bin.\n\n";
+        return;
+    }
+
+    std::vector<std::unique_ptr<nike::shoe>> shoes;
+    bool                                     opened;
+
+    {
+        nike::shoe_snapshot snapshot;
+
+        opened = snapshot.open(path.string());
+
+        if (opened)
+        {
+            shoes = snapshot.restore(factory);
+        }
+        else
+        {
+            std::cout << "Cannot open shoe_snapshot.bin. " << snapshot.error() << "\n\n";
+        }
+    }
+
+    std::error_code error;
+
+    std::filesystem::remove(path, error);
+
+    if (!opened)
+    {
+        return;
+    }
+
+    std::cout << "Constructed " << shoes.size() << " shoes from shoe_snapshot.bin.\n";
+
+    for (auto& shoe : shoes)
+    {
+        run_shoe_tests(std::move(shoe));
+    }
+
+    std::cout << "\n";
+}
+
+///
+/// <summary>
+///  Runs the shoes in a pipeline: one thread constructs them, while another runs them.
+/// </summary>
+///
+void run_pipelined_application(const nike::shoe_factory& factory)
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Constructing & running shoes in a pipeline.\n";
+    std::cout << "============================================================================================\n";
+    std::cout.flush();
+
+    nike::shoe_pipeline pipeline(factory);
+
+    for (const auto& key : { "bird", "jordan", "lebron", "madison", "runner" })
+    {
+        pipeline.push(key, 2, 2.0f);
+    }
+
+    pipeline.wait();
+    nike::output().flush();
+
+    const auto statistics = pipeline.statistics();
+
+    std::cout << "Constructed " << statistics.construct.items - statistics.failed << " shoes, and ran "
+              << statistics.execute.items << " of them.\n\n";
+}
+
+///
+/// <summary>
+///  Runs many shoes stored by columns, whose keys are associated with their shoe types from the factory.
+/// </summary>
+///
+void run_columnar_application(const nike::shoe_factory& factory)
+{
+    std::cout << "============================================================================================\n";
+    std::cout << "                         Running shoes stored by columns.\n";
+    std::cout << "============================================================================================\n";
+
+    nike::shoe_collection collection(factory);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        for (const auto& key : { "bird", "jordan", "lebron", "madison", "runner" })
+        {
+            collection.emplace(key, i, static_cast<float>(i));
+        }
+    }
+
+    collection.execute_all();
+
+    std::cout << "Ran " << collection.size() << " shoes. The last bird has a: "
+              << collection.columns<nike::bird>().a.back() << ", b: " << collection.columns<nike::bird>().b.back()
+              << ", the last lebron has a: " << collection.columns<nike::lebron>().a.back() << ", b: "
+              << collection.columns<nike::lebron>().b.back() << ".\n\n";
+}
+
+#if defined(PRGRMR_FACTORY_TRACING)
+
+///
+/// <summary>
+///  Writes the operations traced on the factories as a binary trace, which factory_trace_dump converts into a Chrome
+///  trace for chrome://tracing and Perfetto.
+/// </summary>
+///
+void write_factory_trace(const std::unordered_map<std::uint64_t, std::string>& key_names)
+{
+    auto& log = prgrmr::generic::trace_log::instance();
+
+    std::vector<prgrmr::generic::trace_event> events;
+
+    log.drain(events);
+
+    const auto path = std::filesystem::temp_directory_path() / "factory_trace.bin";
+
+    std::ofstream stream(path, std::ios::binary);
+
+    prgrmr::generic::write_binary_trace(stream, events, log.origin(), prgrmr::generic::trace_clock::reference::take(), key_names);
+
+    std::cout << "Wrote " << events.size() << " traced factory operations into " << path.string()
+              << ", which factory_trace_dump converts into a Chrome trace.\n";
+}
+
+#endif
+
+///
+/// <summary>
+///  Each shoe registers its key and constructors in its own source file, into a table that the linker collects. The
+///  table is constant initialized, hence the factory is built from it in a single pass.
+/// </summary>
+///
 void configure_application(nike::shoe_factory& factory)
 {
-    register_constructors<nike::bird>   ( factory, "bird"    );
-    register_constructors<nike::jordan> ( factory, "jordan"  );
-    register_constructors<nike::lebron> ( factory, "lebron"  );
-    register_constructors<nike::madison>( factory, "madison" );
-    register_constructors<nike::runner> ( factory, "runner"  );
+    prgrmr::generic::load_static_registrations(factory);
 }
 
 int run_application(nike::shoe_factory& factory)
@@ -226,5 +729,45 @@ int main()
 
    configure_application(factory);
 
-   return run_application(factory);
+   nike::arena_shoe_factory arena_factory;
+
+   register_arena_constructors<nike::bird>   ( arena_factory, "bird"    );
+   register_arena_constructors<nike::jordan> ( arena_factory, "jordan"  );
+   register_arena_constructors<nike::lebron> ( arena_factory, "lebron"  );
+   register_arena_constructors<nike::madison>( arena_factory, "madison" );
+   register_arena_constructors<nike::runner> ( arena_factory, "runner"  );
+
+   run_arena_request(arena_factory);
+
+   run_coded_request();
+
+   run_compact_request();
+
+   run_labeled_request();
+
+   run_replicated_request();
+
+   run_graph_request();
+
+   run_merged_request();
+
+   run_plugin_request();
+
+   run_snapshot_request(factory);
+
+   run_pipelined_application(factory);
+
+   run_columnar_application(factory);
+
+#if defined(PRGRMR_FACTORY_TRACING)
+   const auto key_names = prgrmr::generic::trace_key_names(factory);
+#endif
+
+   const auto status = run_application(factory);
+
+#if defined(PRGRMR_FACTORY_TRACING)
+   write_factory_trace(key_names);
+#endif
+
+   return status;
 }
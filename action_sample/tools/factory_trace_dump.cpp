@@ -0,0 +1,63 @@
+#include <prgrmr/generic/trace.h>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+///
+/// <summary>
+///  Converts a binary trace, as written by write_binary_trace, into a Chrome trace that chrome://tracing and Perfetto
+///  open. The Chrome trace is written to the given file, or to the console when there is none.
+/// </summary>
+///
+/// <example>factory_trace_dump factory_trace.bin factory_trace.json</example>
+///
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <binary trace> [<chrome trace>]\n";
+        return 2;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+
+    if (!input)
+    {
+        std::cerr << "Cannot open " << argv[1] << ".\n";
+        return 1;
+    }
+
+    std::vector<prgrmr::generic::trace_event>      events;
+    prgrmr::generic::trace_clock::reference        origin{};
+    prgrmr::generic::trace_clock::reference        end{};
+    std::unordered_map<std::uint64_t, std::string> names;
+
+    if (!prgrmr::generic::read_binary_trace(input, events, origin, end, names))
+    {
+        std::cerr << argv[1] << " is not a complete binary trace.\n";
+        return 1;
+    }
+
+    if (argc == 2)
+    {
+        prgrmr::generic::write_chrome_trace(std::cout, events, origin, end, names);
+        return 0;
+    }
+
+    std::ofstream output(argv[2]);
+
+    prgrmr::generic::write_chrome_trace(output, events, origin, end, names);
+
+    if (!output)
+    {
+        std::cerr << "Cannot write " << argv[2] << ".\n";
+        return 1;
+    }
+
+    std::cerr << "Converted " << events.size() << " traced factory operations into " << argv[2] << ".\n";
+
+    return 0;
+}